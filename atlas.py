@@ -0,0 +1,338 @@
+#!/usr/bin/env python
+
+##	Tool for packing Images into texture atlases
+#
+#	Each png (and each frame of each .ani) is packed into a few large atlas
+#	pages.  A manifest lists the sub-rectangle of every packed Image, so that
+#	Epiar can draw many different Images without switching textures.
+#	Images that are not in the manifest are still loaded on their own.
+#
+#	This script has no dependencies beyond the python standard library.
+
+from __future__ import print_function
+
+import os
+import sys
+import glob
+import struct
+import zlib
+from optparse import OptionParser
+from xml.sax.saxutils import quoteattr
+
+##	The version value should be changed whenever the manifest format changes
+__version__ = 1
+
+USAGE = """
+pass folders, .png files or .ani files to pack into atlas pages:
+	%prog [-o OUTPUT] [PATH ...]
+
+Run from the top of the source tree so that the Image names match the
+paths used by the game, e.g.:
+	%prog -o data/atlas data/graphics data/skin data/animations
+
+The output folder will contain:
+	atlas_NNN.png
+		The atlas pages.
+	atlas.xml
+		The manifest.  Every region is named by the path of its Image.
+		Animation frames are named 'path.ani#frame'.
+"""
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+
+## Parse command line options
+def Parse():
+	parser = OptionParser(USAGE)
+	parser.add_option("-o", "--output", default="data/atlas", help="Folder for the atlas pages and manifest.")
+	parser.add_option("-s", "--page-size", type="int", default=2048, help="Width and height of each atlas page.")
+	parser.add_option("-m", "--max-size", type="int", default=512, help="Images wider or taller than this are not packed.")
+	parser.add_option("-p", "--padding", type="int", default=1, help="Pixels of border copied around each Image.")
+	parser.add_option("-v", "--verbose", default=False, action="store_true", help="Lots of output")
+	parser.add_option("-!", "--no-output", action="store_true", help="Do not create any files.")
+	return parser.parse_args()
+
+##	A decoded RGBA picture
+class Picture:
+	def __init__(self, width, height, pixels=None):
+		self.width = width
+		self.height = height
+		# Four bytes per pixel, one row after another
+		if pixels is None:
+			pixels = bytearray(width * height * 4)
+		self.pixels = pixels
+
+	##	Copy the RGBA pixel at (x,y) of another Picture
+	def copyPixel(self, x, y, other, ox, oy):
+		d = (y * self.width + x) * 4
+		s = (oy * other.width + ox) * 4
+		self.pixels[d:d+4] = other.pixels[s:s+4]
+
+	##	Copy a whole Picture to (x,y), then extend its edges into the padding
+	def blit(self, other, x, y, padding):
+		for row in range(other.height):
+			d = ((y + row) * self.width + x) * 4
+			s = row * other.width * 4
+			self.pixels[d:d + other.width*4] = other.pixels[s:s + other.width*4]
+		# Copying the edges stops neighbours bleeding in when an Image is scaled or rotated.
+		for p in range(1, padding + 1):
+			for col in range(-p, other.width + p):
+				ox = min(max(col, 0), other.width - 1)
+				self.copyPixel(x + col, y - p, other, ox, 0)
+				self.copyPixel(x + col, y + other.height - 1 + p, other, ox, other.height - 1)
+			for row in range(-p, other.height + p):
+				oy = min(max(row, 0), other.height - 1)
+				self.copyPixel(x - p, y + row, other, 0, oy)
+				self.copyPixel(x + other.width - 1 + p, y + row, other, other.width - 1, oy)
+
+##	Read the chunks of a png
+def pngChunks(data):
+	if data[:8] != PNG_SIGNATURE:
+		raise ValueError("not a png")
+	pos = 8
+	while pos < len(data):
+		length = struct.unpack(">I", data[pos:pos+4])[0]
+		kind = data[pos+4:pos+8]
+		yield kind, data[pos+8:pos+8+length]
+		pos += 12 + length
+
+##	Undo the png row filters
+def unfilter(raw, height, stride, bpp):
+	out = bytearray(height * stride)
+	prev = bytearray(stride)
+	pos = 0
+	for y in range(height):
+		kind = raw[pos]
+		line = bytearray(raw[pos+1:pos+1+stride])
+		pos += 1 + stride
+		if kind == 1:
+			for i in range(bpp, stride):
+				line[i] = (line[i] + line[i-bpp]) & 0xFF
+		elif kind == 2:
+			for i in range(stride):
+				line[i] = (line[i] + prev[i]) & 0xFF
+		elif kind == 3:
+			for i in range(stride):
+				left = line[i-bpp] if i >= bpp else 0
+				line[i] = (line[i] + ((left + prev[i]) >> 1)) & 0xFF
+		elif kind == 4:
+			for i in range(stride):
+				a = line[i-bpp] if i >= bpp else 0
+				b = prev[i]
+				c = prev[i-bpp] if i >= bpp else 0
+				pa = abs(b - c)
+				pb = abs(a - c)
+				pc = abs(a + b - 2*c)
+				if pa <= pb and pa <= pc:
+					pred = a
+				elif pb <= pc:
+					pred = b
+				else:
+					pred = c
+				line[i] = (line[i] + pred) & 0xFF
+		out[y*stride:(y+1)*stride] = line
+		prev = line
+	return out
+
+##	Decode a non-interlaced png of any color type into RGBA
+def decodePng(data):
+	idat = []
+	palette = None
+	transparency = None
+	for kind, body in pngChunks(data):
+		if kind == b"IHDR":
+			width, height, depth, colortype, _, _, interlace = struct.unpack(">IIBBBBB", body)
+		elif kind == b"PLTE":
+			palette = bytearray(body)
+		elif kind == b"tRNS":
+			transparency = bytearray(body)
+		elif kind == b"IDAT":
+			idat.append(body)
+	if interlace:
+		raise ValueError("interlaced pngs are not supported")
+	channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[colortype]
+	bits = depth * channels
+	stride = (width * bits + 7) // 8
+	rows = unfilter(bytearray(zlib.decompress(b"".join(idat))), height, stride, max(1, bits // 8))
+
+	if depth == 16:
+		# Keep the high byte of every sample
+		rows = rows[0::2]
+		stride //= 2
+		depth = 8
+
+	picture = Picture(width, height)
+	out = picture.pixels
+	scale = 255 // ((1 << depth) - 1)
+	for y in range(height):
+		row = rows[y*stride:(y+1)*stride]
+		for x in range(width):
+			if depth < 8:
+				per = 8 // depth
+				value = (row[x // per] >> ((per - 1 - x % per) * depth)) & ((1 << depth) - 1)
+				samples = (value,)
+			else:
+				samples = row[x*channels:(x+1)*channels]
+			o = (y * width + x) * 4
+			if colortype == 3:
+				i = samples[0]
+				out[o:o+3] = palette[i*3:i*3+3]
+				out[o+3] = transparency[i] if transparency is not None and i < len(transparency) else 255
+			elif colortype in (0, 4):
+				g = samples[0] * scale
+				out[o] = out[o+1] = out[o+2] = g
+				if colortype == 4:
+					out[o+3] = samples[1]
+				elif transparency is not None and samples[0] == struct.unpack(">H", transparency[:2])[0]:
+					out[o+3] = 0
+				else:
+					out[o+3] = 255
+			else:
+				out[o:o+3] = samples[0:3]
+				if colortype == 6:
+					out[o+3] = samples[3]
+				elif transparency is not None and tuple(samples[0:3]) == struct.unpack(">HHH", transparency[:6]):
+					out[o+3] = 0
+				else:
+					out[o+3] = 255
+	return picture
+
+##	Encode an RGBA png
+def encodePng(picture):
+	def chunk(kind, body):
+		crc = zlib.crc32(kind + body) & 0xFFFFFFFF
+		return struct.pack(">I", len(body)) + kind + body + struct.pack(">I", crc)
+	raw = bytearray()
+	stride = picture.width * 4
+	for y in range(picture.height):
+		raw.append(0)
+		raw += picture.pixels[y*stride:(y+1)*stride]
+	header = struct.pack(">IIBBBBB", picture.width, picture.height, 8, 6, 0, 0, 0)
+	return PNG_SIGNATURE + chunk(b"IHDR", header) + chunk(b"IDAT", zlib.compress(bytes(raw), 9)) + chunk(b"IEND", b"")
+
+##	The pngs inside of a .ani file
+#
+#	See ani.py for the format.
+def aniFrames(filename):
+	data = open(filename, "rb").read()
+	count = bytearray(data[1:2])[0]
+	pos = 3
+	frames = []
+	for i in range(count):
+		size = struct.unpack("<I", data[pos:pos+4])[0]
+		frames.append(data[pos+4:pos+4+size])
+		pos += 4 + size
+	return frames
+
+##	Collect every Image to pack as (name, png data)
+def collect(paths):
+	found = []
+	for path in paths:
+		if os.path.isdir(path):
+			names = sorted(glob.glob(os.path.join(path, "*.png")) + glob.glob(os.path.join(path, "*.ani")))
+		else:
+			names = [path]
+		for name in names:
+			key = name.replace("\\", "/")
+			if name.lower().endswith(".ani"):
+				for i, frame in enumerate(aniFrames(name)):
+					found.append(("%s#%d" % (key, i), frame))
+			elif name.lower().endswith(".png"):
+				found.append((key, open(name, "rb").read()))
+	return found
+
+##	A page of packed Images
+#
+#	Images are placed on shelves.  Each shelf is as tall as the first (and
+#	tallest) Image placed on it, since the Images are packed tallest first.
+class Page:
+	def __init__(self, size):
+		self.size = size
+		self.shelves = [] # [y, height, next x]
+		self.regions = [] # (name, x, y, w, h)
+		self.used = 0
+
+	##	Find room for a w by h rectangle, or return None
+	def place(self, w, h):
+		for shelf in self.shelves:
+			if h <= shelf[1] and shelf[2] + w <= self.size:
+				x = shelf[2]
+				shelf[2] += w
+				return x, shelf[0]
+		y = self.used
+		if y + h > self.size or w > self.size:
+			return None
+		self.shelves.append([y, h, w])
+		self.used += h
+		return 0, y
+
+##	Pack every Image onto as few Pages as possible
+def pack(images, opts):
+	pad = opts.padding
+	pages = []
+	for name, picture in sorted(images, key=lambda item: (-item[1].height, -item[1].width, item[0])):
+		w = picture.width + 2*pad
+		h = picture.height + 2*pad
+		for page in pages:
+			spot = page.place(w, h)
+			if spot is not None:
+				break
+		else:
+			page = Page(opts.page_size)
+			pages.append(page)
+			spot = page.place(w, h)
+		page.regions.append((name, picture, spot[0] + pad, spot[1] + pad))
+	return pages
+
+##	Write the pages and the manifest
+def save(pages, opts):
+	if not os.path.exists(opts.output):
+		os.makedirs(opts.output)
+	manifest = open(os.path.join(opts.output, "atlas.xml"), "w")
+	manifest.write('<?xml version="1.0"?>\n')
+	manifest.write('<atlas version="%d">\n' % __version__)
+	for i, page in enumerate(pages):
+		# Trim the unused bottom of the page
+		height = page.used
+		canvas = Picture(page.size, height)
+		filename = "%s/atlas_%03d.png" % (opts.output.replace("\\", "/").rstrip("/"), i)
+		manifest.write('\t<page file=%s w="%d" h="%d">\n' % (quoteattr(filename), page.size, height))
+		for name, picture, x, y in page.regions:
+			canvas.blit(picture, x, y, opts.padding)
+			manifest.write('\t\t<region name=%s x="%d" y="%d" w="%d" h="%d"/>\n' % (quoteattr(name), x, y, picture.width, picture.height))
+		manifest.write('\t</page>\n')
+		png = open(filename, "wb")
+		png.write(encodePng(canvas))
+		png.close()
+		if opts.verbose:
+			print("Wrote %s with %d Images" % (filename, len(page.regions)))
+	manifest.write('</atlas>\n')
+	manifest.close()
+
+##	The normal execution path of this script
+def main():
+	(opts, args) = Parse()
+	if not args:
+		print("ERROR: Nothing to pack.  Pass folders, .png files or .ani files.")
+		sys.exit(1)
+
+	images = []
+	for name, data in collect(args):
+		try:
+			picture = decodePng(data)
+		except (ValueError, KeyError, zlib.error) as error:
+			print("WARNING: Skipping '%s': %s" % (name, error))
+			continue
+		if picture.width > opts.max_size or picture.height > opts.max_size:
+			if opts.verbose:
+				print("Not packing '%s' (%dx%d)" % (name, picture.width, picture.height))
+			continue
+		images.append((name, picture))
+
+	pages = pack(images, opts)
+	print("Packed %d Images into %d pages" % (len(images), len(pages)))
+	if not opts.no_output:
+		save(pages, opts)
+
+# This is the 'pythonic' way of calling main
+if __name__ == "__main__":
+	main()
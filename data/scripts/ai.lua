@@ -69,6 +69,7 @@ function setAccompany(id, accid)
 	else
 		AIData[id].accompany = -1
 	end
+	AIShards.post(id, "setAccompany", id, accid)
 end
 
 function setHuntHostile(id, tid)
@@ -82,6 +83,19 @@ function setHuntHostile(id, tid)
 		AIData[id].hostile = 1
 		AIData[id].foundTarget = 0
 	end
+	AIShards.post(id, "setHuntHostile", id, tid)
+end
+
+-- Change an AI's AIData from outside of its state machine.
+-- When the AI are sharded, this also changes the AIData in the shard that runs it.
+function setAIData(id, fields)
+	if AIData[id] == nil then
+		AIData[id] = { }
+	end
+	for k,v in pairs(fields) do
+		AIData[id][k] = v
+	end
+	AIShards.post(id, "setAIData", id, fields)
 end
 
 --- Hunter AI
@@ -492,8 +506,11 @@ Escort = {
 			ax,ay = accompanySprite:GetPosition()
 
 			local aitype, aitask = accompanySprite:GetState()
-			if aitask == "Hunting" or aitask == "Killing" then
-				AIData[id].target = AIData[AIData[id].accompany].target
+			-- When the AI are sharded, the leader may be run by another shard.
+			-- Then its target is unknown here, so keep accompanying it.
+			local leader = AIData[AIData[id].accompany]
+			if (aitask == "Hunting" or aitask == "Killing") and leader ~= nil and leader.target ~= nil then
+				AIData[id].target = leader.target
 				return "Hunting"
 			end
 		else
@@ -54,6 +54,7 @@ end
 
 function Fleet.add(self, id, leader)
 	if id == nil then return end
+	AIShards.broadcast("Fleets:shardAdd", self.name, id, leader)
 	-- keep track of which ships are in this fleet
 	self.members[id] = true
 	-- but also which fleet the new ship is a member of (for simplicity, only allow one fleet per ship)
@@ -64,6 +65,7 @@ function Fleet.add(self, id, leader)
 end
 
 function Fleet.remove(self, id)
+	AIShards.broadcast("Fleets:shardRemove", self.name, id)
 	self.members[id] = nil
 	Fleets.shipFleet[id] = nil
 	return self
@@ -80,6 +82,7 @@ function Fleet.hasBoth(self, first, second)
 end
 
 function Fleet.target(self, t)
+	AIShards.broadcast("Fleets:order", self.name, "target", t)
 	for n,id in pairs(self.members) do
 		local sprite = self:checkSprite(id)
 		if sprite ~= nil and AIData[id] ~= nil then
@@ -90,6 +93,7 @@ function Fleet.target(self, t)
 end
 
 function Fleet.hunt(self, t)
+	AIShards.broadcast("Fleets:order", self.name, "hunt", t)
 	-- if it doesn't have a GetHull function, it's not a valid target
 	if Epiar.getSprite(t).GetHull == nil then return false end
 	local permitted = false
@@ -106,6 +110,7 @@ function Fleet.hunt(self, t)
 end
 
 function Fleet.gateTravel(self, dest, route)
+	AIShards.broadcast("Fleets:order", self.name, "gateTravel", dest, route)
 	for id,yes in pairs(self.members) do
 		local sprite = self:checkSprite(id)
 		if sprite ~= nil and AIData[id] ~= nil then
@@ -127,6 +132,7 @@ function Fleet.gateTravel(self, dest, route)
 end
 
 function Fleet.formation(self)
+	AIShards.broadcast("Fleets:order", self.name, "formation")
 	for id,yes in pairs(self.members) do
 		local sprite = self:checkSprite(id)
 		if sprite ~= nil and AIData[id] ~= nil then
@@ -142,6 +148,7 @@ function Fleet.formation(self)
 end
 
 function Fleet.hold(self)
+	AIShards.broadcast("Fleets:order", self.name, "hold")
 	for id,yes in pairs(self.members) do
 		local sprite = self:checkSprite(id)
 		if sprite ~= nil and AIData[id] ~= nil then
@@ -173,8 +180,16 @@ function Fleet.getLeader(self, id)
 end
 
 function Fleet.getLeaderRoute(self)
-	if self:getLeader() == PLAYER:GetID() and Autopilot.spcr == nil then
-		return Autopilot.GateRoute
+	if PLAYER ~= nil and self:getLeader() == PLAYER:GetID() then
+		-- The player's Autopilot only exists in the main Lua state, and only once it has been configured.
+		-- The shards get the player's route from the gateTravel order instead.
+		if Autopilot ~= nil and Autopilot.spcr == nil then
+			return Autopilot.GateRoute
+		end
+		return nil
+	elseif AIData[self:getLeader()] == nil or AIData[self:getLeader()].Autopilot == nil then
+		-- When the AI are sharded, the leader may be run by another shard.
+		return nil
 	elseif AIData[self:getLeader()].Autopilot.spcr == nil then
 		return AIData[self:getLeader()].Autopilot.GateRoute
 	else
@@ -275,6 +290,22 @@ Fleets = {
 
 	cleanup = function(self)
 		-- remove any empty fleets
+	end,
+
+	-- When the AI are sharded, each shard has a copy of Fleets.
+	-- The main Lua state keeps the copies up to date with these.
+	shardAdd = function(self, name, id, leader)
+		self:createOrGet(name):add(id, leader)
+	end,
+
+	shardRemove = function(self, name, id)
+		local f = self:get(name)
+		if f ~= nil then f:remove(id) end
+	end,
+
+	order = function(self, name, order, ...)
+		local f = self:get(name)
+		if f ~= nil then f[order](f, ...) end
 	end
 }
 
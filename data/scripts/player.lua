@@ -367,7 +367,9 @@ function hailShip()
 		Epiar.pause()
 
 		local planetNames = Epiar.planetNames()
-		local aiDest = planetNames[AIData[targettedShip:GetID()].destination]
+		local aiData = AIData[targettedShip:GetID()]
+		local aiDest = nil
+		if aiData ~= nil then aiDest = planetNames[aiData.destination] end
 		if aiDest == nil then aiDest = "a port" end
 
 		local aiMachDescs = {
@@ -434,8 +436,7 @@ function doHailSay(said)
 
 	if said == "Your ship looks like junk." then
 		-- when an AI is in "hostile" mode, it will not abandon its target
-		AIData[ HUD.getTarget() ].target = PLAYER:GetID()
-		AIData[ HUD.getTarget() ].hostile = 1
+		setAIData( HUD.getTarget(), { target = PLAYER:GetID(), hostile = 1 } )
 		HUD.newAlert( 1, (string.format("%s: We'll see about that!", targettedSprite:GetModelName() ) ) )
 		doHailEnd()
 		return
@@ -530,7 +531,7 @@ function doHailBFM()
 
 	if ( r == 1 ) then
 		hailReplyLabel.setText(hailReplyLabel,"Very well; I'm feeling gracious at the moment.")
-		AIData[targettedShip:GetID()].target = -1
+		setAIData( targettedShip:GetID(), { target = -1 } )
 		-- 'merciful' means will never arbitrary select player as a target unless provoked
 		targettedShip:SetMerciful(1)
 	else
@@ -626,8 +627,7 @@ function doCapture(succ_max, destruct_max)
 		end
 
 		asEscort = function()
-			AIData[ targettedShip:GetID() ].target = -1
-			AIData[ targettedShip:GetID() ].hostile = 0
+			setAIData( targettedShip:GetID(), { target = -1, hostile = 0 } )
 			Fleets:join( PLAYER:GetID(), targettedShip:GetID() )
 			targettedShip:SetStateMachine("Escort")
 			partiallyRepair(targettedShip)
@@ -963,10 +963,10 @@ function initHiredEscort(playerID, playerX, playerY, escortType, escortPay)
 	local escort = Ship.new(name, playerX - 75 + math.random(150), playerY - 150 + math.random(75), escortType, "Ion Engines", "Escort", "Independent")
 	local eid = escort:GetID()
 
-	AIData[eid] = {
+	setAIData(eid, {
 		accompany = playerID,
 		pay = escortPay,
-	}
+	})
 
 	Fleets:join(playerID, eid)
 
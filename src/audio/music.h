@@ -11,14 +11,18 @@
 
 #include "includes.h"
 #include "audio/audio.h"
+#include "utilities/resource.h"
 
-class Song {
+class Song : public Resource {
 	public:
 		static Song *Get( const string& filename );
 		Song( const string& filename );
 		~Song( void );
 		bool Play( bool loop=true );
 
+		// SDL_mixer does not say how large a Mix_Music is.
+		const char* GetKind( void ) { return "Music"; }
+
 	private:
 		Mix_Music *song;
 };
@@ -25,6 +25,9 @@ class Sound : public Resource {
 		void SetFactors( double fade, float pan );
 		string GetPath( void ) { return pathName.GetRelativePath(); }
 
+		const char* GetKind( void ) { return "Sounds"; }
+		Uint64 GetMemoryUsage( void ) { return ( sound != NULL ) ? sound->alen : 0; }
+
 	private:
 		Mix_Chunk *sound;
 		File pathName;
@@ -0,0 +1,289 @@
+/**\file			benchmark.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Measures how the simulation scales with the number of ships
+ * \details
+ */
+
+#include "includes.h"
+#include "engine/benchmark.h"
+#include "engine/hud.h"
+#include "engine/scenario.h"
+#include "graphics/renderqueue.h"
+#include "sprites/ai.h"
+#include "sprites/effects.h"
+#include "sprites/projectile.h"
+#include "sprites/spritemanager.h"
+#include "utilities/log.h"
+#include "utilities/lua.h"
+#include "utilities/timer.h"
+
+// Room given to each AI ship, so that the density stays the same as the count grows.
+#define BENCHMARK_SHIP_SPACING 250
+
+// Distance from the center of a Sector to its Planets.
+#define BENCHMARK_PLANET_ORBIT 4000.0f
+
+// The state machines dealt out to the AI ships.  Hunters and Bullies pick fights, so Projectiles are fired.
+static const char *benchmarkMachines[] = { "Hunter", "Trader", "Patrol", "Bully" };
+
+/**\brief The default universe: 16 Sectors of 4 Planets, flown by 100 to 10,000 ships.
+ */
+BenchmarkParameters::BenchmarkParameters() :
+	sectors( 16 ),
+	planetsPerSector( 4 ),
+	ticks( 150 ),
+	warmup( 30 )
+{
+	const int counts[] = { 100, 250, 500, 1000, 2500, 5000, 10000 };
+	shipCounts.assign( counts, counts + sizeof(counts) / sizeof(counts[0]) );
+
+	weaponMix.push_back( "Laser" );
+	weaponMix.push_back( "Minigun" );
+	weaponMix.push_back( "Missile" );
+}
+
+/**\class Benchmark
+ * \brief Generates a synthetic universe and records the cost of each part of a tick as the number of ships grows.
+ * \details
+ * The Sectors and Planets are made from the Models, Engines, Weapons and
+ * Alliances of an already loaded Scenario, so the benchmark exercises the
+ * same Components as the game.  The AI ships are added to one of the new
+ * Sectors in steps, and after each step the ticks are timed while the
+ * simulation runs headless.
+ *
+ * Every step writes one CSV row with the mean milliseconds per tick spent on
+ * spatial queries, re-indexing, the Lua AI, Projectile collisions and
+ * drawing.  Drawing is timed without a window, so it measures choosing and
+ * sorting the visible Sprites rather than the renderer.
+ */
+
+/**\brief Prepare to benchmark a Scenario that has been loaded and set up with a Player.
+ */
+Benchmark::Benchmark( Scenario *scenario, const BenchmarkParameters &parameters ) :
+	scenario( scenario ),
+	parameters( parameters ),
+	home( NULL ),
+	spawned( 0 )
+{
+}
+
+/**\brief Split a comma separated list, ignoring blank entries.
+ */
+vector<string> Benchmark::SplitList( const string &list ) {
+	vector<string> items;
+	stringstream stream( list );
+	string item;
+	while( getline( stream, item, ',' ) ) {
+		size_t first = item.find_first_not_of( " \t" );
+		if( first == string::npos ) {
+			continue;
+		}
+		size_t last = item.find_last_not_of( " \t" );
+		items.push_back( item.substr( first, last - first + 1 ) );
+	}
+	return items;
+}
+
+/**\brief Add the synthetic Sectors and Planets, then move to the first new Sector.
+ * \return false if the Scenario lacks the Components to build them from.
+ */
+bool Benchmark::Generate( void ) {
+	list<string> *allianceNames = scenario->GetAlliances()->GetNames();
+	list<string> *planetNames = scenario->GetPlanets()->GetNames();
+
+	if( allianceNames->empty() || planetNames->empty() || scenario->GetModels()->Size() == 0 ) {
+		LogMsg(ERR, "The benchmark needs a Scenario with at least one Alliance, Planet and Model.");
+		return false;
+	}
+	if( parameters.sectors < 1 || parameters.planetsPerSector < 0 ) {
+		LogMsg(ERR, "The benchmark needs at least one Sector.");
+		return false;
+	}
+
+	// Every generated Planet looks like the first Planet of the Scenario.
+	Planet *model = scenario->GetPlanets()->GetPlanet( planetNames->front() );
+	vector<Alliance*> alliances;
+	for( list<string>::iterator a = allianceNames->begin(); a != allianceNames->end(); ++a ) {
+		alliances.push_back( scenario->GetAlliances()->GetAlliance( *a ) );
+	}
+
+	// Forget any Weapons that this Scenario does not have.
+	vector<string> weapons;
+	for( unsigned int w = 0; w < parameters.weaponMix.size(); w++ ) {
+		if( scenario->GetWeapons()->GetWeapon( parameters.weaponMix[w] ) ) {
+			weapons.push_back( parameters.weaponMix[w] );
+		} else {
+			LogMsg(WARN, "The benchmark weapon '%s' does not exist.", parameters.weaponMix[w].c_str() );
+		}
+	}
+	parameters.weaponMix = weapons;
+
+	// Lay the Sectors out on a square grid, each linked to the Sectors beside it.
+	int columns = static_cast<int>( ceil( sqrt( static_cast<double>( parameters.sectors ) ) ) );
+	char name[64];
+	for( int s = 0; s < parameters.sectors; s++ ) {
+		int column = s % columns;
+		int row = s / columns;
+		Alliance *alliance = alliances[ s % alliances.size() ];
+
+		list<string> neighbors;
+		if( column > 0 ) {
+			snprintf( name, sizeof(name), "Benchmark Sector %d", s - 1 );
+			neighbors.push_back( name );
+		}
+		if( column < columns - 1 && s + 1 < parameters.sectors ) {
+			snprintf( name, sizeof(name), "Benchmark Sector %d", s + 1 );
+			neighbors.push_back( name );
+		}
+		if( row > 0 ) {
+			snprintf( name, sizeof(name), "Benchmark Sector %d", s - columns );
+			neighbors.push_back( name );
+		}
+		if( s + columns < parameters.sectors ) {
+			snprintf( name, sizeof(name), "Benchmark Sector %d", s + columns );
+			neighbors.push_back( name );
+		}
+
+		list<string> planets;
+		for( int p = 0; p < parameters.planetsPerSector; p++ ) {
+			float angle = 2.0f * static_cast<float>( M_PI ) * p / parameters.planetsPerSector;
+			snprintf( name, sizeof(name), "Benchmark Planet %d-%d", s, p );
+			scenario->GetPlanets()->Add( new Planet( name,
+				BENCHMARK_PLANET_ORBIT * cos( angle ), BENCHMARK_PLANET_ORBIT * sin( angle ),
+				model->GetImage(), alliance, true, model->GetSurfaceImage(),
+				"A planet made up for the benchmark.", model->GetTechnologies() ) );
+			planets.push_back( name );
+		}
+
+		snprintf( name, sizeof(name), "Benchmark Sector %d", s );
+		Sector *sector = new Sector( name, static_cast<float>( column ), static_cast<float>( row ),
+			alliance, planets, neighbors, 0 );
+		scenario->GetSectors()->Add( sector );
+		if( home == NULL ) {
+			home = sector;
+		}
+	}
+
+	scenario->ResetSector( home );
+
+	LogMsg(INFO, "Generated %d benchmark Sectors with %d Planets each.", parameters.sectors, parameters.planetsPerSector );
+	return true;
+}
+
+/**\brief Add AI ships until there are this many.
+ * \details The ships are scattered over a square that grows with their
+ *          number, and take their Model, Alliance, state machine and Weapons
+ *          in turn from what is available.
+ */
+void Benchmark::Populate( int ships ) {
+	SpriteManager *sprites = scenario->GetSpriteManager();
+	list<string> *modelNames = scenario->GetModels()->GetNames();
+	list<string> *allianceNames = scenario->GetAlliances()->GetNames();
+	vector<string> models( modelNames->begin(), modelNames->end() );
+	vector<string> alliances( allianceNames->begin(), allianceNames->end() );
+	int machines = sizeof(benchmarkMachines) / sizeof(benchmarkMachines[0]);
+
+	int side = static_cast<int>( sqrt( static_cast<double>( ships ) ) * BENCHMARK_SHIP_SPACING );
+	char name[64];
+
+	for( int count = sprites->GetAIShipCount(); count < ships; count++, spawned++ ) {
+		snprintf( name, sizeof(name), "Benchmark %d", spawned );
+		AI *ai = new AI( name, benchmarkMachines[ spawned % machines ] );
+
+		ai->SetWorldPosition( Coordinate( ( rand() % side ) - side / 2, ( rand() % side ) - side / 2 ) );
+
+		Model *model = scenario->GetModels()->GetModel( models[ spawned % models.size() ] );
+		Engine *engine = model->GetDefaultEngine();
+		if( engine == NULL ) {
+			engine = scenario->GetEngines()->GetEngine( scenario->GetEngines()->GetNames()->front() );
+		}
+		ai->SetModel( model );
+		ai->SetEngine( engine );
+		ai->SetAlliance( scenario->GetAlliances()->GetAlliance( alliances[ spawned % alliances.size() ] ) );
+
+		// Fill every weapon slot, then give enough ammunition to last the run.
+		if( !parameters.weaponMix.empty() ) {
+			for( int w = 0; ; w++ ) {
+				Weapon *weapon = scenario->GetWeapons()->GetWeapon( parameters.weaponMix[ ( spawned + w ) % parameters.weaponMix.size() ] );
+				if( !ai->AddShipWeapon( weapon ) ) {
+					break;
+				}
+			}
+			for( int a = 0; a < max_ammo; a++ ) {
+				ai->AddAmmo( static_cast<AmmoType>( a ), 1000 );
+			}
+		}
+
+		ai->SetCredits( 0 );
+		sprites->Add( ai );
+	}
+}
+
+/**\brief Time the ticks at one ship count and write the CSV row.
+ */
+void Benchmark::Measure( int ships, FILE *csv ) {
+	SpriteManager *sprites = scenario->GetSpriteManager();
+	Camera *camera = scenario->GetCamera();
+	double frequency = static_cast<double>( SDL_GetPerformanceFrequency() );
+
+	Populate( ships );
+
+	tickTime.Clear();
+	queryTime.Clear();
+	indexTime.Clear();
+	luaTime.Clear();
+	collisionTime.Clear();
+	drawTime.Clear();
+
+	for( int t = 0; t < parameters.warmup + parameters.ticks; t++ ) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		Timer::Step();
+		scenario->Tick( false );
+		Uint64 drawStart = SDL_GetPerformanceCounter();
+		sprites->UpdateVisibility( camera, static_cast<float>( Radar::GetVisibility() ) );
+		sprites->Draw( camera->GetFocusCoordinate() );
+		RenderQueue::NewFrame();
+		Uint64 end = SDL_GetPerformanceCounter();
+
+		if( t < parameters.warmup ) {
+			continue;
+		}
+
+		tickTime.Add( 1000.0 * ( end - start ) / frequency );
+		drawTime.Add( 1000.0 * ( end - drawStart ) / frequency );
+		queryTime.Add( sprites->GetQueryTime() );
+		indexTime.Add( sprites->GetIndexTime() );
+		luaTime.Add( sprites->GetLuaTime() );
+		collisionTime.Add( sprites->GetCollisionTime() );
+	}
+
+	fprintf( csv, "%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%u,%u,%u,%u,%u,%u\n",
+		ships, sprites->GetAIShipCount(), sprites->GetNumSprites(), tickTime.GetCount(),
+		tickTime.GetMean(), tickTime.GetPercentile( 99.0 ),
+		queryTime.GetMean(), indexTime.GetMean(), luaTime.GetMean(),
+		collisionTime.GetMean(), drawTime.GetMean(),
+		Projectile::GetPool()->GetCapacity(), Projectile::GetPool()->GetHighWater(),
+		Effect::GetPool()->GetCapacity(), Effect::GetPool()->GetHighWater(),
+		RenderQueue::GetCommands(), RenderQueue::GetBatches() );
+	fflush( csv );
+
+	LogMsg(INFO, "Benchmarked %d ships: %.3f ms per tick.", ships, tickTime.GetMean() );
+}
+
+/**\brief Measure every ship count in turn.
+ * \param csv Where to write the results, one row per ship count.
+ */
+void Benchmark::Run( FILE *csv ) {
+	fprintf( csv, "ships,live_ships,sprites,ticks,tick_mean_ms,tick_p99_ms,query_ms,index_ms,lua_ms,collision_ms,draw_ms,projectile_pool,projectile_peak,effect_pool,effect_peak,draw_commands,draw_batches\n" );
+
+	Lua::Call("playerStart");
+	Hud::Init();
+
+	for( unsigned int c = 0; c < parameters.shipCounts.size(); c++ ) {
+		Measure( parameters.shipCounts[c], csv );
+	}
+
+	Hud::Close();
+}
@@ -0,0 +1,56 @@
+/**\file			benchmark.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Measures how the simulation scales with the number of ships
+ * \details
+ */
+
+#ifndef __H_BENCHMARK__
+#define __H_BENCHMARK__
+
+#include "includes.h"
+#include "utilities/tickstats.h"
+
+class Scenario;
+class Sector;
+
+// The synthetic universe to generate, and the ship counts to measure it at.
+struct BenchmarkParameters {
+	BenchmarkParameters();
+
+	int sectors;              ///< Sectors to add, laid out on a square grid.
+	int planetsPerSector;     ///< Planets to add to each of those Sectors.
+	vector<int> shipCounts;   ///< AI ship counts to measure, smallest first.
+	vector<string> weaponMix; ///< Weapons dealt out to the AI ships in turn.
+	int ticks;                ///< Measured ticks at each ship count.
+	int warmup;               ///< Unmeasured ticks after adding ships.
+};
+
+class Benchmark {
+	public:
+		Benchmark( Scenario *scenario, const BenchmarkParameters &parameters );
+
+		bool Generate( void );
+		void Run( FILE *csv );
+
+		static vector<string> SplitList( const string &list );
+
+	private:
+		void Populate( int ships );
+		void Measure( int ships, FILE *csv );
+
+		Scenario *scenario;
+		BenchmarkParameters parameters;
+		Sector *home;         ///< The generated Sector that the ships fly in.
+		int spawned;          ///< AI ships created so far.  Used to name them and deal out their outfits.
+
+		TickStats tickTime;
+		TickStats queryTime;
+		TickStats indexTime;
+		TickStats luaTime;
+		TickStats collisionTime;
+		TickStats drawTime;
+};
+
+#endif // __H_BENCHMARK__
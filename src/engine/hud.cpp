@@ -12,10 +12,14 @@
 #include "engine/scenario.h"
 #include "graphics/video.h"
 #include "graphics/font.h"
+#include "graphics/renderqueue.h"
+#include "sprites/effects.h"
 #include "sprites/player.h"
+#include "sprites/projectile.h"
 #include "sprites/spritemanager.h"
 #include "ui/ui_navmap.h"
 #include "utilities/log.h"
+#include "utilities/luacost.h"
 #include "utilities/timer.h"
 #include "engine/camera.h"
 
@@ -179,7 +183,9 @@ void StatusBar::Update( lua_State* L ) {
 	int returnvals, retpos = -1;
 
 	// Run the StatusBar Updater
+	LuaCostTimer cost( L );
 	returnvals = Lua::Run( lua_updater, true );
+	cost.Stop( "StatusBar", lua_updater, "" );
 
 	// Get the new StatusBar Status
 	if (returnvals == 0) {
@@ -318,11 +324,11 @@ void Hud::HandleInput( list<InputEvent> & events, Camera* camera, SpriteManager*
 				Coordinate screenPos(i->mx, i->my), worldPos;
 				camera->TranslateScreenToWorld( screenPos, worldPos );
 				// Target any clicked Sprite
-				list<Sprite*> *impacts = sprites->GetSpritesNear( worldPos, 5 );
-				if( impacts->size() > 0) {
-					Target( (*(impacts->begin()))->GetID());
+				vector<Sprite*> impacts;
+				sprites->GetSpritesNear( worldPos, 5, &impacts, DRAW_ORDER_ALL, true );
+				if( impacts.size() > 0) {
+					Target( impacts.front()->GetID() );
 				}
-				delete impacts;
 			}
 		}
 	}
@@ -365,6 +371,30 @@ void Hud::DrawFPS( float fps, SpriteManager* sprites ) {
 
 	snprintf(frameRate, sizeof(frameRate) - 1, "%d Sprites", sprites->GetNumSprites());
 	BitType->Render( Video::GetWidth() - 100, Video::GetHeight() - 45, frameRate );
+
+	// Spatial index costs during the last tick
+	char indexCost[64] = {0};
+	snprintf(indexCost, sizeof(indexCost) - 1, "%s: %d queries %.2f ms", sprites->GetSpatialIndexName().c_str(), sprites->GetQueryCount(), sprites->GetQueryTime());
+	BitType->Render( Video::GetWidth() - 200, Video::GetHeight() - 60, indexCost );
+	snprintf(indexCost, sizeof(indexCost) - 1, "%s: reindex %.2f ms collide %.2f ms", sprites->GetSpatialIndexName().c_str(), sprites->GetIndexTime(), sprites->GetCollisionTime());
+	BitType->Render( Video::GetWidth() - 200, Video::GetHeight() - 75, indexCost );
+	snprintf(indexCost, sizeof(indexCost) - 1, "%d nodes acquired %d allocated", sprites->GetNodesAcquired(), sprites->GetNodeAllocations());
+	BitType->Render( Video::GetWidth() - 200, Video::GetHeight() - 90, indexCost );
+	snprintf(indexCost, sizeof(indexCost) - 1, "AI: %d thought %d waited", sprites->GetThinkScheduler()->GetThinks(), sprites->GetThinkScheduler()->GetSkips());
+	BitType->Render( Video::GetWidth() - 200, Video::GetHeight() - 105, indexCost );
+
+	// Pooled Sprites: in use now and at most
+	SpritePool *projectiles = Projectile::GetPool(), *effects = Effect::GetPool();
+	snprintf(indexCost, sizeof(indexCost) - 1, "Pools: shots %u/%u effects %u/%u", projectiles->GetInUse(), projectiles->GetHighWater(), effects->GetInUse(), effects->GetHighWater());
+	BitType->Render( Video::GetWidth() - 200, Video::GetHeight() - 120, indexCost );
+
+	// Queued draws and the draw calls that they needed during the last frame
+	snprintf(indexCost, sizeof(indexCost) - 1, "Batches: %u for %u draws", RenderQueue::GetBatches(), RenderQueue::GetCommands());
+	BitType->Render( Video::GetWidth() - 200, Video::GetHeight() - 135, indexCost );
+
+	// Whole texts that were reused or rendered again, since the start
+	snprintf(indexCost, sizeof(indexCost) - 1, "Text cache: %u hits %u misses", Font::GetTextCacheHits(), Font::GetTextCacheMisses());
+	BitType->Render( Video::GetWidth() - 200, Video::GetHeight() - 150, indexCost );
 }
 
 /**\brief Draws the status bar.
@@ -420,7 +450,8 @@ void Hud::DrawRadarNav( Camera* camera, SpriteManager* sprites ) {
 void Hud::DrawTarget( SpriteManager* sprites ) {
 	Sprite* target = sprites->GetSpriteByID( targetID );
 
-	if(target != NULL) {
+	// The screen position of a Sprite is only kept up to date while it is on screen.
+	if(target != NULL && sprites->IsOnScreen( target )) {
 		int edge = (target->GetImage())->GetWidth() / 6;
 		Coordinate targetScreenPosition = target->GetScreenPosition();
 		if(edge > 25) edge = 25;
@@ -748,8 +779,8 @@ void Radar::Draw( Camera* camera, SpriteManager* sprites ) {
 		return;
 	}*/
 
-	list<Sprite*> *spriteList = sprites->GetSpritesNear(camera->GetFocusCoordinate(), (float)visibility);
-	for( list<Sprite*>::const_iterator iter = spriteList->begin(); iter != spriteList->end(); iter++)
+	const vector<Sprite*>& blips = sprites->GetRadarSprites( (float)visibility );
+	for( vector<Sprite*>::const_iterator iter = blips.begin(); iter != blips.end(); iter++)
 	{
 		Coordinate blip;
 		Sprite *sprite = *iter;
@@ -766,20 +797,23 @@ void Radar::Draw( Camera* camera, SpriteManager* sprites ) {
 
 		radarSize = int((sprite->GetRadarSize() / float(visibility)) * (RADAR_HEIGHT / 4.0));
 
+		int x = (int)blip.GetX();
+		int y = (int)blip.GetY();
 		if( radarSize >= 1 ) {
 			if(sprite->GetID() == Hud::GetTarget() && Timer::GetTicks() % 1000 < 100)
-				Video::DrawCircle( blip, radarSize, 2, WHITE );
+				RenderQueue::SubmitCircle( RENDER_LAYER_HUD, sprite->GetID(), x, y, radarSize, 2, WHITE );
 			else
-				Video::DrawCircle( blip, radarSize, 1, sprite->GetRadarColor() );
+				RenderQueue::SubmitCircle( RENDER_LAYER_HUD, sprite->GetID(), x, y, radarSize, 1, sprite->GetRadarColor() );
 		} else {
 			if(sprite->GetID() == Hud::GetTarget() && Timer::GetTicks() % 1000 < 100)
-				Video::DrawCircle( blip, 1, 2, WHITE );
+				RenderQueue::SubmitCircle( RENDER_LAYER_HUD, sprite->GetID(), x, y, 1, 2, WHITE );
 			else
-				Video::DrawPoint( blip, sprite->GetRadarColor() );
+				RenderQueue::SubmitPoint( RENDER_LAYER_HUD, sprite->GetID(), x, y, sprite->GetRadarColor() );
 		}
 	}
 
-	delete spriteList;
+	// Every blip is drawn at once
+	RenderQueue::Flush();
 }
 
 /**\brief Gets the radar position based on world coordinate
@@ -10,6 +10,7 @@
 #include "engine/mission.h"
 #include "utilities/lua.h"
 #include "utilities/log.h"
+#include "utilities/luacost.h"
 #include "utilities/components.h"
 
 /**\class Mission
@@ -287,7 +288,10 @@ bool Mission::RunFunction(string functionName, bool checkCompletion)
 	lua_rawgeti(L, LUA_REGISTRYINDEX, tableReference);
 	
 	// Call the function
-	if( lua_pcall(L, 1, LUA_MULTRET, 0) != 0)
+	LuaCostTimer cost( L );
+	int error = lua_pcall(L, 1, LUA_MULTRET, 0);
+	cost.Stop( "Mission", type, functionName );
+	if( error != 0 )
 	{
 		LogMsg(ERR,"Failed to run %s.%s: %s\n", type.c_str(), functionName.c_str(), lua_tostring(L, -1));
 		lua_settop(L,initialStackTop);
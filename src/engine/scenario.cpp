@@ -25,6 +25,7 @@
 #include "input/input.h"
 #include "sprites/ai.h"
 #include "sprites/ai_lua.h"
+#include "sprites/ai_shards.h"
 #include "sprites/effects.h"
 #include "sprites/player.h"
 #include "sprites/planets.h"
@@ -34,6 +35,8 @@
 #include "ui/widgets.h"
 #include "utilities/file.h"
 #include "utilities/log.h"
+#include "utilities/memoryreport.h"
+#include "utilities/profiler.h"
 #include "utilities/timer.h"
 #include "utilities/lua.h"
 
@@ -68,6 +71,7 @@ Scenario::Scenario( void ) {
 
 	camera = new Camera();
 	calendar = new Calendar();
+	aiShards = NULL;
 
 	folderpath = "";
 
@@ -208,6 +212,7 @@ bool Scenario::Initialize() {
 
 	// Load ::Run()-specific Lua registers
 	AI_Lua::RegisterAI( luaState );
+	AIShards::RegisterAIShards( luaState );
 
 	Input::RegisterLuaVariables();
 
@@ -225,6 +230,16 @@ bool Scenario::Initialize() {
 		return false;
 	}
 
+	// Run the AI state machines in their own Lua states
+	int luaShards = OPTION(int, "options/simulation/lua-shards");
+	if( luaShards > 0 ) {
+		aiShards = new AIShards( this, luaShards );
+		if( aiShards->GetCount() == 0 ) {
+			delete aiShards;
+			aiShards = NULL;
+		}
+	}
+
 	// Preload animation to prevent FPS drop on first ship explosion
 	Ani::Get("data/animations/explosion1.ani");
 
@@ -294,6 +309,7 @@ void Scenario::ResetSector( Sector *s ) {
 }
 
 Scenario::~Scenario() {
+	delete aiShards; aiShards = NULL;
 	Lua::Close();
 	luaState = NULL;
 
@@ -380,7 +396,7 @@ void Scenario::Run() {
 	Hud::Alert(false, "Epiar is in development. Please report all bugs at epiar.net.");
 
 	// Generate a starfield
-	Starfield starfield( 700 );
+	Starfield starfield( OPTION(int, "options/video/stars") );
 
 	// Load sample game music
 	if(bgmusic && OPTION(int, "options/sound/background")) {
@@ -393,6 +409,7 @@ void Scenario::Run() {
 	int lowFpsFrameCount = 0;
 
 	while( !quit ) {
+		Profiler::BeginFrame();
 		int logicLoops = Timer::Update();
 
 		if(firstLoop) {
@@ -405,71 +422,70 @@ void Scenario::Run() {
 		if( !paused ) {
       			// Logical update cycle
 			while(logicLoops--) {
-        			HandleInput();
+				PROFILE_SCOPE( "Logic" );
+				Profiler::Push( "HandleInput" );
+				HandleInput();
+				Profiler::Pop();
 
 				if(lowFps) {
 					lowFpsFrameCount--;
         			}
 
-				if(player->DidJump()) {
-					player->ResetJump();
-
-					string sectorName = Navigation::GetNextSector();
-					Sector* newSector = sectors->GetSector(sectorName);
-					assert( newSector != NULL );
-
-					// Switch out ships, planets, etc. to new sector
-					ResetSector( newSector );
-
-					// Reset player's coordinates
-					Coordinate newCoordinate = Coordinate(JUMP_DISTANCE_FROM_CENTER, JUMP_DISTANCE_FROM_CENTER);
-					player->SetWorldPosition( newCoordinate * -1 * player->GetJumpAngle() );
-
-					Navigation::RemoveNextSector();
-				}
-
-				// Generate new sector traffic if needed
-				if( lastTrafficTime + TRAFFIC_GENERATION_FREQUENCY < Timer::GetTicks() ) {
-					if( currentSector->GetTraffic() < sprites->GetAIShipCount() ) {
-						if((rand() % 100) > TRAFFIC_GENERATION_CHANCE) {
-							cout << "generating traffic" << endl;
-							currentSector->GenerateTraffic(1);
-						} else {
-							cout << "do not generate traffic, unlucky roll" << endl;
-						}
-					} else {
-						cout << "no traffic: too much (sector ask: " << currentSector->GetTraffic() << "), current count: " << sprites->GetAIShipCount() << endl;
-					}
-					lastTrafficTime = Timer::GetTicks();
-				}
-
-				sprites->Update( luaState, lowFps );
-        			camera->Update( sprites );
-        			sprites->UpdateScreenCoordinates();
-				calendar->Update();
-        			starfield.Update( camera );
+				Tick( lowFps );
+				Profiler::Push( "Camera and Starfield" );
+				sprites->UpdateVisibility( camera, static_cast<float>( Radar::GetVisibility() ) );
+				starfield.Update( camera );
+				Profiler::Pop();
 			}
 		} else {
       			// We prefer input to be inside the logic loop (for the Hz) but
       			// we need to respond to input outside it as well.
+			Profiler::Push( "HandleInput" );
       			HandleInput();
+			Profiler::Pop();
     		}
 
+		Profiler::Push( "Hud::Update" );
 		Hud::Update( luaState );
+		Profiler::Pop();
 
 		// Erase cycle
+		Profiler::Push( "Video::Erase" );
 		Video::Erase();
+		Profiler::Pop();
 
 		// Draw cycle
+		Profiler::Push( "Draw" );
+		Profiler::Push( "Starfield::Draw" );
 		starfield.Draw();
+		Profiler::Pop();
+		Profiler::Push( "SpriteManager::Draw" );
 		sprites->Draw( camera->GetFocusCoordinate() );
+		Profiler::Pop();
+		Profiler::Push( "Hud::Draw" );
 		Hud::Draw( HUD_ALL, currentFPS, camera, sprites );
+		Profiler::Pop();
+		Profiler::Push( "UI::Draw" );
 		UI::Draw();
+		Profiler::Pop();
+		Profiler::Push( "Console::Draw" );
 		console->Draw();
+		Profiler::Pop();
+		Profiler::Push( "Camera::Draw" );
 		camera->Draw();
+		Profiler::Pop();
+		Profiler::Pop();
+		MemoryReport::DrawPanel( sprites );
+		Profiler::DrawOverlay();
+
+		Profiler::Push( "Video::Update" );
 		Video::Update();
+		Profiler::Pop();
 
+		Profiler::Push( "Timer::Delay" );
 		Timer::Delay();
+		Profiler::Pop();
+		Profiler::EndFrame();
 
 		// Counting Frames
 		fpsCount++;
@@ -543,10 +559,92 @@ void Scenario::Run() {
 	}
 
 	Hud::Close();
+	Profiler::StopTrace();
 
 	LogMsg(INFO,"Scenario stopped. Average framerate: %f frames / second", 1000.0 *((float)fpsTotal / Timer::GetTicks() ) );
 }
 
+/**\brief Advance the simulation by one logical tick.
+ * \details This is everything in a tick that does not read input or draw,
+ *          so it is shared by Run and RunHeadless.
+ */
+void Scenario::Tick( bool lowFps ) {
+	PROFILE_SCOPE( "Tick" );
+
+	if(player->DidJump()) {
+		player->ResetJump();
+
+		string sectorName = Navigation::GetNextSector();
+		Sector* newSector = sectors->GetSector(sectorName);
+		assert( newSector != NULL );
+
+		// Switch out ships, planets, etc. to new sector
+		ResetSector( newSector );
+
+		// Reset player's coordinates
+		Coordinate newCoordinate = Coordinate(JUMP_DISTANCE_FROM_CENTER, JUMP_DISTANCE_FROM_CENTER);
+		player->SetWorldPosition( newCoordinate * -1 * player->GetJumpAngle() );
+
+		Navigation::RemoveNextSector();
+	}
+
+	// Generate new sector traffic if needed
+	Profiler::Push( "Traffic" );
+	if( lastTrafficTime + TRAFFIC_GENERATION_FREQUENCY < Timer::GetTicks() ) {
+		if( currentSector->GetTraffic() < sprites->GetAIShipCount() ) {
+			if((rand() % 100) > TRAFFIC_GENERATION_CHANCE) {
+				cout << "generating traffic" << endl;
+				currentSector->GenerateTraffic(1);
+			} else {
+				cout << "do not generate traffic, unlucky roll" << endl;
+			}
+		} else {
+			cout << "no traffic: too much (sector ask: " << currentSector->GetTraffic() << "), current count: " << sprites->GetAIShipCount() << endl;
+		}
+		lastTrafficTime = Timer::GetTicks();
+	}
+	Profiler::Pop();
+
+	Profiler::Push( "SpriteManager::Update" );
+	sprites->Update( luaState, lowFps );
+	Profiler::Pop();
+	Profiler::Push( "Camera::Update" );
+	camera->Update( sprites );
+	Profiler::Pop();
+	calendar->Update();
+}
+
+/**\brief Run the simulation without input, drawing or sound.
+ * \details Every tick advances the game clock by one logical frame, and the
+ *          ticks run one after another as fast as possible.
+ * \param ticks The number of ticks to run.
+ * \param stats [out] How long each tick took.
+ */
+void Scenario::RunHeadless( int ticks, TickStats *stats ) {
+	quit = false;
+
+	if( player == NULL ) {
+		LogMsg(ERR, "No Player has been loaded!");
+		return;
+	}
+	Lua::Call("playerStart");
+	Hud::Init();
+
+	LogMsg(INFO, "Headless scenario started for %d ticks.", ticks);
+
+	double frequency = static_cast<double>( SDL_GetPerformanceFrequency() );
+	for( int t = 0; t < ticks && !quit; t++ ) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		Timer::Step();
+		Tick( false );
+		stats->Add( 1000.0 * ( SDL_GetPerformanceCounter() - start ) / frequency );
+	}
+
+	Hud::Close();
+
+	LogMsg(INFO, "Headless scenario stopped after %d ticks.", stats->GetCount() );
+}
+
 /**\brief Subroutine. Calls various Lua register functions needed by both Run and Edit
  * \return true if successful
  */
@@ -557,6 +655,8 @@ void Scenario::LuaRegisters(lua_State *L) {
 	Planets_Lua::RegisterPlanets(L);
 	Hud::RegisterHud(L);
 	Video::RegisterVideo(L);
+	Profiler::RegisterProfiler(L);
+	MemoryReport::RegisterMemory(L);
 	Calendar_Lua::RegisterCalendar(L);
 }
 
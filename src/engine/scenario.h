@@ -23,6 +23,9 @@
 #include "engine/camera.h"
 #include "input/input.h"
 #include "engine/console.h"
+#include "utilities/tickstats.h"
+
+class AIShards;
 
 class Scenario : public XMLFile {
 	public:
@@ -36,6 +39,7 @@ class Scenario : public XMLFile {
 		bool Setup();
 
 		void Run();
+		void RunHeadless( int ticks, TickStats *stats );
 
 		void CreateDefaultPlayer(string name);
 		void LoadPlayer(string name);
@@ -64,6 +68,7 @@ class Scenario : public XMLFile {
 		PlayerList *GetPlayerList() { return playerList; }
 		Camera *GetCamera() { return camera; }
 		Calendar *GetCalendar() { return calendar; }
+		AIShards *GetAIShards() { return aiShards; }
 		Player *GetPlayer();
 
 		Sector* GetCurrentSector();
@@ -82,7 +87,10 @@ class Scenario : public XMLFile {
 		void SetQuit( bool val ) { quit = val; }
 
 	private:
+		friend class Benchmark;
+
 		bool ParseXML( void );
+		void Tick( bool lowFps );
 		void CreateNavMap( void );
 
 		// Pointers to Singletons
@@ -102,6 +110,7 @@ class Scenario : public XMLFile {
 		Player *player;
 		Camera *camera;
 		Calendar *calendar;
+		AIShards *aiShards; ///< NULL unless the AI run in their own Lua states.
 
 		// Scenario specific variables
 		Song* bgmusic;
@@ -40,21 +40,21 @@
  */
 
 void Scenario_Lua::RegisterScenario(lua_State *L) {
-	Lua::RegisterGlobal("WIDTH", Video::GetWidth() );
-	Lua::RegisterGlobal("HEIGHT", Video::GetHeight() );
+	Lua::RegisterGlobal(L, "WIDTH", Video::GetWidth() );
+	Lua::RegisterGlobal(L, "HEIGHT", Video::GetHeight() );
 
 	// Sprite Types
-	Lua::RegisterGlobal("SPRITE_PLANET",      DRAW_ORDER_PLANET     );
-	Lua::RegisterGlobal("SPRITE_PROJECTILE",  DRAW_ORDER_PROJECTILE );
-	Lua::RegisterGlobal("SPRITE_SHIP",        DRAW_ORDER_SHIP       );
-	Lua::RegisterGlobal("SPRITE_PLAYER",      DRAW_ORDER_PLAYER     );
-	Lua::RegisterGlobal("SPRITE_EFFECT",      DRAW_ORDER_EFFECT     );
+	Lua::RegisterGlobal(L, "SPRITE_PLANET",      DRAW_ORDER_PLANET     );
+	Lua::RegisterGlobal(L, "SPRITE_PROJECTILE",  DRAW_ORDER_PROJECTILE );
+	Lua::RegisterGlobal(L, "SPRITE_SHIP",        DRAW_ORDER_SHIP       );
+	Lua::RegisterGlobal(L, "SPRITE_PLAYER",      DRAW_ORDER_PLAYER     );
+	Lua::RegisterGlobal(L, "SPRITE_EFFECT",      DRAW_ORDER_EFFECT     );
 
 	// Input Key States
-	Lua::RegisterGlobal("KEYUP",              KEYUP      );
-	Lua::RegisterGlobal("KEYDOWN",            KEYDOWN    );
-	Lua::RegisterGlobal("KEYPRESSED",         KEYPRESSED );
-	Lua::RegisterGlobal("KEYTYPED",           KEYTYPED   );
+	Lua::RegisterGlobal(L, "KEYUP",              KEYUP      );
+	Lua::RegisterGlobal(L, "KEYDOWN",            KEYDOWN    );
+	Lua::RegisterGlobal(L, "KEYPRESSED",         KEYPRESSED );
+	Lua::RegisterGlobal(L, "KEYTYPED",           KEYTYPED   );
 
 	static const luaL_Reg EngineFunctions[] = {
 		//{"echo", &Scenario_Lua::Console_echo},
@@ -153,7 +153,6 @@ void Scenario_Lua::StoreScenario(lua_State *L, Scenario *sim) {
 	lua_pushstring(L,"EPIAR_SCENARIO"); // Key
 	lua_pushlightuserdata(L, sim); // Value
 	lua_settable(L,LUA_REGISTRYINDEX);
-	lua_pop(L,1);
 }
 
 /** \brief Retrieve the Simuation pointer associated with a specific lua_State.
@@ -505,12 +504,14 @@ int Scenario_Lua::GetPlanetNames(lua_State *L){
 }
 
 /** \brief Pushes a Sprite reference onto the Lua Stack.
- *  \note Sprites are referenced by their ID.
+ *  \note Sprites are referenced by their SpriteHandle and their ID.
+ *  \see SpriteReference
  */
 void Scenario_Lua::PushSprite(lua_State *L, Sprite* s) {
-	int* id = (int*)lua_newuserdata(L, sizeof(int*));
+	SpriteReference* ref = (SpriteReference*)lua_newuserdata(L, sizeof(SpriteReference));
 
-	*id = s->GetID();
+	ref->id = s->GetID();
+	ref->handle = s->GetHandle();
 
 	switch(s->GetDrawOrder()) {
 	case DRAW_ORDER_SHIP:
@@ -575,29 +576,29 @@ int Scenario_Lua::GetSpriteByID(lua_State *L){
 int Scenario_Lua::GetSprites(lua_State *L, int kind){
 	int n = lua_gettop(L);  // Number of arguments
 
-	list<Sprite *> *sprites = NULL;
+	vector<Sprite *> sprites;
 	if( n==3 ){
 		double x = luaL_checknumber (L, 1);
 		double y = luaL_checknumber (L, 2);
 		double r = luaL_checknumber (L, 3);
-		sprites = GetScenario(L)->GetSpriteManager()->GetSpritesNear(Coordinate(x,y),static_cast<float>(r),kind);
+		// Scripts expect nearby Sprites to be sorted by distance.
+		GetScenario(L)->GetSpriteManager()->GetSpritesNear(Coordinate(x,y),static_cast<float>(r),&sprites,kind,true);
 	} else {
-		sprites = GetScenario(L)->GetSpriteManager()->GetSprites(kind);
+		GetScenario(L)->GetSpriteManager()->GetSprites(&sprites,kind);
 	}
 
 	// Populate a Lua table with Sprites
-	lua_createtable(L, sprites->size(), 0);
+	lua_createtable(L, sprites.size(), 0);
 	int newTable = lua_gettop(L);
 	int index = 1;
-	list<Sprite *>::const_iterator iter = sprites->begin();
-	while(iter != sprites->end()) {
+	vector<Sprite *>::const_iterator iter = sprites.begin();
+	while(iter != sprites.end()) {
 		// push userdata
 		PushSprite(L,(*iter));
 		lua_rawseti(L, newTable, index);
 		++iter;
 		++index;
 	}
-	delete sprites;
 	return 1;
 }
 
@@ -14,6 +14,13 @@
 #include "sprites/sprite.h"
 #include "engine/scenario.h"
 
+// The Lua userdata for a Sprite.
+// The ID comes first so that code reading the userdata as an int still works.
+struct SpriteReference {
+	int id;              ///< The Sprite's unique ID.
+	SpriteHandle handle; ///< The Sprite's handle.  Null if the Sprite had not been added yet.
+};
+
 class Scenario_Lua {
 	public:
 		static void RegisterScenario(lua_State *L);
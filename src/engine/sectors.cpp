@@ -63,15 +63,13 @@ Sector::Sector( string _name,
 	alliance(_alliance),
 	planets(_planets),
 	neighbors(_neighbors),
-	traffic(_traffic)
+	traffic(_traffic),
+	x(_x),
+	y(_y)
 {
 	// Check the inputs
 	assert(_alliance);
 
-	Coordinate pos;
-	pos.SetX(_x);
-	pos.SetY(_y);
-
 	SetName(_name);
 }
 
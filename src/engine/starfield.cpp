@@ -1,43 +1,88 @@
 /**\file			starfield.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, January 3, 2016
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
 
 #include "includes.h"
+#include "common.h"
 #include "engine/starfield.h"
 #include "graphics/video.h"
 #include "engine/camera.h"
+#include "utilities/log.h"
+#include "utilities/profiler.h"
 #include "utilities/timer.h"
 
 /**\class Starfield
- * \brief Controls the starfield. */
+ * \brief Controls the starfield.
+ * \details The stars are grouped by brightness into a few layers.  Dim stars
+ *          are far away, so they move less when the Camera moves.  Each layer
+ *          is drawn once into a texture that wraps around, so moving a layer
+ *          only moves its texture, and drawing it takes a few draw calls no
+ *          matter how many stars there are.
+ */
 
-/**\struct Starfield::_stars
- * \brief Contains x,y coordinate as well as the color
+/**\struct Starfield::_layer
+ * \brief Contains the scroll position and the texture of one layer of stars
  */
 
+// The brightest star; rand() % 225 generates greys between 0 and 225
+#define STARFIELD_MAX_BRIGHTNESS (225.f / 256.f)
+
 /**\brief Initializes the starfield.
  * \param num Number of stars to initialize
  */
 Starfield::Starfield( int numStars ) {
 	int i;
+	vector<Uint32> pixels[STARFIELD_LAYERS];
 
 	// seed the random number generator
 	srand(static_cast<unsigned int>( time(NULL) ));
 
-	// allocate space for stars
-	stars = (struct _star *)malloc( sizeof(struct _star) * numStars );
+	// The stars wrap around an area a bit larger than the screen
+	w = (int)(1.3 * Video::GetWidth());
+	h = (int)(1.4 * Video::GetHeight());
+
+	for( i = 0; i < STARFIELD_LAYERS; i++ ) {
+		layers[i].ox = layers[i].x = 0.0f;
+		layers[i].oy = layers[i].y = 0.0f;
+		layers[i].speed = (i + 0.5f) * STARFIELD_MAX_BRIGHTNESS / STARFIELD_LAYERS;
+		layers[i].texture = NULL;
+		if( !Video::IsHeadless() ) {
+			pixels[i].assign( w * h, 0x000000FF );
+		}
+	}
 
 	// randomly assign position and color
 	for( i = 0; i < numStars; i++ ) {
-		stars[i].ox = stars[i].x = (float)(rand() % (int)(1.3 * Video::GetWidth()));
-		stars[i].oy = stars[i].y = (float)(rand() % (int)(1.4 * Video::GetHeight()));
+		int x = rand() % w;
+		int y = rand() % h;
+		float brightness = static_cast<float>( (rand() % 225) / 256. );
+
+		int layer = (int)(brightness / STARFIELD_MAX_BRIGHTNESS * STARFIELD_LAYERS);
+		if( layer >= STARFIELD_LAYERS ) layer = STARFIELD_LAYERS - 1;
 
-		// rand() % 225 generates greys between 0 and 225
-		stars[i].clr = static_cast<float>( (rand() % 225) / 256. );
+		if( !pixels[layer].empty() ) {
+			plotStar( &pixels[layer][0], x, y, brightness );
+		}
+	}
+
+	// Headless Starfields only scroll
+	for( i = 0; i < STARFIELD_LAYERS && !Video::IsHeadless(); i++ ) {
+		SDL_Texture *texture = SDL_CreateTexture( Video::GetRenderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, w, h );
+		if( texture == NULL ) {
+			LogMsg(ERR, "Could not create a starfield layer: %s", SDL_GetError() );
+			continue;
+		}
+		SDL_UpdateTexture( texture, NULL, &pixels[i][0], w * sizeof(Uint32) );
+
+		// The layers are black where there are no stars, so adding them together only adds the stars.
+		SDL_SetTextureBlendMode( texture, SDL_BLENDMODE_ADD );
+		// Smooth sub-pixel movement when the layer is drawn between pixels.
+		SDL_SetTextureScaleMode( texture, SDL_ScaleModeLinear );
+		layers[i].texture = texture;
 	}
 
 	this->numStars = numStars;
@@ -46,18 +91,46 @@ Starfield::Starfield( int numStars ) {
 /**\brief Destroys Starfield
  */
 Starfield::~Starfield( void ) {
-	assert( stars != NULL );
-	free( stars );
-	stars = NULL;
+	for( int i = 0; i < STARFIELD_LAYERS; i++ ) {
+		if( layers[i].texture ) {
+			SDL_DestroyTexture( layers[i].texture );
+			layers[i].texture = NULL;
+		}
+	}
 }
 
 /**\brief Draws the Starfield
+ * \details Each layer is drawn as often as it takes to cover the screen; at
+ *          most twice in each direction.
  */
 void Starfield::Draw( void ) {
-	int i;
+	double fframe = Timer::GetFFrame();
 
-	for( i = 0; i < numStars; i++ ) {
-		drawStar(stars[i].ox, stars[i].oy, stars[i].x, stars[i].y, stars[i].clr);
+	Video::FlushPrimitives();
+
+	for( int i = 0; i < STARFIELD_LAYERS; i++ ) {
+		_layer *layer = &layers[i];
+		float ix, iy;
+
+		if( layer->texture == NULL ) {
+			continue;
+		}
+
+		if(interpolateOn) {
+			ix = static_cast<float>( layer->ox * (1.0f - fframe) + layer->x * fframe );
+			iy = static_cast<float>( layer->oy * (1.0f - fframe) + layer->y * fframe );
+		} else {
+			ix = layer->x;
+			iy = layer->y;
+		}
+
+		for( float ty = iy - h; ty < Video::GetHeight(); ty += h ) {
+			for( float tx = ix - w; tx < Video::GetWidth(); tx += w ) {
+				SDL_FRect dest = { tx, ty, static_cast<float>( w ), static_cast<float>( h ) };
+				Profiler::CountDraw( layer->texture );
+				SDL_RenderCopyF( Video::GetRenderer(), layer->texture, NULL, &dest );
+			}
+		}
 	}
 }
 
@@ -66,83 +139,58 @@ void Starfield::Draw( void ) {
 void Starfield::Update( Camera *camera ) {
 	int i;
 	double dx, dy;
-	float w, h;
 
 	assert(camera != NULL);
 	camera->GetDelta( &dx, &dy );
 
-	w = static_cast<float>(1.3 * Video::GetWidth());
-	h = static_cast<float>(1.4 * Video::GetHeight());
+	for( i = 0; i < STARFIELD_LAYERS; i++ ) {
+		_layer *layer = &layers[i];
 
-	for( i = 0; i < numStars; i++ ) {
-		stars[i].ox = stars[i].x;
-		stars[i].oy = stars[i].y;
+		layer->ox = layer->x;
+		layer->oy = layer->y;
 
-		stars[i].x -= (float)dx * stars[i].clr;
-		stars[i].y -= (float)dy * stars[i].clr;
+		layer->x -= (float)dx * layer->speed;
+		layer->y -= (float)dy * layer->speed;
 
-		// handle wrapping the stars around if they go offscreen top/left
-		while( stars[i].x < 0.0f ) {
-			stars[i].ox += w;
-			stars[i].x += w;
+		// handle wrapping the layer around if it goes offscreen top/left
+		while( layer->x < 0.0f ) {
+			layer->ox += w;
+			layer->x += w;
 		}
-		while( stars[i].y < 0.0f ) {
-			stars[i].oy += h;
-			stars[i].y += h;
+		while( layer->y < 0.0f ) {
+			layer->oy += h;
+			layer->y += h;
 		}
 
-		// handle wrapping the stars around if they go offscreen bottom/right
-		while( stars[i].x > w ) {
-			stars[i].ox -= w;
-			stars[i].x -= w;
+		// handle wrapping the layer around if it goes offscreen bottom/right
+		while( layer->x > w ) {
+			layer->ox -= w;
+			layer->x -= w;
 		}
-		while( stars[i].y > h ) {
-			stars[i].oy -= h;
-			stars[i].y -= h;
+		while( layer->y > h ) {
+			layer->oy -= h;
+			layer->y -= h;
 		}
 	}
 }
 
-/**\brief Draws the stars
+/**\brief Draws a star into a layer's pixels
+ * \details A star covers the pixel above and left of (x,y) fully, and the two
+ *          pixels beside that by half.  The pixels wrap around the layer, so
+ *          the layer can be tiled without seams.
  */
-inline void Starfield::drawStar(float ox, float oy, float x, float y, float  brightness) {
-	float drawBrightness;
-	float xcomponent;
-	float ycomponent;
-	float ix, iy;
-	double fframe = Timer::GetFFrame();
-
-	if(interpolateOn) {
-		ix = ox * (1.0f - fframe) + x * fframe;
-		iy = oy * (1.0f - fframe) + y * fframe;
-	} else {
-		ix = x;
-		iy = y;
-	}
-
-	// Loop between both X columns
-	for (int xcnt = 0; xcnt <= 1; xcnt++) {
-		// Check for clipping in the X direction (make sure it fits horizontally)
-		if (((int)ix - xcnt)>= 0 && ((int)iy - xcnt) < Video::GetWidth()) {
-			// Loop between both Y rows
-			for (int ycnt = 0; ycnt <= 1; ycnt++) {
-				// Check for clipping in the Y direction (make sure it fits vertically)
-				if ((int)iy - ycnt >= 0 && (int)iy - ycnt < Video::GetHeight()) {
-					// Get the x component of the brightness and divide it by 2
-					xcomponent = (((float)(xcnt - (ix - (int)ix)) * .5f));
-
-					// Get the y component of the brightness and divide it by 2
-					ycomponent = (((float)(ycnt - (iy - (int)iy)) * .5f));
-
-					if(ycomponent < 0) ycomponent = ycomponent * -1;
-					if(xcomponent < 0) xcomponent = xcomponent * -1;
-
-					// Add the x anid y components of the brightness to get the total brightness at that particular location
-					drawBrightness = ((xcomponent + ycomponent) * brightness);
-
-					Video::DrawPoint((int)ix - xcnt, (int)iy - ycnt, drawBrightness, drawBrightness, drawBrightness);
-				}
-			}
-		}
+inline void Starfield::plotStar( Uint32 *pixels, int x, int y, float brightness ) {
+	static const int offsets[3][2] = { {-1,-1}, {0,-1}, {-1,0} };
+	static const float weights[3] = { 1.0f, 0.5f, 0.5f };
+
+	for( int i = 0; i < 3; i++ ) {
+		int px = (x + offsets[i][0] + w) % w;
+		int py = (y + offsets[i][1] + h) % h;
+		Uint32 *pixel = &pixels[py * w + px];
+
+		// Overlapping stars add up, but stay white
+		int grey = ((*pixel) >> 24) + (int)(weights[i] * brightness * 255.f);
+		if( grey > 255 ) grey = 255;
+		*pixel = (grey << 24) | (grey << 16) | (grey << 8) | 0xFF;
 	}
 }
@@ -1,7 +1,7 @@
 /**\file			starfield.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, January 3, 2016
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -11,6 +11,9 @@
 #ifndef __h_starfield__
 #define __h_starfield__
 
+// The number of depths that the stars are grouped into.
+#define STARFIELD_LAYERS 4
+
 class Starfield {
 	public:
 		Starfield( int numStars );
@@ -20,13 +23,16 @@ class Starfield {
 		void Update( Camera *camera );
 
 	private:
-		inline void drawStar( float ox, float oy, float x, float y, float brightness);
+		inline void plotStar( Uint32 *pixels, int x, int y, float brightness );
 
-		struct _star {
-			float x, y, ox, oy;
-			float clr;
-		} *stars;
+		/// All of the stars at one depth, drawn from one texture.
+		struct _layer {
+			float x, y, ox, oy; // scroll offset, now and at the previous Update
+			float speed;        // parallax; how far this layer moves per pixel that the Camera moves
+			SDL_Texture *texture;
+		} layers[STARFIELD_LAYERS];
 
+		int w, h; // size of the area that the stars wrap around
 		int numStars; // number of stars
 };
 
@@ -8,6 +8,8 @@
 
 #include "includes.h"
 #include "graphics/animation.h"
+#include "graphics/atlas.h"
+#include "graphics/renderqueue.h"
 #include "utilities/file.h"
 #include "utilities/log.h"
 #include "utilities/resource.h"
@@ -35,6 +37,7 @@
  *  - Multiple Images concatenated together
  *  
  *  The external python script "ani.py" can be used to extract, modify, and create .ani files.
+ *  The frames may also be packed onto texture atlas pages by "atlas.py".
  *
  *  \warning Since this file format is developed specifically for Epiar it is more fragile than other file formats.  For example, it makes endianess assumptions that require the bytes be swapped before it can be loaded on Big Endian machines.
  *  \see Animation
@@ -123,6 +126,17 @@ bool Ani::Load( string& filename ) {
 
 		pos = file.Tell();
 
+		// Frames packed by atlas.py use their atlas page instead of a texture of their own
+		Image *page;
+		SDL_Rect source;
+		stringstream frameName;
+		frameName << filename << "#" << i;
+		if( Atlas::Find( frameName.str(), &page, &source ) ) {
+			frames[i].UseAtlas( page, source );
+			file.Seek( pos + fs );
+			continue;
+		}
+
 		// On OS X 10.6 with SDL_image 1.2.8, the load from fp is broken, so we load it into a buffer ourselves and SDL_image
 		// loads from that correctly. It's an extra step on our part, but performance/functionally they're identical. Hopefully
 		// this gets fixed in a future SDL_image
@@ -157,6 +171,16 @@ Image* Ani::GetFrame(int frameNum) {
 	return &(frames[frameNum]);
 }
 
+/**\brief The memory held by the textures of every frame.
+ */
+Uint64 Ani::GetMemoryUsage( void ) {
+	Uint64 bytes = 0;
+	for( int i = 0; frames != NULL && i < numFrames; i++ ) {
+		bytes += frames[i].GetMemoryUsage();
+	}
+	return bytes;
+}
+
 /**\var Ani::frames
  *  \brief Frames of the animation as Image objects
  */
@@ -236,6 +260,14 @@ void Animation::Draw( int x, int y, float ang ) {
 	frame->DrawCentered( x, y, ang );
 }
 
+/**\brief Queues the animation at given coordinate.
+ * \sa RenderQueue::SubmitImage
+ */
+void Animation::Queue( Uint8 layer, Uint32 depth, int x, int y, float ang ) {
+	Image* frame = ani->GetFrame( fnum );
+	RenderQueue::SubmitImage( layer, depth, frame, x, y, ang );
+}
+
 
 /**\brief Resets animation data back to the first frame.
  */
@@ -26,6 +26,9 @@ class Ani: public Resource {
 		int GetWidth() { return w; }
 		int GetHeight() { return h; }
 
+		const char* GetKind( void ) { return "Animations"; }
+		Uint64 GetMemoryUsage( void );
+
 	private:
 		Image *frames;
 		int numFrames;
@@ -39,6 +42,7 @@ class Animation {
 		Animation( string filename );
 		bool Update( void );
 		void Draw( int x, int y, float ang );
+		void Queue( Uint8 layer, Uint32 depth, int x, int y, float ang );
 		void SetLoopPercent( float loopPercent );
 		float GetLoopPercent( void ) { return loopPercent; };
 		void Reset( void );
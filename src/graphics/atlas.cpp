@@ -0,0 +1,159 @@
+/**\file			atlas.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Loads the texture atlases made by atlas.py
+ * \details
+ */
+
+#include "includes.h"
+#include "graphics/atlas.h"
+#include "graphics/image.h"
+#include "utilities/file.h"
+#include "utilities/log.h"
+#include "utilities/resource.h"
+
+/**\class Atlas
+ * \brief The pages of packed Images and where each Image is on them.
+ * \details The external python script "atlas.py" packs the pngs and the
+ *          frames of .ani files into a few large pages, and writes a manifest:
+\verbatim
+	<atlas version="1">
+		<page file="data/atlas/atlas_000.png" w="2048" h="1024">
+			<region name="data/graphics/corvet.png" x="1" y="1" w="64" h="64"/>
+			<region name="data/animations/thrust.ani#0" x="67" y="1" w="16" h="8"/>
+		</page>
+	</atlas>
+\endverbatim
+ *          Image::Get and Ani::Load ask the Atlas before loading a file, so
+ *          the Images that were packed share the texture of their page.
+ *          Everything else is loaded on its own, as before.
+ * \see Image::UseAtlas
+ */
+
+vector<Image*> Atlas::pages;
+unordered_map<string,Atlas::Region> Atlas::regions;
+
+// Read an integer attribute, or return 0
+static int GetIntProp( xmlNodePtr node, const char *name ) {
+	int value = 0;
+	xmlChar *prop = xmlGetProp( node, BAD_CAST name );
+	if( prop ) {
+		value = atoi( (const char *)prop );
+		xmlFree( prop );
+	}
+	return value;
+}
+
+// Read a string attribute, or return ""
+static string GetStringProp( xmlNodePtr node, const char *name ) {
+	string value;
+	xmlChar *prop = xmlGetProp( node, BAD_CAST name );
+	if( prop ) {
+		value = (const char *)prop;
+		xmlFree( prop );
+	}
+	return value;
+}
+
+/**\brief Load the atlas pages listed in a manifest.
+ * \param manifest The file written by atlas.py.
+ * \returns False if the manifest could not be used.  Images are then loaded one file at a time.
+ */
+bool Atlas::Load( const string& manifest ) {
+	Unload();
+
+	if( !File::Exists( manifest ) ) {
+		LogMsg(INFO, "There is no texture atlas at '%s'.", manifest.c_str() );
+		return false;
+	}
+
+	File xmlfile = File( manifest );
+	long filelen = xmlfile.GetLength();
+	char *buffer = xmlfile.Read();
+	xmlDocPtr doc = xmlParseMemory( buffer, static_cast<int>(filelen) );
+	delete [] buffer;
+
+	if( doc == NULL ) {
+		LogMsg(ERR, "Could not parse the texture atlas '%s'.", manifest.c_str() );
+		return false;
+	}
+
+	xmlNodePtr root = xmlDocGetRootElement( doc );
+	if( root == NULL || xmlStrcmp( root->name, BAD_CAST "atlas" ) ) {
+		LogMsg(ERR, "'%s' is not a texture atlas.", manifest.c_str() );
+		xmlFreeDoc( doc );
+		return false;
+	}
+	if( GetIntProp( root, "version" ) != ATLAS_VERSION ) {
+		LogMsg(ERR, "The texture atlas '%s' is version %d, expected %d.  Run atlas.py again.", manifest.c_str(), GetIntProp( root, "version" ), ATLAS_VERSION );
+		xmlFreeDoc( doc );
+		return false;
+	}
+
+	for( xmlNodePtr pageNode = root->xmlChildrenNode; pageNode != NULL; pageNode = pageNode->next ) {
+		if( xmlStrcmp( pageNode->name, BAD_CAST "page" ) ) {
+			continue;
+		}
+
+		string filename = GetStringProp( pageNode, "file" );
+		Image *page = new Image();
+		if( !page->Load( filename ) ) {
+			LogMsg(ERR, "Could not load the atlas page '%s'.", filename.c_str() );
+			delete page;
+			continue;
+		}
+		// Stored so that the page is counted with the other Textures.
+		Resource::Store( filename, (Resource*)page );
+		pages.push_back( page );
+
+		for( xmlNodePtr regionNode = pageNode->xmlChildrenNode; regionNode != NULL; regionNode = regionNode->next ) {
+			if( xmlStrcmp( regionNode->name, BAD_CAST "region" ) ) {
+				continue;
+			}
+			Region region;
+			region.page = page;
+			region.source.x = GetIntProp( regionNode, "x" );
+			region.source.y = GetIntProp( regionNode, "y" );
+			region.source.w = GetIntProp( regionNode, "w" );
+			region.source.h = GetIntProp( regionNode, "h" );
+			regions[ GetStringProp( regionNode, "name" ) ] = region;
+		}
+	}
+
+	xmlFreeDoc( doc );
+
+	LogMsg(INFO, "Loaded %d Images on %d texture atlas pages.", GetNumRegions(), GetNumPages() );
+	return true;
+}
+
+/**\brief Forget every region.
+ * \details The pages are Resources, so they are not deleted.  Images that
+ *          were already made from a region keep using their page.
+ */
+void Atlas::Unload( void ) {
+	pages.clear();
+	regions.clear();
+}
+
+/**\brief Find where an Image was packed.
+ * \param name The path of a png, or 'path.ani#frame' for an Animation frame.
+ * \param[out] page The atlas page.
+ * \param[out] source The rectangle of the Image on the page.
+ * \returns False if the Image was not packed.
+ */
+bool Atlas::Find( const string& name, Image **page, SDL_Rect *source ) {
+	unordered_map<string,Region>::iterator found = regions.find( name );
+	if( found == regions.end() ) {
+		return false;
+	}
+	*page = found->second.page;
+	*source = found->second.source;
+	return true;
+}
+
+/**\fn Atlas::GetNumPages( void )
+ *  \brief Returns the number of atlas pages loaded.
+ * \fn Atlas::GetNumRegions( void )
+ *  \brief Returns the number of Images on the atlas pages.
+ */
@@ -0,0 +1,40 @@
+/**\file			atlas.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Loads the texture atlases made by atlas.py
+ * \details
+ */
+
+#ifndef __H_ATLAS__
+#define __H_ATLAS__
+
+#include "includes.h"
+
+class Image;
+
+#define ATLAS_MANIFEST "data/atlas/atlas.xml"
+#define ATLAS_VERSION 1
+
+class Atlas {
+	public:
+		static bool Load( const string& manifest );
+		static void Unload( void );
+
+		static bool Find( const string& name, Image **page, SDL_Rect *source );
+
+		static int GetNumPages( void ) { return pages.size(); }
+		static int GetNumRegions( void ) { return regions.size(); }
+
+	private:
+		/// Where one Image is within an atlas page.
+		struct Region {
+			Image *page;
+			SDL_Rect source;
+		};
+
+		static vector<Image*> pages;
+		static unordered_map<string,Region> regions; ///< By the name of the packed Image.
+};
+
+#endif // __H_ATLAS__
@@ -1,7 +1,7 @@
 /**\file			font.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, February 13, 2016
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -13,18 +13,36 @@
 #include "graphics/video.h"
 #include "utilities/log.h"
 #include "utilities/file.h"
+#include "utilities/options.h"
+#include "utilities/profiler.h"
 
 /**\class Font
- * \brief Font class takes care of initializing fonts. */
+ * \brief Font class takes care of initializing fonts.
+ * \details Printable ASCII is drawn from a glyph atlas: every character is
+ *          rendered once into one texture, and a string becomes one quad per
+ *          character, placed by the advance and kerning of each glyph.  Text
+ *          that changes every frame (counters, coordinates) costs no
+ *          rasterizing and no new textures.
+ *
+ *          Other text (UTF-8, or every string when options/video/glyph-atlas
+ *          is 0) is rendered whole by SDL_ttf.  Those textures are kept in a
+ *          least recently used cache, by text and color, until
+ *          options/video/text-cache kilobytes are used.
+ */
+
+vector<SDL_Vertex> Font::glyphVertices;
+vector<int> Font::glyphIndices;
+Uint32 Font::textCacheHits = 0;
+Uint32 Font::textCacheMisses = 0;
 
 /**\brief Constructs new font (default color white).
  */
-Font::Font():r(1.f),g(1.f),b(1.f),a(1.f),font(NULL),lastRenderedTexture(NULL) {}
+Font::Font():r(1.f),g(1.f),b(1.f),a(1.f),font(NULL),glyphAtlas(NULL),glyphAtlasTried(false),textCacheBytes(0) {}
 
 /**\brief Construct new font based on file.
  * \param filename String containing file.
  */
-Font::Font( string filename, unsigned int size ):r(1.f),g(1.f),b(1.f),a(1.f),font(NULL),lastRenderedTexture(NULL) {
+Font::Font( string filename, unsigned int size ):r(1.f),g(1.f),b(1.f),a(1.f),font(NULL),glyphAtlas(NULL),glyphAtlasTried(false),textCacheBytes(0) {
 	bool success;
 	success = Load( filename, size );
 	assert( success );
@@ -45,7 +63,7 @@ Font* Font::Get( string filename, unsigned int size ) {
 		value = new Font();
 
 		if(value->Load(filename, size)){
-			Resource::Store(filename,(Resource*)value);
+			Resource::Store(ss.str(),(Resource*)value);
 		} else {
 			LogMsg(WARN, "Couldn't Find Font '%s'", filename.c_str());
 			delete value;
@@ -60,7 +78,8 @@ Font* Font::Get( string filename, unsigned int size ) {
 Font::~Font() {
 	TTF_CloseFont(font);
 	font = NULL;
-	if(lastRenderedTexture) { SDL_DestroyTexture(lastRenderedTexture); }
+	if(glyphAtlas) { SDL_DestroyTexture(glyphAtlas); }
+	ClearTextCache();
 	LogMsg(DEBUG, "Font '%s' freed.", fontname.c_str() );
 }
 
@@ -99,6 +118,16 @@ bool Font::Load( string filename, unsigned int size ) {
 		font = NULL;
 	}
 
+	// Anything made from the old font is stale
+	if( glyphAtlas ) {
+		SDL_DestroyTexture( glyphAtlas );
+		glyphAtlas = NULL;
+	}
+	glyphAtlasTried = false;
+	glyphs.clear();
+	kerning.clear();
+	ClearTextCache();
+
 	fontname = fontFile.GetAbsolutePath();
 	font = TTF_OpenFont( fontname.c_str(), size );
 
@@ -109,6 +138,10 @@ bool Font::Load( string filename, unsigned int size ) {
 
 	this->size = size;
 
+	if( OPTION(int, "options/video/glyph-atlas") ) {
+		LoadGlyphMetrics();
+	}
+
 	LogMsg(DEBUG, "Font '%s' loaded.\n", fontname.c_str() );
 
 	return( true );
@@ -123,11 +156,22 @@ unsigned int Font::GetSize( void ){
 int Font::TextWidth( const string& text ) {
 	int w, h;
 
-	TTF_SizeText(font, text.c_str(), &w, &h);
+	if( CanUseGlyphs( text ) ) {
+		return GlyphWidth( text );
+	}
+
+	TTF_SizeUTF8(font, text.c_str(), &w, &h);
 
 	return w;
 }
 
+/**\brief The memory held by the glyph atlas and the cached text.
+ * \details SDL_ttf does not say how large the font itself is.
+ */
+Uint64 Font::GetMemoryUsage( void ) {
+	return Video::GetTextureBytes( glyphAtlas ) + textCacheBytes;
+}
+
 /**\brief Returns the recommended line height of the font.
  * \details
  * It is recommended that you use the line height for rendering lines
@@ -222,63 +266,320 @@ int Font::_Render( int x, int y, const string& text, int h, XPos xpos, YPos ypos
 			assert(0);
 	}
 
-	int ret_w = -1;
+	if( Video::IsHeadless() ) {
+		return TextWidth( text );
+	}
+
+	if( CanUseGlyphs( text ) && BuildGlyphAtlas() ) {
+		DrawGlyphs( xn, yn, text );
+		return GlyphWidth( text );
+	}
+
+	CachedText *cached = GetCachedText( text );
+	if( cached == NULL ) {
+		return 0;
+	}
+
 	SDL_Rect rect;
-	SDL_Texture *t = NULL;
+	rect.x = xn;
+	rect.y = yn;
+	rect.w = cached->w;
+	rect.h = cached->h;
 
-	if(lastRenderedText == text) {
-		assert(lastRenderedTexture != NULL);
+	Video::FlushPrimitives();
+	Profiler::CountDraw( cached->texture );
+	SDL_RenderCopy(Video::GetRenderer(), cached->texture, NULL, &rect);
 
-		rect.x = xn;
-		rect.y = yn;
-		rect.w = lastRenderedW;
-		rect.h = lastRenderedH;
+	//cout << "rendered '" << text << "' at " << xn << ", " << yn << " with color " << r << ", " << g << ", " << b << ", " << a << endl;
 
-		t = lastRenderedTexture;
+	return rect.w;
+}
 
-		ret_w = rect.w;
-	} else {
-		SDL_Surface *s = NULL;
-		SDL_Color fg;
 
-		fg.r = r * 255.;
-		fg.g = g * 255.;
-		fg.b = b * 255.;
-		fg.a = a * 255.;
+/**\brief Measure every glyph of the atlas, and the kerning between them.
+ * \details Only needs the font, so widths are known before anything is drawn.
+ */
+void Font::LoadGlyphMetrics( void ) {
+	const int count = FONT_GLYPH_LAST - FONT_GLYPH_FIRST + 1;
+
+	glyphs.resize( count );
+	for( int i = 0; i < count; i++ ) {
+		Glyph &glyph = glyphs[i];
+		int miny, maxy;
+		if( TTF_GlyphMetrics( font, static_cast<Uint16>( FONT_GLYPH_FIRST + i ), &glyph.minx, &glyph.maxx, &miny, &maxy, &glyph.advance ) != 0 ) {
+			LogMsg(WARN, "Font '%s' has no metrics for '%c'.  Its text will not use a glyph atlas.", fontname.c_str(), FONT_GLYPH_FIRST + i );
+			glyphs.clear();
+			return;
+		}
+		glyph.source.x = glyph.source.y = glyph.source.w = glyph.source.h = 0;
+	}
 
-		s = TTF_RenderUTF8_Blended(font, text.c_str(), fg);
-		if(s == NULL) {
-			LogMsg(ERR, "Could not render '%s'!", text.c_str());
+	kerning.assign( count * count, 0 );
+	if( TTF_GetFontKerning( font ) ) {
+		for( int prev = 0; prev < count; prev++ ) {
+			for( int next = 0; next < count; next++ ) {
+				kerning[ prev * count + next ] = TTF_GetFontKerningSizeGlyphs( font, static_cast<Uint16>( FONT_GLYPH_FIRST + prev ), static_cast<Uint16>( FONT_GLYPH_FIRST + next ) );
+			}
+		}
+	}
+}
 
-			if(text.length() == 0) {
-				LogMsg(ERR, "Text length should not be zero.");
+/**\brief Render every glyph into one white texture.
+ * \details Each glyph is rendered the way SDL_ttf renders a one character
+ *          string, so its position within the line height matches whole text.
+ *          Built on the first draw, since it needs the renderer.
+ * \returns False if this Font has no glyph atlas.
+ */
+bool Font::BuildGlyphAtlas( void ) {
+	if( glyphAtlas != NULL ) {
+		return true;
+	}
+	if( glyphAtlasTried || glyphs.empty() ) {
+		return false;
+	}
+	glyphAtlasTried = true;
+
+	const int count = FONT_GLYPH_LAST - FONT_GLYPH_FIRST + 1;
+	SDL_Color white = { 255, 255, 255, 255 };
+	vector<SDL_Surface*> surfaces( count, (SDL_Surface*)NULL );
+
+	// Place the glyphs in rows, one pixel apart.
+	int x = 0, y = 0, rowHeight = 0, atlasWidth = 0;
+	for( int i = 0; i < count; i++ ) {
+		char text[2] = { static_cast<char>( FONT_GLYPH_FIRST + i ), '\0' };
+		if( text[0] == ' ' ) {
+			continue; // Only moves the pen
+		}
+		surfaces[i] = TTF_RenderUTF8_Blended( font, text, white );
+		if( surfaces[i] == NULL ) {
+			continue;
+		}
+		if( x + surfaces[i]->w > FONT_GLYPH_ATLAS_WIDTH ) {
+			x = 0;
+			y += rowHeight + 1;
+			rowHeight = 0;
+		}
+		glyphs[i].source.x = x;
+		glyphs[i].source.y = y;
+		glyphs[i].source.w = surfaces[i]->w;
+		glyphs[i].source.h = surfaces[i]->h;
+		x += surfaces[i]->w + 1;
+		if( x > atlasWidth ) atlasWidth = x;
+		if( surfaces[i]->h > rowHeight ) rowHeight = surfaces[i]->h;
+	}
+
+	SDL_Surface *atlas = NULL;
+	if( atlasWidth > 0 ) {
+		atlas = SDL_CreateRGBSurfaceWithFormat( 0, atlasWidth, y + rowHeight, 32, SDL_PIXELFORMAT_ARGB8888 );
+	}
+	if( atlas != NULL ) {
+		for( int i = 0; i < count; i++ ) {
+			if( surfaces[i] != NULL ) {
+				SDL_SetSurfaceBlendMode( surfaces[i], SDL_BLENDMODE_NONE );
+				SDL_BlitSurface( surfaces[i], NULL, atlas, &glyphs[i].source );
 			}
+		}
+		glyphAtlas = SDL_CreateTextureFromSurface( Video::GetRenderer(), atlas );
+		SDL_FreeSurface( atlas );
+	}
+	for( int i = 0; i < count; i++ ) {
+		if( surfaces[i] != NULL ) {
+			SDL_FreeSurface( surfaces[i] );
+		}
+	}
+
+	if( glyphAtlas == NULL ) {
+		LogMsg(ERR, "Could not build the glyph atlas of font '%s'.", fontname.c_str() );
+		glyphs.clear(); // Measure with SDL_ttf too, since it will draw everything
+		return false;
+	}
+	SDL_SetTextureBlendMode( glyphAtlas, SDL_BLENDMODE_BLEND );
+	return true;
+}
+
+/**\brief True if every character of the text is in the glyph atlas.
+ */
+bool Font::CanUseGlyphs( const string& text ) {
+	if( glyphs.empty() ) {
+		return false;
+	}
+	for( string::const_iterator c = text.begin(); c != text.end(); ++c ) {
+		if( *c < FONT_GLYPH_FIRST || *c > FONT_GLYPH_LAST ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**\brief The width of the text when drawn from the glyph atlas.
+ * \details Measured like TTF_SizeUTF8: from the leftmost ink to the
+ *          farthest of the last advance and the rightmost ink.
+ */
+int Font::GlyphWidth( const string& text ) {
+	const int count = FONT_GLYPH_LAST - FONT_GLYPH_FIRST + 1;
+	int x = 0, minx = 0, maxx = 0;
+	int prev = -1;
+
+	for( string::const_iterator c = text.begin(); c != text.end(); ++c ) {
+		int index = *c - FONT_GLYPH_FIRST;
+		const Glyph &glyph = glyphs[index];
+		if( prev >= 0 ) {
+			x += kerning[ prev * count + index ];
+		}
+		if( x + glyph.minx < minx ) minx = x + glyph.minx;
+		int right = x + ( glyph.advance > glyph.maxx ? glyph.advance : glyph.maxx );
+		if( right > maxx ) maxx = right;
+		x += glyph.advance;
+		prev = index;
+	}
 
-			return 0;
+	return maxx - minx;
+}
+
+/**\brief Draw the text from the glyph atlas with one draw call.
+ * \param x,y The top left of the text.
+ */
+void Font::DrawGlyphs( int x, int y, const string& text ) {
+	const int count = FONT_GLYPH_LAST - FONT_GLYPH_FIRST + 1;
+	int atlasW, atlasH;
+	SDL_QueryTexture( glyphAtlas, NULL, NULL, &atlasW, &atlasH );
+
+	SDL_Vertex vertex;
+	vertex.color.r = static_cast<Uint8>( r * 255.f );
+	vertex.color.g = static_cast<Uint8>( g * 255.f );
+	vertex.color.b = static_cast<Uint8>( b * 255.f );
+	vertex.color.a = static_cast<Uint8>( a * 255.f );
+
+	glyphVertices.clear();
+	glyphIndices.clear();
+
+	// Like SDL_ttf, a first glyph that reaches left of the pen moves the whole line right.
+	int pen = 0;
+	int prev = -1;
+	for( string::const_iterator c = text.begin(); c != text.end(); ++c ) {
+		int index = *c - FONT_GLYPH_FIRST;
+		const Glyph &glyph = glyphs[index];
+		if( prev >= 0 ) {
+			pen += kerning[ prev * count + index ];
+		} else if( glyph.minx < 0 ) {
+			pen = -glyph.minx;
+		}
+		prev = index;
+
+		if( glyph.source.w > 0 ) {
+			// The glyph's surface starts at its ink if that is left of the pen.
+			float left = TO_FLOAT( x + pen + ( glyph.minx < 0 ? glyph.minx : 0 ) );
+			float top = TO_FLOAT( y );
+			float right = left + glyph.source.w;
+			float bottom = top + glyph.source.h;
+			float u0 = TO_FLOAT( glyph.source.x ) / atlasW;
+			float v0 = TO_FLOAT( glyph.source.y ) / atlasH;
+			float u1 = TO_FLOAT( glyph.source.x + glyph.source.w ) / atlasW;
+			float v1 = TO_FLOAT( glyph.source.y + glyph.source.h ) / atlasH;
+
+			int base = static_cast<int>( glyphVertices.size() );
+			vertex.position.x = left;  vertex.position.y = top;    vertex.tex_coord.x = u0; vertex.tex_coord.y = v0; glyphVertices.push_back( vertex );
+			vertex.position.x = right; vertex.position.y = top;    vertex.tex_coord.x = u1; vertex.tex_coord.y = v0; glyphVertices.push_back( vertex );
+			vertex.position.x = right; vertex.position.y = bottom; vertex.tex_coord.x = u1; vertex.tex_coord.y = v1; glyphVertices.push_back( vertex );
+			vertex.position.x = left;  vertex.position.y = bottom; vertex.tex_coord.x = u0; vertex.tex_coord.y = v1; glyphVertices.push_back( vertex );
+			int quad[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+			glyphIndices.insert( glyphIndices.end(), quad, quad + 6 );
 		}
 
-		rect.x = xn;
-		rect.y = yn;
-		rect.w = s->w;
-		rect.h = s->h;
+		pen += glyph.advance;
+	}
 
-		t = SDL_CreateTextureFromSurface(Video::GetRenderer(), s);
+	if( glyphIndices.empty() ) {
+		return;
+	}
 
-		ret_w = s->w;
-		lastRenderedW = s->w;
-		lastRenderedH = s->h;
+	Video::FlushPrimitives();
+	Profiler::CountDraw( glyphAtlas );
+	SDL_RenderGeometry( Video::GetRenderer(), glyphAtlas,
+		&glyphVertices[0], static_cast<int>( glyphVertices.size() ),
+		&glyphIndices[0], static_cast<int>( glyphIndices.size() ) );
+}
 
-		SDL_FreeSurface(s);
+/**\brief Find the rendered text in the cache, or render it with SDL_ttf.
+ * \details Textures are kept by text and color.  When the cache is over
+ *          options/video/text-cache kilobytes, the least recently drawn
+ *          texts are destroyed.
+ * \returns NULL if SDL_ttf could not render the text.
+ */
+Font::CachedText* Font::GetCachedText( const string& text ) {
+	SDL_Color fg;
+
+	fg.r = r * 255.;
+	fg.g = g * 255.;
+	fg.b = b * 255.;
+	fg.a = a * 255.;
+
+	string key;
+	key.reserve( text.length() + 4 );
+	key += static_cast<char>( fg.r );
+	key += static_cast<char>( fg.g );
+	key += static_cast<char>( fg.b );
+	key += static_cast<char>( fg.a );
+	key += text;
+
+	unordered_map<string,list<CachedText>::iterator>::iterator found = textCacheIndex.find( key );
+	if( found != textCacheIndex.end() ) {
+		textCacheHits++;
+		// Move to the front
+		textCache.splice( textCache.begin(), textCache, found->second );
+		return &textCache.front();
+	}
+	textCacheMisses++;
 
-		if(lastRenderedTexture) { SDL_DestroyTexture(lastRenderedTexture); }
-		lastRenderedTexture = t;
-		lastRenderedText = text;
+	SDL_Surface *s = TTF_RenderUTF8_Blended(font, text.c_str(), fg);
+	if(s == NULL) {
+		LogMsg(ERR, "Could not render '%s'!", text.c_str());
+		return NULL;
 	}
 
-	SDL_RenderCopy(Video::GetRenderer(), t, NULL, &rect);
+	CachedText cached;
+	cached.key = key;
+	cached.texture = SDL_CreateTextureFromSurface(Video::GetRenderer(), s);
+	cached.w = s->w;
+	cached.h = s->h;
+	cached.bytes = Video::GetTextureBytes( cached.texture );
+	SDL_FreeSurface(s);
+
+	if( cached.texture == NULL ) {
+		LogMsg(ERR, "Could not make a texture for '%s'!", text.c_str());
+		return NULL;
+	}
 
-	//cout << "rendered '" << text << "' at " << xn << ", " << yn << " with color " << r << ", " << g << ", " << b << ", " << a << endl;
+	textCache.push_front( cached );
+	textCacheIndex[ key ] = textCache.begin();
+	textCacheBytes += cached.bytes;
+
+	// Evict, but never the text that is about to be drawn
+	Uint64 budget = static_cast<Uint64>( OPTION(int, "options/video/text-cache") ) * 1024;
+	while( textCacheBytes > budget && textCache.size() > 1 ) {
+		CachedText &oldest = textCache.back();
+		textCacheBytes -= oldest.bytes;
+		SDL_DestroyTexture( oldest.texture );
+		textCacheIndex.erase( oldest.key );
+		textCache.pop_back();
+	}
+
+	return &textCache.front();
+}
 
-	return ret_w;
+/**\brief Destroy every cached text texture.
+ */
+void Font::ClearTextCache( void ) {
+	for( list<CachedText>::iterator i = textCache.begin(); i != textCache.end(); ++i ) {
+		SDL_DestroyTexture( i->texture );
+	}
+	textCache.clear();
+	textCacheIndex.clear();
+	textCacheBytes = 0;
 }
 
+/**\fn Font::GetTextCacheHits( void )
+ *  \brief Returns how many texts were drawn from the cache, by every Font.
+ * \fn Font::GetTextCacheMisses( void )
+ *  \brief Returns how many texts had to be rendered by SDL_ttf, by every Font.
+ */
@@ -1,7 +1,7 @@
 /**\file			font.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, February 13, 2016
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -13,6 +13,10 @@
 #include "graphics/video.h"
 #include "utilities/resource.h"
 
+#define FONT_GLYPH_FIRST 32        ///< The first character drawn from the glyph atlas (space)
+#define FONT_GLYPH_LAST 126        ///< The last character drawn from the glyph atlas (~)
+#define FONT_GLYPH_ATLAS_WIDTH 1024 ///< Glyphs wrap onto a new row after this many pixels
+
 class Font : public Resource {
 		public:
 			enum XPos {
@@ -45,18 +49,60 @@ class Font : public Resource {
 			int Render( int x, int y, const string& text, XPos xpos = LEFT, YPos ypos = TOP );
 			int RenderTight( int x, int y, const string& text, XPos xpos = LEFT, YPos ypos = TOP );
 
+			const char* GetKind( void ) { return "Fonts"; }
+			Uint64 GetMemoryUsage( void );
+
+			static Uint32 GetTextCacheHits( void ) { return textCacheHits; }
+			static Uint32 GetTextCacheMisses( void ) { return textCacheMisses; }
+
 		private:
+			/// Where a character is in the glyph atlas, and how far it moves the pen.
+			struct Glyph {
+				SDL_Rect source;
+				int minx, maxx, advance;
+			};
+
+			/// A whole string rendered by SDL_ttf.
+			struct CachedText {
+				string key;
+				SDL_Texture *texture;
+				int w, h;
+				Uint64 bytes;
+			};
+
 			int _Render( int x, int y, const string& text, int h, XPos xpos, YPos ypos);
 
+			void LoadGlyphMetrics( void );
+			bool BuildGlyphAtlas( void );
+			bool CanUseGlyphs( const string& text );
+			int GlyphWidth( const string& text );
+			void DrawGlyphs( int x, int y, const string& text );
+
+			CachedText* GetCachedText( const string& text );
+			void ClearTextCache( void );
+
 			string fontname; // filename of the loaded font
 			float r, g, b, a; // color of text
 			int height, width, base;
 			unsigned int size;
 
 			TTF_Font* font;
-			SDL_Texture* lastRenderedTexture; // cache of last rendered texture
-			string lastRenderedText;
-			int lastRenderedW, lastRenderedH;
+
+			// Printable ASCII is drawn from one texture of white glyphs.
+			vector<Glyph> glyphs;
+			vector<int> kerning; ///< Between each pair of glyphs, by [previous * count + next]
+			SDL_Texture* glyphAtlas;
+			bool glyphAtlasTried;
+
+			// Everything else is rendered whole, and kept until the byte budget is used.
+			list<CachedText> textCache; ///< Most recently used first
+			unordered_map<string,list<CachedText>::iterator> textCacheIndex;
+			Uint64 textCacheBytes;
+
+			static vector<SDL_Vertex> glyphVertices;
+			static vector<int> glyphIndices;
+			static Uint32 textCacheHits;
+			static Uint32 textCacheMisses;
 };
 
 #endif // H_FONT
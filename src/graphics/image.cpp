@@ -10,21 +10,28 @@
  */
 
 #include "includes.h"
+#include "graphics/atlas.h"
 #include "graphics/image.h"
 #include "graphics/video.h"
 #include "utilities/file.h"
 #include "utilities/log.h"
+#include "utilities/profiler.h"
 #include "utilities/trig.h"
 
 /**\class Image
  * \brief Image handling. */
 
+Uint32 Image::nextTextureID = 0;
+
 /**\brief Constructor, initialize default values
  */
 Image::Image() {
 	w = h = real_w = real_h = 0;
 	image = NULL;
 	scale_w = scale_h = 1.;
+	atlas = NULL;
+	alphaMod = 255;
+	textureID = 0;
 	filepath = "";
 }
 
@@ -34,6 +41,9 @@ Image::Image( const string& filename ) {
 	w = h = real_w = real_h = 0;
 	image = NULL;
 	scale_w = scale_h = 1.;
+	atlas = NULL;
+	alphaMod = 255;
+	textureID = 0;
 	filepath = "";
 
 	Load(filename);
@@ -45,6 +55,9 @@ Image::Image( SDL_Texture* texture, int w, int h ) {
 	this->w = real_w = w;
 	this->h = real_h = h;
 	scale_w = scale_h = 1.;
+	atlas = NULL;
+	alphaMod = 255;
+	textureID = 0;
 	filepath = "";
 
 	image = texture;
@@ -53,12 +66,64 @@ Image::Image( SDL_Texture* texture, int w, int h ) {
 /**\brief Deallocate allocations
  */
 Image::~Image() {
-	if ( image ) {
+	// An atlas page owns the texture of its Images
+	if ( image && atlas == NULL ) {
 		SDL_DestroyTexture( image );
 		image = NULL;
 	}
 }
 
+/**\brief The memory held by the texture.
+ */
+Uint64 Image::GetMemoryUsage( void ) {
+	// The page is counted instead
+	if( atlas ) {
+		return 0;
+	}
+	return Video::GetTextureBytes( image );
+}
+
+/**\brief Use a region of an atlas page instead of a texture of its own
+ * \param page The atlas page.
+ * \param source Where this Image is on the page.
+ * \sa Atlas
+ */
+void Image::UseAtlas( Image *page, const SDL_Rect& source ) {
+	atlas = page;
+	this->source = source;
+	image = page->image;
+	w = real_w = source.w;
+	h = real_h = source.h;
+}
+
+/**\brief The corners of this Image within its texture, from 0.0 to 1.0
+ */
+void Image::GetTexCoords( float *u0, float *v0, float *u1, float *v1 ) {
+	if( atlas == NULL || atlas->w == 0 || atlas->h == 0 ) {
+		*u0 = *v0 = 0.f;
+		*u1 = *v1 = 1.f;
+		return;
+	}
+	*u0 = static_cast<float>( source.x ) / atlas->w;
+	*v0 = static_cast<float>( source.y ) / atlas->h;
+	*u1 = static_cast<float>( source.x + source.w ) / atlas->w;
+	*v1 = static_cast<float>( source.y + source.h ) / atlas->h;
+}
+
+/**\brief A small number that identifies this Image's texture.
+ * \details The RenderQueue sorts by this number to group the draws of each texture.
+ */
+Uint32 Image::GetTextureID( void ) {
+	// Every Image on one atlas page is drawn together
+	if( atlas ) {
+		return atlas->GetTextureID();
+	}
+	if( textureID == 0 ) {
+		textureID = ++nextTextureID;
+	}
+	return textureID;
+}
+
 /**\brief Lazy fetch an Image
  */
 Image* Image::Get( string filename ) {
@@ -68,7 +133,13 @@ Image* Image::Get( string filename ) {
 	if( value == NULL ) {
 		value = new Image();
 
-		if(value->Load(filename)) {
+		Image *page;
+		SDL_Rect source;
+		if( Atlas::Find( filename, &page, &source ) ) {
+			value->UseAtlas( page, source );
+			value->filepath = filename;
+			Resource::Store(filename, (Resource*)value);
+		} else if(value->Load(filename)) {
 			Resource::Store(filename, (Resource*)value);
 		} else {
 			LogMsg(DEBUG, "Couldn't Find Image '%s'", filename.c_str());
@@ -122,6 +193,20 @@ bool Image::Load( char *buf, int bufSize ) {
 		return( false );
 	}
 
+	if( Video::IsHeadless() ) {
+		// There is no renderer to make a texture with, but the size is still needed.
+		SDL_Surface *surface = IMG_Load_RW( rw, 0 );
+		SDL_FreeRW(rw);
+		if( surface == NULL ) {
+			LogMsg(WARN, "Failed to load image from buffer" );
+			return( false );
+		}
+		w = surface->w;
+		h = surface->h;
+		SDL_FreeSurface( surface );
+		return( true );
+	}
+
 	image = IMG_LoadTexture_RW( Video::GetRenderer(), rw, 0 );
 	SDL_FreeRW(rw);
 	if( image == NULL ) {
@@ -149,6 +234,11 @@ void Image::DrawAlpha( int x, int y, float alpha ) {
 /**\brief Draw the image (angle is in degrees)
  */
 void Image::_Draw( int x, int y, float r, float g, float b, float alpha, float angle, float resize_ratio_w, float resize_ratio_h) {
+	// Headless Images only know their size.
+	if( Video::IsHeadless() ) {
+		return;
+	}
+
 	if( image == NULL ) {
 		LogMsg(WARN, "Trying to draw without loading an image first." );
 		return;
@@ -161,8 +251,25 @@ void Image::_Draw( int x, int y, float r, float g, float b, float alpha, float a
 	dest.w = w * resize_ratio_w;
 	dest.h = h * resize_ratio_h;
 
-	SDL_SetTextureAlphaMod(image, alpha * 255.);
-	SDL_RenderCopyEx(Video::GetRenderer(), image, NULL, &dest, angle, NULL, SDL_FLIP_NONE );
+	Video::FlushPrimitives();
+	SetAlphaMod( alpha );
+	Profiler::CountDraw( image );
+	SDL_RenderCopyEx(Video::GetRenderer(), image, atlas ? &source : NULL, &dest, angle, NULL, SDL_FLIP_NONE );
+}
+
+/**\brief Set the alpha of the texture, unless it already has that alpha
+ */
+void Image::SetAlphaMod( float alpha ) {
+	// The Images on an atlas page share its texture
+	if( atlas ) {
+		atlas->SetAlphaMod( alpha );
+		return;
+	}
+	Uint8 mod = static_cast<Uint8>( alpha * 255. );
+	if( mod != alphaMod ) {
+		SDL_SetTextureAlphaMod( image, mod );
+		alphaMod = mod;
+	}
 }
 
 /**\brief Draw the image centered on (x,y)
@@ -220,8 +327,13 @@ void Image::DrawTiled( int x, int y, int fill_w, int fill_h, float alpha ) {
 			dest.y = y + j;
 			dest.w = fill_w < w ? fill_w : w;
 			dest.h = fill_h < h ? fill_h : h;
+			if( atlas ) {
+				src.x += source.x;
+				src.y += source.y;
+			}
 
-			SDL_SetTextureAlphaMod(image, alpha * 255.);
+			SetAlphaMod( alpha );
+			Profiler::CountDraw( image );
 			SDL_RenderCopyEx(Video::GetRenderer(), image, &src, &dest, 0., NULL, SDL_FLIP_NONE );
 		}
 	}
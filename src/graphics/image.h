@@ -59,9 +59,22 @@ class Image : public Resource {
 
 		string GetPath(){return filepath;}
 
+		// Use a region of an atlas page instead of a texture of its own
+		void UseAtlas( Image *page, const SDL_Rect& source );
+		bool IsInAtlas( void ) { return atlas != NULL; }
+
+		// Used by the RenderQueue to draw this Image
+		SDL_Texture* GetTexture( void ) { return image; }
+		Uint32 GetTextureID( void );
+		void GetTexCoords( float *u0, float *v0, float *u1, float *v1 );
+
+		const char* GetKind( void ) { return "Textures"; }
+		Uint64 GetMemoryUsage( void );
+
 	private:
 		// Draw the image (angle in degrees)
 		void _Draw( int x, int y, float r, float g, float b, float alpha = 1.f, float angle = 0.f, float resize_ratio_w = 1.f, float resize_ratio_h = 1.f );
+		void SetAlphaMod( float alpha );
 
 		int w, h; // virtual w/h (effective, same as original file)
 		int real_w, real_h; // real w/h, size of expanded canvas (image) should expansion be needed
@@ -71,7 +84,13 @@ class Image : public Resource {
 		                        // defaults = 1.0, this factor is always used, so non-expanded images are
 		                        // simply "scaled" at 1.0. THIS HAS NOTHING TO DO WITH RESIZE()
 		SDL_Texture* image;
+		Image *atlas; // the atlas page holding this Image, which owns the texture, or NULL
+		SDL_Rect source; // where this Image is on the atlas page
+		Uint8 alphaMod; // the alpha last set on the texture, to avoid setting it for every draw
+		Uint32 textureID; // small unique number for sorting draws by texture, 0 until first used
 		string filepath;
+
+		static Uint32 nextTextureID;
 };
 
 #endif // __H_IMAGE__
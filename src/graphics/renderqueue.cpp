@@ -0,0 +1,319 @@
+/**\file			renderqueue.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Sorts and batches draws so that each texture is drawn at once
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "graphics/image.h"
+#include "graphics/renderqueue.h"
+#include "graphics/video.h"
+#include "utilities/log.h"
+#include "utilities/profiler.h"
+
+/**\class RenderQueue
+ * \brief Collects draws and submits them with one draw call per texture.
+ * \details Each draw is stored as triangles with a 64 bit sort key.  From the
+ *          highest bits down, the key holds:
+ *          - the layer, so that Planets are below Ships and Effects are on top.
+ *          - the texture, so that every draw of one texture is adjacent.
+ *          - the depth, usually the Sprite ID, so that the order is stable.
+ *
+ *          Flush radix sorts the keys and draws each run of one texture with a
+ *          single SDL_RenderGeometry call.  The number of draw calls depends on
+ *          the number of distinct textures and layers, not the number of Sprites.
+ *
+ *          Alpha is stored in the vertex colors, so textures are not modified.
+ *          The layers do not interleave with the immediate mode draws in Video,
+ *          so the owner of a group of draws must Flush before drawing anything else.
+ */
+
+vector<RenderQueue::Command> RenderQueue::commands;
+vector<SDL_Vertex> RenderQueue::vertices;
+vector<int> RenderQueue::indices;
+vector<Uint32> RenderQueue::order;
+vector<Uint32> RenderQueue::scratch;
+vector<SDL_Vertex> RenderQueue::batchVertices;
+vector<int> RenderQueue::batchIndices;
+Uint32 RenderQueue::frameCommands = 0;
+Uint32 RenderQueue::frameBatches = 0;
+Uint32 RenderQueue::lastCommands = 0;
+Uint32 RenderQueue::lastBatches = 0;
+
+// The number of bits in each part of the sort key.
+#define RENDER_KEY_TEXTURE_BITS 24
+#define RENDER_KEY_DEPTH_BITS 32
+
+// A queued circle has one segment per pixel of radius, within these limits.
+#define RENDER_CIRCLE_SEGMENTS_MIN 8
+#define RENDER_CIRCLE_SEGMENTS_MAX 48
+
+/**\brief Pack a sort key.
+ */
+Uint64 RenderQueue::MakeKey( Uint8 layer, Uint32 textureID, Uint32 depth ) {
+	return ( static_cast<Uint64>( layer ) << (RENDER_KEY_TEXTURE_BITS + RENDER_KEY_DEPTH_BITS) )
+		| ( static_cast<Uint64>( textureID & ((1 << RENDER_KEY_TEXTURE_BITS) - 1) ) << RENDER_KEY_DEPTH_BITS )
+		| static_cast<Uint64>( depth );
+}
+
+/**\brief Start a new Command whose vertices and indices follow.
+ */
+RenderQueue::Command& RenderQueue::Push( Uint8 layer, Uint32 depth, SDL_Texture *texture, Uint32 textureID ) {
+	Command command;
+	command.key = MakeKey( layer, textureID, depth );
+	command.texture = texture;
+	command.firstVertex = static_cast<Uint32>( vertices.size() );
+	command.firstIndex = static_cast<Uint32>( indices.size() );
+	command.numIndices = 0;
+	commands.push_back( command );
+	return commands.back();
+}
+
+/**\brief Queue an Image centered on (x,y).
+ * \param layer A RENDER_LAYER.
+ * \param depth The order within the layer and texture.
+ * \param image The Image to draw.
+ * \param x Screen coordinate of the center.
+ * \param y Screen coordinate of the center.
+ * \param angle Clockwise rotation in degrees.
+ * \param alpha Between 0.0 and 1.0.
+ * \sa Image::DrawCentered
+ */
+void RenderQueue::SubmitImage( Uint8 layer, Uint32 depth, Image *image, int x, int y, float angle, float alpha ) {
+	// Headless Images have no texture, but are still queued so that the cost can be measured.
+	if( image->GetTexture() == NULL && !Video::IsHeadless() ) {
+		LogMsg(WARN, "Trying to draw without loading an image first." );
+		return;
+	}
+
+	Command& command = Push( layer, depth, image->GetTexture(), image->GetTextureID() );
+
+	// Match the rounding of Image::DrawCentered.
+	float w = static_cast<float>( image->GetWidth() );
+	float h = static_cast<float>( image->GetHeight() );
+	float left = static_cast<float>( x - image->GetWidth() / 2 );
+	float top = static_cast<float>( y - image->GetHeight() / 2 );
+	float cx = left + w / 2.f;
+	float cy = top + h / 2.f;
+
+	// Like SDL_RenderCopyEx, rotate clockwise around the center.
+	float c = 1.f, s = 0.f;
+	if( angle != 0.f ) {
+		float radians = angle * static_cast<float>( V_PI ) / 180.f;
+		c = cosf( radians );
+		s = sinf( radians );
+	}
+
+	static const float corners[4][2] = { {-0.5f,-0.5f}, {0.5f,-0.5f}, {0.5f,0.5f}, {-0.5f,0.5f} };
+	SDL_Color color = { 255, 255, 255, static_cast<Uint8>( alpha * 255.f ) };
+
+	// Images on an atlas page only use part of the texture.
+	float u0, v0, u1, v1;
+	image->GetTexCoords( &u0, &v0, &u1, &v1 );
+
+	for( int i = 0; i < 4; i++ ) {
+		float dx = corners[i][0] * w;
+		float dy = corners[i][1] * h;
+		SDL_Vertex vertex;
+		vertex.position.x = cx + dx * c - dy * s;
+		vertex.position.y = cy + dx * s + dy * c;
+		vertex.color = color;
+		vertex.tex_coord.x = u0 + (corners[i][0] + 0.5f) * (u1 - u0);
+		vertex.tex_coord.y = v0 + (corners[i][1] + 0.5f) * (v1 - v0);
+		vertices.push_back( vertex );
+	}
+
+	static const int quad[6] = { 0, 1, 2, 0, 2, 3 };
+	indices.insert( indices.end(), quad, quad + 6 );
+	command.numIndices = 6;
+}
+
+/**\brief Queue the outline of a circle.
+ * \param lineWidth The thickness of the outline, centered on the radius.
+ * \sa Video::DrawCircle
+ */
+void RenderQueue::SubmitCircle( Uint8 layer, Uint32 depth, int x, int y, int radius, float lineWidth, Color c, float alpha ) {
+	Command& command = Push( layer, depth, NULL, 0 );
+
+	int segments = RENDER_CIRCLE_SEGMENTS_MIN + radius;
+	if( segments > RENDER_CIRCLE_SEGMENTS_MAX ) segments = RENDER_CIRCLE_SEGMENTS_MAX;
+
+	SDL_Color color = { static_cast<Uint8>( c.r * 255.f ), static_cast<Uint8>( c.g * 255.f ), static_cast<Uint8>( c.b * 255.f ), static_cast<Uint8>( alpha * 255.f ) };
+	float inner = static_cast<float>( radius ) - lineWidth / 2.f;
+	float outer = static_cast<float>( radius ) + lineWidth / 2.f;
+	if( inner < 0.f ) inner = 0.f;
+
+	// A ring of quads, each made from one inner and one outer vertex per segment.
+	const vector<SDL_FPoint> &unit = Video::GetUnitCircle( segments );
+	for( int i = 0; i < segments; i++ ) {
+		float dx = unit[i].x;
+		float dy = unit[i].y;
+		SDL_Vertex vertex;
+		vertex.color = color;
+		vertex.tex_coord.x = vertex.tex_coord.y = 0.f;
+		vertex.position.x = x + dx * inner;
+		vertex.position.y = y + dy * inner;
+		vertices.push_back( vertex );
+		vertex.position.x = x + dx * outer;
+		vertex.position.y = y + dy * outer;
+		vertices.push_back( vertex );
+
+		int a = 2 * i;
+		int b = 2 * ((i + 1) % segments);
+		int ring[6] = { a, a + 1, b + 1, a, b + 1, b };
+		indices.insert( indices.end(), ring, ring + 6 );
+	}
+	command.numIndices = 6 * segments;
+}
+
+/**\brief Queue a single pixel.
+ * \sa Video::DrawPoint
+ */
+void RenderQueue::SubmitPoint( Uint8 layer, Uint32 depth, int x, int y, Color c, float alpha ) {
+	Command& command = Push( layer, depth, NULL, 0 );
+
+	SDL_Color color = { static_cast<Uint8>( c.r * 255.f ), static_cast<Uint8>( c.g * 255.f ), static_cast<Uint8>( c.b * 255.f ), static_cast<Uint8>( alpha * 255.f ) };
+	static const float corners[4][2] = { {0.f,0.f}, {1.f,0.f}, {1.f,1.f}, {0.f,1.f} };
+
+	for( int i = 0; i < 4; i++ ) {
+		SDL_Vertex vertex;
+		vertex.position.x = x + corners[i][0];
+		vertex.position.y = y + corners[i][1];
+		vertex.color = color;
+		vertex.tex_coord.x = vertex.tex_coord.y = 0.f;
+		vertices.push_back( vertex );
+	}
+
+	static const int quad[6] = { 0, 1, 2, 0, 2, 3 };
+	indices.insert( indices.end(), quad, quad + 6 );
+	command.numIndices = 6;
+}
+
+/**\brief Sort the Commands by key.
+ * \details A least significant digit radix sort, one byte at a time.  Bytes
+ *          that are the same in every key are skipped, so the usual cost is
+ *          a few passes over the Commands.
+ */
+void RenderQueue::SortCommands( void ) {
+	Uint32 count = static_cast<Uint32>( commands.size() );
+
+	order.resize( count );
+	scratch.resize( count );
+	for( Uint32 i = 0; i < count; i++ ) {
+		order[i] = i;
+	}
+
+	for( int shift = 0; shift < 64; shift += 8 ) {
+		Uint32 histogram[256] = {0};
+		for( Uint32 i = 0; i < count; i++ ) {
+			histogram[ (commands[i].key >> shift) & 0xFF ]++;
+		}
+
+		// Every key has the same byte here, so this pass would not move anything.
+		if( histogram[ (commands[0].key >> shift) & 0xFF ] == count ) {
+			continue;
+		}
+
+		Uint32 offset = 0;
+		for( int b = 0; b < 256; b++ ) {
+			Uint32 n = histogram[b];
+			histogram[b] = offset;
+			offset += n;
+		}
+
+		for( Uint32 i = 0; i < count; i++ ) {
+			Uint32 c = order[i];
+			scratch[ histogram[ (commands[c].key >> shift) & 0xFF ]++ ] = c;
+		}
+		order.swap( scratch );
+	}
+}
+
+/**\brief Submit the current batch as one draw call.
+ */
+void RenderQueue::DrawBatch( SDL_Texture *texture ) {
+	if( batchIndices.empty() ) {
+		return;
+	}
+
+	frameBatches++;
+	if( !Video::IsHeadless() ) {
+		Profiler::CountDraw( texture );
+		if( texture == NULL ) {
+			SDL_SetRenderDrawBlendMode( Video::GetRenderer(), SDL_BLENDMODE_BLEND );
+		}
+		SDL_RenderGeometry( Video::GetRenderer(), texture,
+			&batchVertices[0], static_cast<int>( batchVertices.size() ),
+			&batchIndices[0], static_cast<int>( batchIndices.size() ) );
+	}
+
+	batchVertices.clear();
+	batchIndices.clear();
+}
+
+/**\brief Draw everything that has been queued.
+ * \details Consecutive Commands that share a texture are drawn together.
+ */
+void RenderQueue::Flush( void ) {
+	if( commands.empty() ) {
+		return;
+	}
+
+	// Anything drawn through Video before now must stay underneath.
+	Video::FlushPrimitives();
+
+	SortCommands();
+
+	SDL_Texture *texture = commands[ order[0] ].texture;
+	Uint64 textureKey = commands[ order[0] ].key >> RENDER_KEY_DEPTH_BITS;
+
+	for( vector<Uint32>::iterator i = order.begin(); i != order.end(); ++i ) {
+		const Command& command = commands[*i];
+
+		// The layer and texture are the top of the key.
+		if( (command.key >> RENDER_KEY_DEPTH_BITS) != textureKey ) {
+			DrawBatch( texture );
+			texture = command.texture;
+			textureKey = command.key >> RENDER_KEY_DEPTH_BITS;
+		}
+
+		int base = static_cast<int>( batchVertices.size() );
+		Uint32 lastVertex = static_cast<Uint32>( vertices.size() );
+		if( *i + 1 < commands.size() ) {
+			lastVertex = commands[*i + 1].firstVertex;
+		}
+		batchVertices.insert( batchVertices.end(), vertices.begin() + command.firstVertex, vertices.begin() + lastVertex );
+		for( Uint32 n = 0; n < command.numIndices; n++ ) {
+			batchIndices.push_back( base + indices[ command.firstIndex + n ] );
+		}
+	}
+	DrawBatch( texture );
+
+	frameCommands += static_cast<Uint32>( commands.size() );
+	commands.clear();
+	vertices.clear();
+	indices.clear();
+}
+
+/**\brief Start counting the draws of a new frame.
+ * \details Anything that was never Flushed is discarded.
+ */
+void RenderQueue::NewFrame( void ) {
+	lastCommands = frameCommands;
+	lastBatches = frameBatches;
+	frameCommands = 0;
+	frameBatches = 0;
+
+	commands.clear();
+	vertices.clear();
+	indices.clear();
+}
+
+/**\fn RenderQueue::GetCommands( void )
+ *  \brief Returns the number of draws submitted during the last frame.
+ * \fn RenderQueue::GetBatches( void )
+ *  \brief Returns the number of draw calls made during the last frame.
+ */
@@ -0,0 +1,71 @@
+/**\file			renderqueue.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Sorts and batches draws so that each texture is drawn at once
+ * \details
+ */
+
+#ifndef __H_RENDERQUEUE__
+#define __H_RENDERQUEUE__
+
+#include "includes.h"
+#include "graphics/color.h"
+
+class Image;
+
+// Layers are drawn from lowest to highest.  Within a layer the draws are
+// grouped by texture, then drawn by depth.
+#define RENDER_LAYER_PLANET            0 ///< Layer for Planet Sprites
+#define RENDER_LAYER_PROJECTILE        1 ///< Layer for Projectile Sprites
+#define RENDER_LAYER_SHIP              2 ///< Layer for Ship Sprites
+#define RENDER_LAYER_SHIP_FLARE        3 ///< Layer for the engine flares of Ships
+#define RENDER_LAYER_PLAYER            4 ///< Layer for the Player Sprite
+#define RENDER_LAYER_PLAYER_FLARE      5 ///< Layer for the engine flare of the Player
+#define RENDER_LAYER_EFFECT            6 ///< Layer for Effect Sprites (Explosions)
+#define RENDER_LAYER_HUD               7 ///< Layer for the Hud, such as Radar blips
+
+class RenderQueue {
+	public:
+		static void SubmitImage( Uint8 layer, Uint32 depth, Image *image, int x, int y, float angle = 0.f, float alpha = 1.f );
+		static void SubmitCircle( Uint8 layer, Uint32 depth, int x, int y, int radius, float lineWidth, Color c, float alpha = 1.f );
+		static void SubmitPoint( Uint8 layer, Uint32 depth, int x, int y, Color c, float alpha = 1.f );
+
+		static void Flush( void );
+		static void NewFrame( void );
+
+		static Uint32 GetCommands( void ) { return lastCommands; } ///< Draws submitted during the last frame.
+		static Uint32 GetBatches( void ) { return lastBatches; }   ///< Draw calls made during the last frame.
+
+	private:
+		/// One submitted draw.  Its vertices and indices are stored in the queue.
+		struct Command {
+			Uint64 key;
+			SDL_Texture *texture;
+			Uint32 firstVertex;
+			Uint32 firstIndex;
+			Uint32 numIndices;
+		};
+
+		static Uint64 MakeKey( Uint8 layer, Uint32 textureID, Uint32 depth );
+		static Command& Push( Uint8 layer, Uint32 depth, SDL_Texture *texture, Uint32 textureID );
+		static void SortCommands( void );
+		static void DrawBatch( SDL_Texture *texture );
+
+		static vector<Command> commands;    ///< The draws since the last Flush, in submission order.
+		static vector<SDL_Vertex> vertices; ///< The vertices of every Command.
+		static vector<int> indices;         ///< The triangles of every Command, relative to its firstVertex.
+		static vector<Uint32> order;        ///< The Commands sorted by key.
+		static vector<Uint32> scratch;      ///< Radix sort buffer.
+
+		// One batch is built at a time.  Kept between frames to avoid reallocating.
+		static vector<SDL_Vertex> batchVertices;
+		static vector<int> batchIndices;
+
+		static Uint32 frameCommands;
+		static Uint32 frameBatches;
+		static Uint32 lastCommands;
+		static Uint32 lastBatches;
+};
+
+#endif // __H_RENDERQUEUE__
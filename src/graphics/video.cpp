@@ -1,16 +1,18 @@
 /**\file			video.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Thursday, December 24, 2015
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
 
 #include "includes.h"
 #include "common.h"
+#include "graphics/renderqueue.h"
 #include "graphics/video.h"
 #include "utilities/file.h"
 #include "utilities/log.h"
+#include "utilities/profiler.h"
 #include "utilities/xmlfile.h"
 #include "utilities/trig.h"
 
@@ -45,12 +47,24 @@ int Video::h2 = 0;
 stack<Rect> Video::cropRects;
 SDL_Window *Video::window = NULL;
 SDL_Renderer *Video::renderer = NULL;
+bool Video::headless = false;
+vector<SDL_Vertex> Video::batchVertices;
+vector<int> Video::batchIndices;
+map<int,vector<SDL_Rect> > Video::circleSpans;
+map<pair<int,int>,vector<SDL_Point> > Video::ellipsePoints;
+map<int,vector<SDL_FPoint> > Video::unitCircles;
+stack<Video::SavedTarget> Video::savedTargets;
+Uint32 Video::targetGeneration = 0;
 
 /**\brief Initializes the Video display.
+ * \param headless Do not open a window.  Nothing is drawn, but Images are
+ *                 still loaded so that their sizes are known.
  */
-bool Video::Initialize( void ) {
+bool Video::Initialize( bool headless ) {
+	Video::headless = headless;
+
 	// Initialize SDL
-	if( SDL_Init( SDL_INIT_VIDEO ) != 0 ) {
+	if( SDL_Init( headless ? 0 : SDL_INIT_VIDEO ) != 0 ) {
 		LogMsg(ERR, "Could not initialize SDL: %s", SDL_GetError() );
 		return( false );
 	} else {
@@ -63,7 +77,15 @@ bool Video::Initialize( void ) {
 	int h = OPTION( int, "options/video/h" );
 	bool fullscreen = OPTION( bool, "options/video/fullscreen" );
 
-	Video::SetWindow( w, h, OPTION( int, "options/video/bpp"), fullscreen );
+	if( headless ) {
+		Video::w = w;
+		Video::h = h;
+		w2 = w / 2;
+		h2 = h / 2;
+		LogMsg(INFO, "Video is headless at %dx%d.", w, h );
+	} else {
+		Video::SetWindow( w, h, OPTION( int, "options/video/bpp"), fullscreen );
+	}
 
 	/* Initialize SDL_image */
 	if( IMG_Init( IMG_INIT_PNG ) != IMG_INIT_PNG ) {
@@ -176,12 +198,23 @@ int Video::lua_getHeight(lua_State *L) {
 /**\brief Video updates.
  */
 void Video::Update( void ) {
+	if( headless ) {
+		return;
+	}
+	FlushPrimitives();
 	SDL_RenderPresent(renderer);
 }
 
 /**\brief Clears screen.
  */
 void Video::Erase( void ) {
+	RenderQueue::NewFrame();
+	batchVertices.clear();
+	batchIndices.clear();
+
+	if( headless ) {
+		return;
+	}
 	SDL_SetRenderDrawColor(renderer, 0., 0., 0., 255.);
 	SDL_RenderClear(renderer);
 }
@@ -198,11 +231,114 @@ int Video::GetHeight( void ) {
 	return( h );
 }
 
+/**\brief Estimates the memory used by a texture from its size and format.
+ * \returns 0 for NULL.
+ */
+Uint64 Video::GetTextureBytes( SDL_Texture *texture ) {
+	Uint32 format;
+	int w, h;
+	if( texture == NULL || SDL_QueryTexture( texture, &format, NULL, &w, &h ) != 0 ) {
+		return 0;
+	}
+	int bytesPerPixel = SDL_BYTESPERPIXEL( format );
+	if( bytesPerPixel == 0 ) {
+		bytesPerPixel = 4; // Planar formats; assume the worst.
+	}
+	return static_cast<Uint64>( w ) * h * bytesPerPixel;
+}
+
+/**\brief Draw every primitive that has been batched.
+ * \details Points, rectangles, circles and straight lines are collected into
+ *          one list of colored triangles, and drawn with one call.  Anything
+ *          that is not batched (Images, Text, crop changes) must flush first
+ *          so that the order on screen is kept.
+ */
+void Video::FlushPrimitives( void ) {
+	if( batchIndices.empty() ) {
+		return;
+	}
+
+	if( !headless ) {
+		Profiler::CountDraw( NULL );
+		// Blending with an alpha of 255 is the same as not blending.
+		SDL_SetRenderDrawBlendMode( renderer, SDL_BLENDMODE_BLEND );
+		SDL_RenderGeometry( renderer, NULL,
+			&batchVertices[0], static_cast<int>( batchVertices.size() ),
+			&batchIndices[0], static_cast<int>( batchIndices.size() ) );
+	}
+
+	batchVertices.clear();
+	batchIndices.clear();
+}
+
+/**\brief Add a filled rectangle to the batch.
+ * \details The corners are on pixel edges, so exactly w*h pixels are covered.
+ */
+void Video::BatchRect( int x, int y, int w, int h, float r, float g, float b, float a ) {
+	if( w <= 0 || h <= 0 ) {
+		return;
+	}
+
+	SDL_Vertex vertex;
+	vertex.color.r = static_cast<Uint8>( r * 255.f );
+	vertex.color.g = static_cast<Uint8>( g * 255.f );
+	vertex.color.b = static_cast<Uint8>( b * 255.f );
+	vertex.color.a = static_cast<Uint8>( a * 255.f );
+	vertex.tex_coord.x = vertex.tex_coord.y = 0.f;
+
+	int base = static_cast<int>( batchVertices.size() );
+	vertex.position.x = TO_FLOAT( x );     vertex.position.y = TO_FLOAT( y );     batchVertices.push_back( vertex );
+	vertex.position.x = TO_FLOAT( x + w ); vertex.position.y = TO_FLOAT( y );     batchVertices.push_back( vertex );
+	vertex.position.x = TO_FLOAT( x + w ); vertex.position.y = TO_FLOAT( y + h ); batchVertices.push_back( vertex );
+	vertex.position.x = TO_FLOAT( x );     vertex.position.y = TO_FLOAT( y + h ); batchVertices.push_back( vertex );
+
+	batchIndices.push_back( base );
+	batchIndices.push_back( base + 1 );
+	batchIndices.push_back( base + 2 );
+	batchIndices.push_back( base );
+	batchIndices.push_back( base + 2 );
+	batchIndices.push_back( base + 3 );
+}
+
+/**\brief Points around a circle of radius 1, starting at angle 0.
+ * \details Computed once per number of segments.
+ */
+const vector<SDL_FPoint>& Video::GetUnitCircle( int segments ) {
+	map<int,vector<SDL_FPoint> >::iterator found = unitCircles.find( segments );
+	if( found != unitCircles.end() ) {
+		return found->second;
+	}
+	vector<SDL_FPoint> &circle = unitCircles[ segments ];
+	circle.resize( segments );
+	for( int i = 0; i < segments; i++ ) {
+		double radians = V_2PI * i / segments;
+		circle[i].x = static_cast<float>( cos( radians ) );
+		circle[i].y = static_cast<float>( sin( radians ) );
+	}
+	return circle;
+}
+
+// A horizontal line from x1 to x2 (inclusive) as a one pixel tall rectangle.
+static void AddSpan( vector<SDL_Rect> &spans, int x1, int x2, int y ) {
+	SDL_Rect span;
+	span.x = x1 < x2 ? x1 : x2;
+	span.y = y;
+	span.w = abs( x2 - x1 ) + 1;
+	span.h = 1;
+	spans.push_back( span );
+}
+
+static void AddPoint( vector<SDL_Point> &points, int x, int y ) {
+	SDL_Point point;
+	point.x = x;
+	point.y = y;
+	points.push_back( point );
+}
+
 /**\brief draws a point, a single pixel, on the screen
  */
 void Video::DrawPoint( int x, int y, float r, float g, float b ) {
-	SDL_SetRenderDrawColor(renderer, r * 255., g * 255., b * 255., 255.);
-	SDL_RenderDrawPoint(renderer, x, y);
+	BatchRect( x, y, 1, 1, r, g, b, 1.0f );
 }
 
 /**\brief Draw a point using Coordinate and Color.
@@ -224,8 +360,19 @@ void Video::DrawLine( int x1, int y1, int x2, int y2, Color c, float a ) {
 }
 
 /**\brief Draw a Line.
+ * \details Horizontal and vertical lines are batched.  Others are drawn at once.
  */
 void Video::DrawLine( int x1, int y1, int x2, int y2, float r, float g, float b, float a ) {
+	if( x1 == x2 || y1 == y2 ) {
+		int left = x1 < x2 ? x1 : x2;
+		int top = y1 < y2 ? y1 : y2;
+		BatchRect( left, top, abs( x2 - x1 ) + 1, abs( y2 - y1 ) + 1, r, g, b, a );
+		return;
+	}
+
+	FlushPrimitives();
+	Profiler::CountDraw( NULL );
+	SDL_SetRenderDrawBlendMode( renderer, SDL_BLENDMODE_BLEND );
 	SDL_SetRenderDrawColor( renderer, r * 255., g * 255., b * 255., a * 255. );
   
 	SDL_RenderDrawLine( renderer, x1, y1, x2, y2 );
@@ -234,16 +381,7 @@ void Video::DrawLine( int x1, int y1, int x2, int y2, float r, float g, float b,
 /**\brief Draws a filled rectangle
  */
 void Video::DrawRect( int x, int y, int w, int h, float r, float g, float b, float a ) {
-	SDL_Rect rect;
-
-	rect.x = x;
-	rect.y = y;
-	rect.w = w;
-	rect.h = h;
- 
-	SDL_SetRenderDrawColor( renderer, r * 255., g * 255., b * 255., a * 255. );
-  
-	SDL_RenderFillRect( renderer, &rect );
+	BatchRect( x, y, w, h, r, g, b, a );
 }
 
 void Video::DrawRect( int x, int y, int w, int h, Color c, float a ) {
@@ -261,18 +399,23 @@ void Video::DrawBox( int x, int y, int w, int h, Color c, float a ) {
 /**\brief Draws an unfilled rectangle
  */
 void Video::DrawBox( int x, int y, int w, int h, float r, float g, float b, float a ) {
-	SDL_Rect rect;
-
 	a = 0.5;
 
-	SDL_SetRenderDrawColor( renderer, r * 255., g * 255., b * 255., a * 255. );
-
-	rect.x = x;
-	rect.y = y;
-	rect.w = w;
-	rect.h = h;
+	if( w <= 0 || h <= 0 ) {
+		return;
+	}
 
-	SDL_RenderDrawRect( renderer, &rect );
+	// Each edge is one pixel wide.  The corners belong to the top and bottom edges.
+	BatchRect( x, y, w, 1, r, g, b, a );
+	if( h > 1 ) {
+		BatchRect( x, y + h - 1, w, 1, r, g, b, a );
+	}
+	if( h > 2 ) {
+		BatchRect( x, y + 1, 1, h - 2, r, g, b, a );
+		if( w > 1 ) {
+			BatchRect( x + w - 1, y + 1, 1, h - 2, r, g, b, a );
+		}
+	}
 }
 
 /**\brief Draws a circle.
@@ -326,10 +469,32 @@ void Video::DrawFilledCircle( int x, int y, int radius, Color c, float a) {
 }
 
 /**\brief Draw a filled circle.
+ * \details The spans of each radius are cached and batched.
+ */
+void Video::DrawFilledCircle( int x, int y, int rad, float r, float g, float b, float a) {
+	const vector<SDL_Rect> &spans = GetCircleSpans( rad );
+	for( vector<SDL_Rect>::const_iterator span = spans.begin(); span != spans.end(); ++span ) {
+		BatchRect( x + span->x, y + span->y, span->w, span->h, r, g, b, a );
+	}
+}
+
+/**\brief The horizontal spans of a filled circle around (0,0).
+ * \details Computed once per radius.
  *
  *        Adapted from: SDL2_gfx (zlib licensed, aschiffler at ferzkopp dot net) http://www.ferzkopp.net/Software/SDL2_gfx/Docs/html/_s_d_l2__gfx_primitives_8c_source.html#l01457
  */
-void Video::DrawFilledCircle( int x, int y, int rad, float r, float g, float b, float a) {
+const vector<SDL_Rect>& Video::GetCircleSpans( int rad ) {
+	map<int,vector<SDL_Rect> >::iterator found = circleSpans.find( rad );
+	if( found != circleSpans.end() ) {
+		return found->second;
+	}
+	if( circleSpans.size() >= VIDEO_GEOMETRY_CACHE_MAX ) {
+		circleSpans.clear();
+	}
+	vector<SDL_Rect> &spans = circleSpans[ rad ];
+
+	const Sint16 x = 0;
+	const Sint16 y = 0;
 	Sint16 cx = 0;
 	Sint16 cy = rad;
 	Sint16 ocx = (Sint16) 0xffff;
@@ -340,21 +505,11 @@ void Video::DrawFilledCircle( int x, int y, int rad, float r, float g, float b,
 	Sint16 xpcx, xmcx, xpcy, xmcy;
 	Sint16 ypcy, ymcy, ypcx, ymcx;
 
-	// Convert from 'float'
-	r *= 255.;
-	g *= 255.;
-	b *= 255.;
-	a *= 255.;
-
 	// Sanity check radius 
 	if (rad <= 0) {
-		return;
+		return spans;
 	}
 
-	// Set color
-	SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-	SDL_SetRenderDrawColor(renderer, r, g, b, a);
- 
 	// Draw 
 	do {
 		xpcx = x + cx;
@@ -367,10 +522,10 @@ void Video::DrawFilledCircle( int x, int y, int rad, float r, float g, float b,
 				ypcy = y + cy;
 				ymcy = y - cy;
 
-				SDL_RenderDrawLine(renderer, xmcx, ypcy, xpcx, ypcy);
-				SDL_RenderDrawLine(renderer, xmcx, ymcy, xpcx, ymcy);
+				AddSpan( spans, xmcx, xpcx, ypcy );
+				AddSpan( spans, xmcx, xpcx, ymcy );
 			} else {
-				SDL_RenderDrawLine(renderer, xmcx, y, xpcx, y);
+				AddSpan( spans, xmcx, xpcx, y );
 			}
 
 			ocy = cy;
@@ -381,10 +536,10 @@ void Video::DrawFilledCircle( int x, int y, int rad, float r, float g, float b,
 					ypcx = y + cx;
 					ymcx = y - cx;
 
-					SDL_RenderDrawLine(renderer, xmcy, ymcx, xpcy, ymcx);
-					SDL_RenderDrawLine(renderer, xmcy, ypcx, xpcy, ypcx);
+					AddSpan( spans, xmcy, xpcy, ymcx );
+					AddSpan( spans, xmcy, xpcy, ypcx );
 				} else {
-					SDL_RenderDrawLine(renderer, xmcy, y, xpcy, y);
+					AddSpan( spans, xmcy, xpcy, y );
 				}
 			}
 
@@ -405,13 +560,37 @@ void Video::DrawFilledCircle( int x, int y, int rad, float r, float g, float b,
 
 		cx++;
 	} while (cx <= cy);
+
+	return spans;
 }
 
 /**\brief Draw an ellipse.
+ * \details The points of each size are cached and batched.
+ */
+void Video::DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b, float a) {
+	const vector<SDL_Point> &points = GetEllipsePoints( rx, ry );
+	for( vector<SDL_Point>::const_iterator point = points.begin(); point != points.end(); ++point ) {
+		BatchRect( x + point->x, y + point->y, 1, 1, r, g, b, a );
+	}
+}
+
+/**\brief The points of an ellipse around (0,0).
+ * \details Computed once per pair of radii.
  *
  *        Adapted from: SDL2_gfx (zlib licensed, aschiffler at ferzkopp dot net) http://www.ferzkopp.net/Software/SDL2_gfx/Docs/html/_s_d_l2__gfx_primitives_8c_source.html#l01598
  */
-void Video::DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b, float a) {
+const vector<SDL_Point>& Video::GetEllipsePoints( int rx, int ry ) {
+	map<pair<int,int>,vector<SDL_Point> >::iterator found = ellipsePoints.find( make_pair( rx, ry ) );
+	if( found != ellipsePoints.end() ) {
+		return found->second;
+	}
+	if( ellipsePoints.size() >= VIDEO_GEOMETRY_CACHE_MAX ) {
+		ellipsePoints.clear();
+	}
+	vector<SDL_Point> &points = ellipsePoints[ make_pair( rx, ry ) ];
+
+	const int x = 0;
+	const int y = 0;
 	int ix, iy;
 	int h, i, j, k;
 	int oh, oi, oj, ok;
@@ -420,21 +599,12 @@ void Video::DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b
 	int xmj, xpj, ymi, ypi;
 	int xmk, xpk, ymh, yph;
 
-	// Convert from 'float'
-	r *= 255.;
-	g *= 255.;
-	b *= 255.;
-	a *= 255.;
- 
+
          // Sanity check radii 
          if ((rx <= 0) || (ry <= 0)) {
-                 return;
+                 return points;
          }
  
-         // Set color
-         SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-         SDL_SetRenderDrawColor(renderer, r, g, b, a);
- 
          // Init vars 
          oh = oi = oj = ok = 0xFFFF;
  
@@ -455,13 +625,13 @@ void Video::DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b
                                  if (k > 0) {
                                          ypk = y + k;
                                          ymk = y - k;
-                                         SDL_RenderDrawPoint(renderer, xmh, ypk);
-                                         SDL_RenderDrawPoint(renderer, xph, ypk);
-                                         SDL_RenderDrawPoint(renderer, xmh, ymk);
-                                         SDL_RenderDrawPoint(renderer, xph, ymk);
+                                         AddPoint( points, xmh, ypk );
+                                         AddPoint( points, xph, ypk );
+                                         AddPoint( points, xmh, ymk );
+                                         AddPoint( points, xph, ymk );
                                  } else {
-                                         SDL_RenderDrawPoint(renderer, xmh, y);
-                                         SDL_RenderDrawPoint(renderer, xph, y);
+                                         AddPoint( points, xmh, y );
+                                         AddPoint( points, xph, y );
                                  }
                                  ok = k;
                                  xpi = x + i;
@@ -469,13 +639,13 @@ void Video::DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b
                                  if (j > 0) {
                                          ypj = y + j;
                                          ymj = y - j;
-                                         SDL_RenderDrawPoint(renderer, xmi, ypj);
-                                         SDL_RenderDrawPoint(renderer, xpi, ypj);
-                                         SDL_RenderDrawPoint(renderer, xmi, ymj);
-                                         SDL_RenderDrawPoint(renderer, xpi, ymj);
+                                         AddPoint( points, xmi, ypj );
+                                         AddPoint( points, xpi, ypj );
+                                         AddPoint( points, xmi, ymj );
+                                         AddPoint( points, xpi, ymj );
                                  } else {
-                                         SDL_RenderDrawPoint(renderer, xmi, y);
-                                         SDL_RenderDrawPoint(renderer, xpi, y);
+                                         AddPoint( points, xmi, y );
+                                         AddPoint( points, xpi, y );
                                  }
                                  oj = j;
                          }
@@ -500,13 +670,13 @@ void Video::DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b
                                  if (i > 0) {
                                          ypi = y + i;
                                          ymi = y - i;
-                                         SDL_RenderDrawPoint(renderer, xmj, ypi);
-                                         SDL_RenderDrawPoint(renderer, xpj, ypi);
-                                         SDL_RenderDrawPoint(renderer, xmj, ymi);
-                                         SDL_RenderDrawPoint(renderer, xpj, ymi);
+                                         AddPoint( points, xmj, ypi );
+                                         AddPoint( points, xpj, ypi );
+                                         AddPoint( points, xmj, ymi );
+                                         AddPoint( points, xpj, ymi );
                                  } else {
-                                         SDL_RenderDrawPoint(renderer, xmj, y);
-                                         SDL_RenderDrawPoint(renderer, xpj, y);
+                                         AddPoint( points, xmj, y );
+                                         AddPoint( points, xpj, y );
                                  }
                                  oi = i;
                                  xmk = x - k;
@@ -514,13 +684,13 @@ void Video::DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b
                                  if (h > 0) {
                                          yph = y + h;
                                          ymh = y - h;
-                                         SDL_RenderDrawPoint(renderer, xmk, yph);
-                                         SDL_RenderDrawPoint(renderer, xpk, yph);
-                                         SDL_RenderDrawPoint(renderer, xmk, ymh);
-                                         SDL_RenderDrawPoint(renderer, xpk, ymh);
+                                         AddPoint( points, xmk, yph );
+                                         AddPoint( points, xpk, yph );
+                                         AddPoint( points, xmk, ymh );
+                                         AddPoint( points, xpk, ymh );
                                  } else {
-                                         SDL_RenderDrawPoint(renderer, xmk, y);
-                                         SDL_RenderDrawPoint(renderer, xpk, y);
+                                         AddPoint( points, xmk, y );
+                                         AddPoint( points, xpk, y );
                                  }
                                  oh = h;
                          }
@@ -530,6 +700,8 @@ void Video::DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b
  
                  } while (i > h);
          }
+
+	return points;
 }
 
 /**\brief Draws a targeting overlay.
@@ -538,23 +710,26 @@ void Video::DrawTarget( int x, int y, int w, int h, int d, float r, float g, flo
 	float w2 = w / 2.;
 	float h2 = h / 2.;
 
-	SDL_SetRenderDrawColor( renderer, r * 255., g * 255., b * 255., a * 255. );
+	int left = TO_INT( x - w2 );
+	int right = TO_INT( x + w2 );
+	int top = TO_INT( y - h2 );
+	int bottom = TO_INT( y + h2 );
 
 	// Upper Left Corner
-	SDL_RenderDrawLine(renderer, x - w2, y - h2, x - w2, y - h2 + d);
-	SDL_RenderDrawLine(renderer, x - w2, y - h2, x - w2 + d, y - h2);
+	DrawLine( left, top, left, top + d, r, g, b, a );
+	DrawLine( left, top, left + d, top, r, g, b, a );
 
 	// Upper Right Corner
-	SDL_RenderDrawLine(renderer, x + w2, y - h2, x + w2, y - h2 + d);
-	SDL_RenderDrawLine(renderer, x + w2, y - h2, x + w2 - d, y - h2);
+	DrawLine( right, top, right, top + d, r, g, b, a );
+	DrawLine( right, top, right - d, top, r, g, b, a );
 
 	// Lower Left Corner
-	SDL_RenderDrawLine(renderer, x - w2, y + h2, x - w2, y + h2 - d);
-	SDL_RenderDrawLine(renderer, x - w2, y + h2, x - w2 + d, y + h2);
+	DrawLine( left, bottom, left, bottom - d, r, g, b, a );
+	DrawLine( left, bottom, left + d, bottom, r, g, b, a );
 
 	// Lower Right Corner
-	SDL_RenderDrawLine(renderer, x + w2, y + h2, x + w2, y + h2 - d);
-	SDL_RenderDrawLine(renderer, x + w2, y + h2, x + w2 - d, y + h2);
+	DrawLine( right, bottom, right, bottom - d, r, g, b, a );
+	DrawLine( right, bottom, right - d, bottom, r, g, b, a );
 }
 
 /**\brief Enables the mouse
@@ -586,6 +761,8 @@ int Video::GetHalfHeight( void ) {
 void Video::SetCropRect( int x, int y, int w, int h ) {
 	int xn, yn, wn, hn;
 
+	FlushPrimitives();
+
 	if (cropRects.empty()) {
 		xn = x;
 		yn = y;
@@ -627,12 +804,20 @@ void Video::SetCropRect( int x, int y, int w, int h ) {
 /**\brief Unset the previous crop rectangle after use.
  */
 void Video::UnsetCropRect( void ) {
+	FlushPrimitives();
+
 	if(!cropRects.empty()) { // Shouldn't be empty
 		cropRects.pop();
 	} else {
 		LogMsg(WARN, "You unset the crop rect too many times.");
 	}
 
+	ApplyCropRect();
+}
+
+/**\brief Clip to the current crop rectangle, if there is one.
+ */
+void Video::ApplyCropRect( void ) {
 	if( cropRects.empty() ) {
 		SDL_RenderSetClipRect( renderer, NULL );
 	} else {
@@ -651,6 +836,91 @@ void Video::UnsetCropRect( void ) {
 	}
 }
 
+/**\brief Create a texture that can be drawn into.
+ * \details The texture is blended as premultiplied alpha.  Drawing with the
+ *          normal blend mode onto a cleared target produces premultiplied
+ *          colors, so the texture looks the same as drawing its contents
+ *          directly, even where they are translucent.
+ * \returns NULL if the renderer cannot draw into textures.
+ */
+SDL_Texture* Video::CreateRenderTarget( int w, int h ) {
+	if( headless || w <= 0 || h <= 0 || !SDL_RenderTargetSupported( renderer ) ) {
+		return NULL;
+	}
+
+	SDL_Texture *target = SDL_CreateTexture( renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h );
+	if( target == NULL ) {
+		LogMsg(WARN, "Could not create a %dx%d render target: %s", w, h, SDL_GetError() );
+		return NULL;
+	}
+
+	SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD );
+	if( SDL_SetTextureBlendMode( target, premultiplied ) != 0 ) {
+		SDL_DestroyTexture( target );
+		return NULL;
+	}
+
+	return target;
+}
+
+/**\brief Draw into a texture until PopRenderTarget.
+ * \details The texture is cleared.  Crop rectangles are relative to the
+ *          texture, and those of the previous target return with it.
+ * \returns False if the target could not be used.  Nothing changes.
+ */
+bool Video::PushRenderTarget( SDL_Texture *target ) {
+	FlushPrimitives();
+
+	SavedTarget saved;
+	saved.target = SDL_GetRenderTarget( renderer );
+	if( SDL_SetRenderTarget( renderer, target ) != 0 ) {
+		LogMsg(WARN, "Could not draw into a render target: %s", SDL_GetError() );
+		return false;
+	}
+	saved.cropRects.swap( cropRects );
+	savedTargets.push( saved );
+
+	SDL_RenderSetClipRect( renderer, NULL );
+	SDL_SetRenderDrawColor( renderer, 0, 0, 0, 0 );
+	SDL_RenderClear( renderer );
+	return true;
+}
+
+/**\brief Return to the target that was used before PushRenderTarget.
+ */
+void Video::PopRenderTarget( void ) {
+	if( savedTargets.empty() ) {
+		LogMsg(WARN, "You popped the render target too many times.");
+		return;
+	}
+
+	FlushPrimitives();
+
+	SavedTarget &saved = savedTargets.top();
+	SDL_SetRenderTarget( renderer, saved.target );
+	cropRects.swap( saved.cropRects );
+	savedTargets.pop();
+
+	ApplyCropRect();
+}
+
+/**\brief Draw a whole texture, such as a render target.
+ */
+void Video::DrawTexture( SDL_Texture *texture, int x, int y, int w, int h ) {
+	SDL_Rect dest;
+
+	dest.x = x;
+	dest.y = y;
+	dest.w = w;
+	dest.h = h;
+
+	FlushPrimitives();
+	Profiler::CountDraw( texture );
+	SDL_RenderCopy( renderer, texture, NULL, &dest );
+}
+
 /**\brief Takes a screenshot of the game and saves it to an Image.
  */
 Image *Video::CaptureScreen( void ) {
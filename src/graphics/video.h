@@ -1,7 +1,7 @@
 /**\file			video.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Friday, January 1, 2016
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -22,6 +22,8 @@
 
 #define EPIAR_VIDEO "Video"
 
+#define VIDEO_GEOMETRY_CACHE_MAX 256 ///< Sizes of circle and ellipse kept before the cache is cleared
+
 class Rect {
 	public:
 		float x, y, w, h;
@@ -33,7 +35,7 @@ class Rect {
 
 class Video {
  	public:
-		static bool Initialize( void );
+		static bool Initialize( bool headless = false );
 		static bool Shutdown( void );
 
   		static bool SetWindow( int w, int h, int bpp, bool fullscreen );
@@ -44,6 +46,8 @@ class Video {
   		static void Erase( void );
 
 		static SDL_Renderer* GetRenderer( void ) { return renderer; }
+		static Uint64 GetTextureBytes( SDL_Texture *texture );
+		static bool IsHeadless( void ) { return headless; }
 
   		static void EnableMouse( void );
   		static void DisableMouse( void );
@@ -73,9 +77,19 @@ class Video {
 		static void DrawTarget( int x, int y, int w, int h, int d, float r, float g, float b, float a = 1.0f );
 		static void DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b, float a);
 
+		static void FlushPrimitives( void );
+		static const vector<SDL_FPoint>& GetUnitCircle( int segments );
+
 		static void SetCropRect( int x, int y, int w, int h );
 		static void UnsetCropRect( void );
 
+		static SDL_Texture* CreateRenderTarget( int w, int h );
+		static bool PushRenderTarget( SDL_Texture *target );
+		static void PopRenderTarget( void );
+		static void DrawTexture( SDL_Texture *texture, int x, int y, int w, int h );
+		static void LoseRenderTargets( void ) { targetGeneration++; }
+		static Uint32 GetRenderTargetGeneration( void ) { return targetGeneration; }
+
 		static Image *CaptureScreen( void );
 		static void SaveScreenshot( string filename = "" );
 
@@ -89,6 +103,30 @@ class Video {
 		static stack<Rect> cropRects;
 		static SDL_Window *window;
 		static SDL_Renderer *renderer;
+		static bool headless;
+
+		static void ApplyCropRect( void );
+
+		/// What PushRenderTarget replaced, restored by PopRenderTarget.
+		struct SavedTarget {
+			SDL_Texture *target;
+			stack<Rect> cropRects;
+		};
+		static stack<SavedTarget> savedTargets;
+		static Uint32 targetGeneration; ///< Changes whenever the contents of render targets are lost
+
+		static void BatchRect( int x, int y, int w, int h, float r, float g, float b, float a );
+		static const vector<SDL_Rect>& GetCircleSpans( int radius );
+		static const vector<SDL_Point>& GetEllipsePoints( int rx, int ry );
+
+		// The primitives drawn since the last FlushPrimitives.
+		static vector<SDL_Vertex> batchVertices;
+		static vector<int> batchIndices;
+
+		// Shapes relative to their center, by size.
+		static map<int,vector<SDL_Rect> > circleSpans;
+		static map<pair<int,int>,vector<SDL_Point> > ellipsePoints;
+		static map<int,vector<SDL_FPoint> > unitCircles;
 };
 
 #endif // __H_VIDEO__
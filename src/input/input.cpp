@@ -1,7 +1,7 @@
 /**\file			input.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Sunday, June 4, 2006
- * \date			Modified: Sunday, April 10, 2016
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -14,6 +14,7 @@
 #include "graphics/video.h"
 #include "utilities/log.h"
 #include "utilities/lua.h"
+#include "utilities/luacost.h"
 #include "utilities/timer.h"
 
 /**\class Input
@@ -109,6 +110,11 @@ list<InputEvent> Input::Update() {
 			case SDL_MOUSEWHEEL:
 				_UpdateHandleMouseWheel( &event );
 				break;
+			case SDL_RENDER_TARGETS_RESET:
+			case SDL_RENDER_DEVICE_RESET:
+				// Cached UI must be drawn again
+				Video::LoseRenderTargets();
+				break;
 			default:
 				break;
 		}
@@ -328,7 +334,9 @@ void Input::HandleLuaCallBacks( list<InputEvent> & events ) {
 		map<InputEvent,string>::iterator val = eventMappings.find( *i );
 
 		if( val != eventMappings.end() ) {
+			LuaCostTimer cost( Lua::CurrentState() );
 			Lua::Run( val->second );
+			cost.Stop( "Input", val->second, "" );
 			i = events.erase( i );
 		} else {
 			i++;
@@ -14,15 +14,22 @@
 #include "common.h"
 #include "audio/audio.h"
 #include "tests/graphics.h"
+#include "graphics/atlas.h"
 #include "graphics/font.h"
 #include "graphics/video.h"
 #include "menu.h"
+#include "sprites/effects.h"
+#include "sprites/projectile.h"
+#include "engine/benchmark.h"
+#include "engine/scenario.h"
 #include "ui/ui.h"
 #include "utilities/argparser.h"
 #include "utilities/filesystem.h"
 #include "utilities/log.h"
 #include "utilities/lua.h"
+#include "utilities/memoryreport.h"
 #include "utilities/xmlfile.h"
+#include "utilities/tickstats.h"
 #include "utilities/timer.h"
 
 #ifdef EPIAR_COMPILE_TESTS
@@ -36,10 +43,22 @@ Font *SansSerif = NULL, *BitType = NULL, *Serif = NULL, *Mono = NULL;
 ArgParser *argparser = NULL;
 bool interpolateOn = true;
 
+// Set by --headless, --scenario and --player
+int headlessTicks = 0;
+string headlessScenario = "main";
+string headlessPlayer = "Headless";
+
+// Set by --benchmark and --bench-*
+string benchmarkCSV = "";
+BenchmarkParameters benchmarkParameters;
+
 void InitializeOS           ( int argc, char **argv ); ///< Run OS Specific setup code
 void Main_Load_Options      (); ///< Load the settings files
-void Main_Init_Singletons   (); ///< Initialize global Singletons
+void Main_Init_Singletons   ( bool headless ); ///< Initialize global Singletons
 void Main_Parse_Args        ( int argc, char **argv ); ///< Parse Command Line Arguments
+Scenario* Main_Load_Headless ( void ); ///< Load the Scenario and Player for a run without video or audio
+int  Main_Run_Headless      ( void ); ///< Run a Scenario without video or audio
+int  Main_Run_Benchmark     ( void ); ///< Measure a synthetic universe without video or audio
 void Main_Close_Singletons  ( void ); ///< Close global Singletons
 
 /**Main
@@ -70,8 +89,16 @@ int main( int argc, char **argv ) {
 #endif
 	LogMsg(DEBUG, "Executable Path: %s", argparser->GetPath().c_str() );
 
+	// Simulation only
+	if( headlessTicks > 0 || !benchmarkCSV.empty() ) {
+		Main_Init_Singletons( true );
+		int result = benchmarkCSV.empty() ? Main_Run_Headless() : Main_Run_Benchmark();
+		Main_Close_Singletons();
+		return( result );
+	}
+
 	// Main game
-	Main_Init_Singletons();
+	Main_Init_Singletons( false );
 	Menu::Run();
 
 	LogMsg(DEBUG, "Epiar shutting down." );
@@ -170,21 +197,29 @@ void Main_Load_Options() {
  *
  *  Singletons should be kept to a minimum whenever possible.
  *
- *  \param[in] argc standard c argc
- *  \param[in] argv standard c argv
+ *  \param[in] headless Do not open a window or the audio device.
  *
  *  \TODO Remove Fonts with a style.
  *  \TODO Add Logger
  *
  *  \warn This may exit early on Errors
  */
-void Main_Init_Singletons() {
+void Main_Init_Singletons( bool headless ) {
+	if( headless ) {
+		SETOPTION("options/sound/disable-audio", true);
+	}
+
 	Audio::Instance()->Initialize();
 	Audio::Instance()->SetMusicVol ( OPTION(float,"options/sound/musicvolume") );
 	Audio::Instance()->SetSoundVol ( OPTION(float,"options/sound/soundvolume") );
 
 	Timer::Initialize();
-	Video::Initialize();
+	Video::Initialize( headless );
+
+	// Images that were packed by atlas.py are drawn from the atlas pages
+	if( OPTION(bool, "options/video/atlas") ) {
+		Atlas::Load( ATLAS_MANIFEST );
+	}
 
 	SansSerif       = new Font( "data/fonts/FreeSans.ttf", 12 );
 	BitType         = new Font( "data/fonts/visitor2.ttf", 12 );
@@ -202,7 +237,16 @@ void Main_Init_Singletons() {
  *  \warn Do not run any non-trivial code after calling this.
  */
 void Main_Close_Singletons( void ) {
-	Options::Save();
+	// Headless runs must not change the player's options.
+	if( headlessTicks == 0 && benchmarkCSV.empty() ) {
+		Options::Save();
+	}
+
+	// List what is still referenced before anything is freed.
+	if( OPTION(int, "options/log/memory") ) {
+		MemoryReport report;
+		report.Dump( "Memory.log" );
+	}
 
 	// free the main font files
 	delete SansSerif;
@@ -244,12 +288,28 @@ void Main_Parse_Args( int argc, char **argv ) {
 	argparser->SetOpt(LONGOPT, "log-xml",        "Log messages to xml files.");
 	argparser->SetOpt(LONGOPT, "log-out",        "(Default) Log messages to console.");
 	argparser->SetOpt(LONGOPT, "nolog-out",      "Disable logging messages to console.");
+	argparser->SetOpt(LONGOPT, "log-memory",     "Write a memory report to Memory.log on exit.");
+	argparser->SetOpt(LONGOPT, "nolog-memory",   "(Default) Do not write a memory report on exit.");
 	argparser->SetOpt(VALUEOPT, "log-lvl",       "Logging level.(None,Fatal,Error,"
 	                                             "\n\t\t\t\tWarn,Info,Debug)");
 	argparser->SetOpt(VALUEOPT, "log-func",       "Filter log messages by function name.");
 	argparser->SetOpt(VALUEOPT, "log-msg",       "Filter log messages by string content.");
 
 	argparser->SetOpt(LONGOPT, "restore-defaults", "Restore options to default values.");
+	argparser->SetOpt(VALUEOPT, "spatial-index", "Sprite spatial index.(quadtree,grid)");
+	argparser->SetOpt(VALUEOPT, "update-threads", "Worker threads for the Sprite update.(0 is single threaded)");
+	argparser->SetOpt(VALUEOPT, "lua-shards", "Lua states that run the AI in parallel.(0 uses the main Lua state)");
+	argparser->SetOpt(VALUEOPT, "headless",      "Run this many ticks without video or audio,"
+	                                             "\n\t\t\t\tthen print the tick times.");
+	argparser->SetOpt(VALUEOPT, "scenario",      "Scenario for --headless and --benchmark.(main)");
+	argparser->SetOpt(VALUEOPT, "player",        "Player for --headless and --benchmark.(Headless)");
+	argparser->SetOpt(VALUEOPT, "benchmark",     "Write the scalability benchmark to this CSV file.");
+	argparser->SetOpt(VALUEOPT, "bench-sectors", "Sectors to generate for --benchmark.(16)");
+	argparser->SetOpt(VALUEOPT, "bench-planets", "Planets in each generated Sector.(4)");
+	argparser->SetOpt(VALUEOPT, "bench-ships",   "AI ship counts to measure."
+	                                             "\n\t\t\t\t(100,250,500,1000,2500,5000,10000)");
+	argparser->SetOpt(VALUEOPT, "bench-weapons", "Weapons to arm the AI ships with.(Laser,Minigun,Missile)");
+	argparser->SetOpt(VALUEOPT, "bench-ticks",   "Ticks measured at each ship count.(150)");
 
 #ifdef EPIAR_COMPILE_TESTS
 	argparser->SetOpt(VALUEOPT, "run-test",      "Run specified test");
@@ -301,6 +361,50 @@ void Main_Parse_Args( int argc, char **argv ) {
 	else if ( argparser->HaveOpt("nolog-xml") ) 	{ SETOPTION("options/log/xml", 0); }
 	if      ( argparser->HaveOpt("log-out") ) 	{ SETOPTION("options/log/out", 1); }
 	else if ( argparser->HaveOpt("nolog-out") ) 	{ SETOPTION("options/log/out", 0); }
+	if      ( argparser->HaveOpt("log-memory") ) 	{ SETOPTION("options/log/memory", 1); }
+	else if ( argparser->HaveOpt("nolog-memory") ) 	{ SETOPTION("options/log/memory", 0); }
+
+	string spatialindex = argparser->HaveValue("spatial-index");
+	if("" != spatialindex) SETOPTION("options/simulation/spatial-index", spatialindex);
+
+	string updatethreads = argparser->HaveValue("update-threads");
+	if("" != updatethreads) SETOPTION("options/simulation/update-threads", updatethreads);
+
+	string luashards = argparser->HaveValue("lua-shards");
+	if("" != luashards) SETOPTION("options/simulation/lua-shards", luashards);
+
+	string headless = argparser->HaveValue("headless");
+	if("" != headless) headlessTicks = max( 1, convertTo<int>( headless ) );
+
+	string scenario = argparser->HaveValue("scenario");
+	if("" != scenario) headlessScenario = scenario;
+
+	string player = argparser->HaveValue("player");
+	if("" != player) headlessPlayer = player;
+
+	string benchmark = argparser->HaveValue("benchmark");
+	if("" != benchmark) benchmarkCSV = benchmark;
+
+	string benchsectors = argparser->HaveValue("bench-sectors");
+	if("" != benchsectors) benchmarkParameters.sectors = max( 1, convertTo<int>( benchsectors ) );
+
+	string benchplanets = argparser->HaveValue("bench-planets");
+	if("" != benchplanets) benchmarkParameters.planetsPerSector = max( 0, convertTo<int>( benchplanets ) );
+
+	string benchships = argparser->HaveValue("bench-ships");
+	if("" != benchships) {
+		vector<string> counts = Benchmark::SplitList( benchships );
+		benchmarkParameters.shipCounts.clear();
+		for( unsigned int c = 0; c < counts.size(); c++ ) {
+			benchmarkParameters.shipCounts.push_back( max( 1, convertTo<int>( counts[c] ) ) );
+		}
+	}
+
+	string benchweapons = argparser->HaveValue("bench-weapons");
+	if("" != benchweapons) benchmarkParameters.weaponMix = Benchmark::SplitList( benchweapons );
+
+	string benchticks = argparser->HaveValue("bench-ticks");
+	if("" != benchticks) benchmarkParameters.ticks = max( 1, convertTo<int>( benchticks ) );
 
 	string funcfilt = argparser->HaveValue("log-func");
 	string msgfilt = argparser->HaveValue("log-msg");
@@ -326,3 +430,100 @@ void Main_Parse_Args( int argc, char **argv ) {
 	}
 }
 
+/** \details
+ *  Loads the --scenario and the --player, creating the Player if it does not
+ *  exist yet, for the runs that have no menu to choose them from.
+ *
+ *  \returns The Scenario, ready to run, or NULL if it could not be loaded.
+ */
+Scenario* Main_Load_Headless( void ) {
+	PlayerList *playerList = PlayerList::Instance();
+	playerList->Load( "saves/saved-games.xml", true, true );
+
+	// The Components look up each other through the Menu while they load.
+	Scenario *scenario = new Scenario();
+	Menu::SetCurrentScenario( scenario );
+
+	if( !scenario->Load( headlessScenario ) ) {
+		LogMsg(ERR, "Failed to load the scenario '%s'.", headlessScenario.c_str() );
+	} else if( !scenario->Initialize() ) {
+		LogMsg(ERR, "Failed to initialize the scenario '%s'.", headlessScenario.c_str() );
+	} else {
+		if( playerList->PlayerExists( headlessPlayer ) ) {
+			scenario->LoadPlayer( headlessPlayer );
+		} else {
+			scenario->CreateDefaultPlayer( headlessPlayer );
+		}
+
+		if( scenario->Setup() ) {
+			return( scenario );
+		}
+		LogMsg(ERR, "Failed to setup the scenario '%s'.", headlessScenario.c_str() );
+	}
+
+	Menu::SetCurrentScenario( NULL );
+	delete scenario;
+	return( NULL );
+}
+
+/** \details
+ *  Loads a Scenario and Player, then runs the simulation for --headless ticks
+ *  as fast as possible.  Nothing is drawn, no sound is played and no input is
+ *  read, so this works on machines without a display.
+ *
+ *  When it finishes, the distribution of tick times is printed.
+ *
+ *  \returns 0 if the Scenario ran, otherwise 1.
+ */
+int Main_Run_Headless( void ) {
+	Scenario *scenario = Main_Load_Headless();
+	if( scenario == NULL ) {
+		return( 1 );
+	}
+
+	TickStats stats;
+	scenario->RunHeadless( headlessTicks, &stats );
+	printf( "Scenario '%s' with %d sprites\n", headlessScenario.c_str(), scenario->GetSpriteManager()->GetNumSprites() );
+	stats.Print( "Tick time" );
+	Projectile::GetPool()->Print();
+	Effect::GetPool()->Print();
+
+	Menu::SetCurrentScenario( NULL );
+	delete scenario;
+	return( 0 );
+}
+
+/** \details
+ *  Adds a synthetic universe to the --scenario and measures the cost of each
+ *  part of a tick as more and more AI ships fly in it.  Like --headless,
+ *  nothing is drawn to a window.
+ *
+ *  One CSV row is written to the --benchmark file for every ship count.
+ *
+ *  \returns 0 if the benchmark ran, otherwise 1.
+ */
+int Main_Run_Benchmark( void ) {
+	FILE *csv = fopen( benchmarkCSV.c_str(), "w" );
+	if( csv == NULL ) {
+		LogMsg(ERR, "Could not open the benchmark file '%s'.", benchmarkCSV.c_str() );
+		return( 1 );
+	}
+
+	Scenario *scenario = Main_Load_Headless();
+	if( scenario == NULL ) {
+		fclose( csv );
+		return( 1 );
+	}
+
+	int result = 1;
+	Benchmark benchmark( scenario, benchmarkParameters );
+	if( benchmark.Generate() ) {
+		benchmark.Run( csv );
+		result = 0;
+	}
+
+	fclose( csv );
+	Menu::SetCurrentScenario( NULL );
+	delete scenario;
+	return( result );
+}
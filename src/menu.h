@@ -20,6 +20,7 @@ class Menu {
 	public:
 		static void Run( void );
 		static Scenario* GetCurrentScenario( void );
+		static void SetCurrentScenario( Scenario* _scenario ) { scenario = _scenario; }
 
 	private:
 		static bool quit;
@@ -13,6 +13,7 @@
 #include "sprites/player.h"
 #include "sprites/spritemanager.h"
 #include "utilities/lua.h"
+#include "utilities/luacost.h"
 #include "engine/scenario_lua.h"
 
 /** \addtogroup Sprites
@@ -36,13 +37,17 @@ AI::AI(string _name, string machine) :
 	this -> playerCheck = false;
 	target = 0;
 	merciful = 0;
+	lastPrimaryFire = FireSuccess;
+	lastSecondaryFire = FireSuccess;
 }
 
 /** \brief Run the Lua Statemachine to act and possibly change state.
  */
 
 void AI::Decide( lua_State *L ) {
-	string newstate;
+	// Lua keeps the returned state name alive until the stack is reset, so it
+	// is only copied into a string when the state actually changes.
+	const char *newstate;
 	// Decide
 	const int initialStackTop = lua_gettop(L);
 
@@ -52,6 +57,7 @@ void AI::Decide( lua_State *L ) {
 	if( ! lua_istable(L, machineIndex) )
 	{
 		LogMsg(ERR, "There is no State Machine named '%s'!", stateMachine.c_str() );
+		lua_settop(L, initialStackTop);
 		return; // This ship will just sit idle...
 	}
 
@@ -82,7 +88,10 @@ void AI::Decide( lua_State *L ) {
 
 	// Run the current AI state
 	//printf("Call:"); Lua::stackDump(L); // DEBUG
-	if( lua_pcall(L, 6, 1, 0) != 0)
+	LuaCostTimer cost( L );
+	int error = lua_pcall(L, 6, 1, 0);
+	cost.Stop( "AI", stateMachine, state );
+	if( error != 0 )
 	{
 		LogMsg(ERR,"Failed to run %s(%s): %s\n", stateMachine.c_str(), state.c_str(), lua_tostring(L, -1));
 		lua_settop(L, initialStackTop);
@@ -92,16 +101,18 @@ void AI::Decide( lua_State *L ) {
 
 	if( lua_isstring( L, lua_gettop(L) ) )
 	{
-		newstate = (string)luaL_checkstring(L, lua_gettop(L));
+		newstate = luaL_checkstring(L, lua_gettop(L));
 
 		// Verify that this new state exists
-		lua_pushstring(L, newstate.c_str() );
+		lua_pushvalue(L, lua_gettop(L) );
 		lua_gettable(L,machineIndex);
 		if( lua_isfunction(L, lua_gettop(L) ))
 		{
-			state = newstate;
+			if( state != newstate ) {
+				state = newstate;
+			}
 		} else {
-			LogMsg(ERR, "The State Machine '%s' has no state '%s'. Could not transition from '%s'. Resetting StateMachine.", stateMachine.c_str(), newstate.c_str(), state.c_str() );
+			LogMsg(ERR, "The State Machine '%s' has no state '%s'. Could not transition from '%s'. Resetting StateMachine.", stateMachine.c_str(), newstate, state.c_str() );
 			state = "default"; // Reset the state
 		}
 		//printf("Changing State:"); Lua::stackDump(L); // DEBUG
@@ -113,6 +124,10 @@ void AI::Decide( lua_State *L ) {
 
 /**\brief Updates the AI controlled ship by first calling the Lua function
  * and then calling Ship::Update()
+ * \details AI that are far from the camera and not fighting do not call the
+ *          Lua function every tick.
+ * \see ThinkScheduler
+ * \see AIShards
  */
 void AI::Update( lua_State *L ) {
 	//Update enemies
@@ -125,8 +140,12 @@ void AI::Update( lua_State *L ) {
 			RegisterTarget( L, t );
 		}
 	}
-	if( !this->IsDisabled() ) {
-		this->Decide( L );
+	// When the AI are sharded, the SpriteManager has already run the state machine.
+	if( !this->IsDisabled() && Scenario_Lua::GetScenario(L)->GetAIShards() == NULL ) {
+		ThinkScheduler *scheduler = Scenario_Lua::GetScenario(L)->GetSpriteManager()->GetThinkScheduler();
+		if( scheduler->ShouldThink( this, enemies.size() > 0 ) ) {
+			this->Decide( L );
+		}
 	}
 
 	// Now act like a normal ship
@@ -176,14 +195,15 @@ void AI::Draw(){
  */
 int AI::ChooseTarget( lua_State *L ){
 	SpriteManager *sprites = Scenario_Lua::GetScenario(L)->GetSpriteManager();
-	list<Sprite*> *nearbySprites = sprites->GetSpritesNear(this->GetWorldPosition(), COMBAT_RANGE, DRAW_ORDER_SHIP);
-	
-	nearbySprites->sort(CompareAI);
-	list<Sprite*>::iterator it;
+	nearbySprites.clear();
+	sprites->GetSpritesNear(this->GetWorldPosition(), COMBAT_RANGE, &nearbySprites, DRAW_ORDER_SHIP);
+
+	sort(nearbySprites.begin(), nearbySprites.end(), CompareAI);
+	vector<Sprite*>::iterator it;
 	list<enemy>::iterator enemyIt = enemies.begin();
 
 	for(enemyIt = enemies.begin(); enemyIt != enemies.end(); ) {
-		if(sprites->GetSpriteByID( enemyIt->id) == NULL) {
+		if(sprites->GetSprite( enemyIt->handle ) == NULL) {
 			enemyIt = enemies.erase(enemyIt);
 		}
 		else {
@@ -191,25 +211,26 @@ int AI::ChooseTarget( lua_State *L ){
 		}
 	}
 	
-	it = nearbySprites->begin();
 	enemyIt = enemies.begin();
 	int max = 0, currTarget =- 1;
 	int threat = 0;
-		
-	for(it = nearbySprites->begin(); it != nearbySprites->end() && enemyIt != enemies.end() ; it++) {
+
+	// The iterator is only advanced at the bottom of the loop so that a Ship can be checked again.
+	for(it = nearbySprites.begin(); it != nearbySprites.end() && enemyIt != enemies.end() ; ) {
 		if( (*it)->GetID()== this->GetID() ) {
+			++it;
 			continue;
 		}
 
 		if( (*it)->GetDrawOrder() == DRAW_ORDER_SHIP) {
 			if( enemyIt->id < ((AI*) (*it))->GetTarget() ){
 				while ( enemyIt!=enemies.end() && enemyIt->id < ( (AI*) (*it) )->GetTarget() ) {
-					if ( !InRange( sprites->GetSpriteByID(enemyIt->id)->GetWorldPosition() , this->GetWorldPosition() ) ) {
+					if ( !InRange( sprites->GetSprite(enemyIt->handle)->GetWorldPosition() , this->GetWorldPosition() ) ) {
 						enemyIt=enemies.erase(enemyIt);
 						threat=0;
 						continue;
 					}
-					int cost= CalcCost( threat + ( (Ship*)sprites->GetSpriteByID(enemyIt->id))->GetTotalCost() , enemyIt->damage); //damage might need to be scaled so that the damage can be adquately compared to the treat level
+					int cost= CalcCost( threat + ( (Ship*)sprites->GetSprite(enemyIt->handle))->GetTotalCost() , enemyIt->damage); //damage might need to be scaled so that the damage can be adquately compared to the treat level
 					if(currTarget==-1 || max<cost){
 						currTarget=enemyIt->id;
 						max=cost;
@@ -217,7 +238,6 @@ int AI::ChooseTarget( lua_State *L ){
 					threat = 0;
 					enemyIt++;
 				}
-				it--;
 				continue;
 			}
 			if( enemyIt->id == ((AI*) (*it))->GetTarget() )
@@ -225,17 +245,18 @@ int AI::ChooseTarget( lua_State *L ){
 		} else {
 			LogMsg( ERR, "Error Sprite %d is not an AI\n", (*it)->GetID() );
 		}
+		++it;
 	
 	}
 
 	while (enemyIt != enemies.end()) {
-		if ( !InRange( sprites->GetSpriteByID(enemyIt->id)->GetWorldPosition() , this->GetWorldPosition() ) ) {
+		if ( !InRange( sprites->GetSprite(enemyIt->handle)->GetWorldPosition() , this->GetWorldPosition() ) ) {
 			enemyIt = enemies.erase(enemyIt);
 			threat = 0;
 			continue;
 		}
 
-		int cost= CalcCost( threat + ( (Ship*)sprites->GetSpriteByID(enemyIt->id))->GetTotalCost() , enemyIt->damage); //damage might need to be scaled so that the damage can be adquately compared to the treat level
+		int cost= CalcCost( threat + ( (Ship*)sprites->GetSprite(enemyIt->handle))->GetTotalCost() , enemyIt->damage); //damage might need to be scaled so that the damage can be adquately compared to the treat level
 		threat = 0;
 		if( currTarget == -1 || max < cost) {
 			max = cost;
@@ -289,6 +310,7 @@ void AI::AddEnemy(int spriteID, int damage) {
 	enemy newE;
 	newE.id = spriteID;
 	newE.damage = damage;
+	newE.handle = spr->GetHandle();
 
 	// Search the enemies list for this sprite, combine damage taken if found.
 	list<enemy>::iterator it = lower_bound(enemies.begin() , enemies.end(), newE, AI::EnemyComp);
@@ -40,6 +40,8 @@ class AI : public Ship {
 		string GetState() { return state; }
 		void SetState(string _state)  { state = _state; }
 
+		void Decide( lua_State *L );
+
 		// Combat Mechanics:
 
 		void SetTarget(int t);
@@ -47,13 +49,22 @@ class AI : public Ship {
 
 		void AddEnemy(int spriteID, int damage);
 		void RemoveEnemy(int spriteID);
+		bool IsInCombat() { return !enemies.empty(); }
 
 		void SetMerciful(int f) { merciful = (f == 1); }
 		int GetMerciful() { return (merciful ? 1 : 0 ); }
 
 		void Killed( lua_State *L );
 
+		// Sharded Lua Mechanics:
+
+		FireStatus GetLastPrimaryFire() { return lastPrimaryFire; }
+		FireStatus GetLastSecondaryFire() { return lastSecondaryFire; }
+
 	private:
+		friend class AIShard;
+		friend class AIShards;
+
 		string name; ///< The AI's name.  This should be the name of the ship's pilot.
 		Alliance* allegiance; ///< Which Alliance this ship hails to.
 
@@ -61,18 +72,21 @@ class AI : public Ship {
 		// The state machine is essentially a flow chart
 		string stateMachine; ///< The name of the State Machine.
 		string state; ///< The current state of the state machine.
-		void Decide( lua_State *L );
 
 		// AI Combat Mechanics:
 
 		typedef struct {
 			int damage; ///< Damage received by this ship
 			int id; ///< The enemy ship's unique id
+			SpriteHandle handle; ///< The enemy ship's handle, for quick lookups
 		} enemy; ///< Simple tracker for how much damage has been taken from other ships
 
 		int target; ///< The enemy that this AI is currently fighting
 		bool merciful; ///< Is this ship merciful to the player?
 		list<enemy> enemies; ///< A list of combatants.  The AI should keep fighting until everything on this list is dead.
+		vector<Sprite*> nearbySprites; ///< The Ships near this AI.  Kept between ticks to avoid reallocating.
+		FireStatus lastPrimaryFire; ///< The result of the last primary shot asked for by an AIShard.
+		FireStatus lastSecondaryFire; ///< The result of the last secondary shot asked for by an AIShard.
 
 		int CalcCost(int threat, int damage);
 		int ChooseTarget( lua_State *L );
@@ -14,6 +14,7 @@
 #include "sprites/planets.h"
 #include "sprites/planets_lua.h"
 #include "sprites/ai_lua.h"
+#include "sprites/ai_shards.h"
 #include "audio/sound.h"
 #include "engine/camera.h"
 #include "utilities/trig.h"
@@ -144,10 +145,17 @@ void AI_Lua::RegisterAI(lua_State *L){
 /**\brief Validates Ship in Lua.
  */
 AI* AI_Lua::checkShip(lua_State *L, int index){
-	int* idptr = (int*)luaL_checkudata(L, index, EPIAR_SHIP);
-	luaL_argcheck(L, idptr != NULL, index, "`EPIAR_SHIP' expected");
+	SpriteReference* ref = (SpriteReference*)luaL_checkudata(L, index, EPIAR_SHIP);
+	luaL_argcheck(L, ref != NULL, index, "`EPIAR_SHIP' expected");
 	Sprite* s;
-	s = Scenario_Lua::GetScenario(L)->GetSpriteManager()->GetSpriteByID(*idptr);
+	SpriteManager *sprites = Scenario_Lua::GetScenario(L)->GetSpriteManager();
+	s = sprites->GetSprite( ref->handle );
+	if( s == NULL ) {
+		// The handle is null or stale if this Ship was pushed before it was
+		// added to the SpriteManager or if it has been removed and re-added.
+		s = sprites->GetSpriteByID( ref->id );
+		if( s != NULL ) ref->handle = s->GetHandle();
+	}
 	/*
 	if ((s) == NULL) luaL_typerror(L, index, EPIAR_SHIP);
 	if (0==((s)->GetDrawOrder() & DRAW_ORDER_SHIP|DRAW_ORDER_PLAYER)){
@@ -213,7 +221,15 @@ int AI_Lua::ShipAccelerate(lua_State* L) {
 		AI* ai = checkShip(L,1);
 		if(ai==NULL) return 0;
 		luaL_argcheck(L, ai != NULL, 1, "`array' expected");
-		(ai)->Accelerate( false );
+		AIShard *shard = AIShard::Get(L);
+		if( shard != NULL ) {
+			AICommand command;
+			command.kind = AICommand::ACCELERATE;
+			command.ship = ai->GetHandle();
+			shard->Record( command );
+		} else {
+			(ai)->Accelerate( false );
+		}
 	}
 	else
 		luaL_error(L, "Got %d arguments expected 2 (self, direction)", n);
@@ -231,7 +247,16 @@ int AI_Lua::ShipRotate(lua_State* L) {
 		AI* ai = checkShip(L,1);
 		if(ai==NULL) return 0;
 		float dir = static_cast<float>( luaL_checknumber(L, 2) );
-		(ai)->Rotate(dir, false);
+		AIShard *shard = AIShard::Get(L);
+		if( shard != NULL ) {
+			AICommand command;
+			command.kind = AICommand::ROTATE;
+			command.ship = ai->GetHandle();
+			command.direction = dir;
+			shard->Record( command );
+		} else {
+			(ai)->Rotate(dir, false);
+		}
 	}
 	else
 		luaL_error(L, "Got %d arguments expected 2 (self, direction)", n);
@@ -273,7 +298,19 @@ int AI_Lua::ShipFirePrimary(lua_State* L){
 		{
 			target = luaL_checkinteger(L,2);
 		}
-		FireStatus result = (ai)->FirePrimary(target);
+		FireStatus result;
+		AIShard *shard = AIShard::Get(L);
+		if( shard != NULL ) {
+			// The shot is fired after the shard finishes, so report the last one.
+			AICommand command;
+			command.kind = AICommand::FIRE_PRIMARY;
+			command.ship = ai->GetHandle();
+			command.target = target;
+			shard->Record( command );
+			result = (ai)->GetLastPrimaryFire();
+		} else {
+			result = (ai)->FirePrimary(target);
+		}
 		lua_pushinteger(L, (int)(result) );
 		return 1;
 	}
@@ -294,7 +331,19 @@ int AI_Lua::ShipFireSecondary(lua_State* L){
 		{
 			target = luaL_checkinteger(L,2);
 		}
-		FireStatus result = (ai)->FireSecondary(target);
+		FireStatus result;
+		AIShard *shard = AIShard::Get(L);
+		if( shard != NULL ) {
+			// The shot is fired after the shard finishes, so report the last one.
+			AICommand command;
+			command.kind = AICommand::FIRE_SECONDARY;
+			command.ship = ai->GetHandle();
+			command.target = target;
+			shard->Record( command );
+			result = (ai)->GetLastSecondaryFire();
+		} else {
+			result = (ai)->FireSecondary(target);
+		}
 		lua_pushinteger(L, (int)(result) );
 		return 1;
 	}
@@ -841,7 +890,16 @@ int AI_Lua::ShipSetName(lua_State* L){
 		AI* ai = checkShip(L,1);
 		if(ai==NULL) return 0;
 		string newName = luaL_checkstring (L, 2);
-		(ai)->SetName( newName );
+		AIShard *shard = AIShard::Get(L);
+		if( shard != NULL ) {
+			AICommand command;
+			command.kind = AICommand::SET_NAME;
+			command.ship = ai->GetHandle();
+			command.text = newName;
+			shard->Record( command );
+		} else {
+			(ai)->SetName( newName );
+		}
 	} else {
 		luaL_error(L, "Got %d arguments expected 2 (ship, newName)", n);
 	}
@@ -1687,7 +1745,18 @@ int AI_Lua::PlayerAddHiredEscort(lua_State* L){
                 string type = luaL_checkstring (L, 2);
                 int pay = luaL_checkint (L, 3);
                 int spriteID = luaL_checkint (L, 4);
-                (p)->AddHiredEscort(type, pay, spriteID);
+                AIShard *shard = AIShard::Get(L);
+                if( shard != NULL ) {
+                        AICommand command;
+                        command.kind = AICommand::HIRE_ESCORT;
+                        command.ship = p->GetHandle();
+                        command.text = type;
+                        command.pay = pay;
+                        command.target = spriteID;
+                        shard->Record( command );
+                } else {
+                        (p)->AddHiredEscort(type, pay, spriteID);
+                }
         } else {
                 luaL_error(L, "Got %d arguments expected 4 (player, type, pay, spriteID)", n);
         }
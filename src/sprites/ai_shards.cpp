@@ -0,0 +1,512 @@
+/**\file			ai_shards.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Runs the AI state machines in several Lua states at once
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "sprites/ai.h"
+#include "sprites/ai_lua.h"
+#include "sprites/ai_shards.h"
+#include "sprites/planets_lua.h"
+#include "sprites/player.h"
+#include "sprites/spritemanager.h"
+#include "engine/scenario.h"
+#include "engine/scenario_lua.h"
+#include "utilities/log.h"
+#include "utilities/luacost.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+// Tables nested deeper than this are not copied.  This also stops cycles.
+#define LUAVALUE_MAX_DEPTH 16
+
+/**\class AIShards
+ * \brief Runs the AI state machines on worker threads.
+ * \details
+ * A lua_State can only be used by one thread at a time, so the AI state
+ * machines normally run one after the other on the main thread.  When
+ * "options/simulation/lua-shards" is more than zero, the AI are instead split
+ * between that many AIShard, each with its own lua_State that has loaded
+ * utilities.lua, ai.lua and fleet.lua.  An AI always belongs to the shard
+ * numbered its ID modulo the number of shards.
+ *
+ * Each tick the SpriteManager Assigns every AI that should think, and Think
+ * runs every shard at once, one shard per thread.  While they think, the
+ * shards may look at any Sprite but must not change one.  Rotate, Accelerate,
+ * FirePrimary, FireSecondary, SetName and AddHiredEscort are recorded as
+ * AICommand instead, and are applied by the main thread in shard order once
+ * every shard has finished.  The other Ship setters raise a Lua error.
+ *
+ * Since the commands are applied later, FirePrimary and FireSecondary return
+ * the result of the previous shot rather than this one.
+ *
+ * How the Lua data is kept in sync:
+ * - AIData belongs to the shards.  AIData[id] is only correct in the shard
+ *   that owns id.  The main Lua state keeps its own AIData, which holds only
+ *   what the main state has written.
+ * - Fleets is copied into every shard.  Changes made by the main state are
+ *   sent to every shard with AIShards.broadcast.
+ * - The main state changes the AIData in a shard by calling
+ *   AIShards.post(id, "function", ...).  The function is run in the shard that
+ *   owns id, before it next thinks.  setAccompany, setHuntHostile, setAIData
+ *   and the Fleet orders do this for you.
+ * - Messages may only carry nil, booleans, numbers, strings and tables of
+ *   those.  The shards cannot send messages.
+ *
+ * \see AIShard
+ * \see SpriteManager::Update
+ */
+
+/**\brief Create each shard and its worker thread.
+ * \param count The number of shards.
+ */
+AIShards::AIShards( Scenario *scenario, int count ) {
+	this->scenario = scenario;
+
+	for( int s = 0; s < count; s++ ) {
+		AIShard *shard = new AIShard( scenario, s );
+		if( !shard->IsLoaded() ) {
+			LogMsg(ERR, "AI shard %d could not be started.", s );
+			delete shard;
+			break;
+		}
+		shards.push_back( shard );
+	}
+
+	jobs = new JobSystem( shards.size() > 1 ? shards.size() - 1 : 0 );
+
+	LogMsg(INFO, "Running the AI in %d Lua states.", static_cast<int>( shards.size() ) );
+}
+
+/**\brief Stop the worker threads and close every shard.
+ */
+AIShards::~AIShards() {
+	delete jobs;
+	for( unsigned int s = 0; s < shards.size(); s++ ) {
+		delete shards[s];
+	}
+	shards.clear();
+}
+
+/**\brief Queue an AI to think during the next Think.
+ */
+void AIShards::Assign( AI *ai ) {
+	GetOwner( ai->GetID() )->thinkers.push_back( ai );
+}
+
+// Runs the shards, one per thread.
+class AIShardJob : public Job {
+	public:
+		AIShardJob( vector<AIShard*> *_shards ) : shards(_shards) {}
+		void Run( int begin, int end ) {
+			for( int s = begin; s < end; s++ ) {
+				(*shards)[s]->Think();
+			}
+		}
+	private:
+		vector<AIShard*> *shards;
+};
+
+/**\brief Run the state machines of every Assigned AI, then apply what they decided.
+ * \param player The Player Sprite, or NULL.  This is PLAYER in the shards.
+ */
+void AIShards::Think( Sprite *player ) {
+	int playerID = ( player != NULL ) ? player->GetID() : -1;
+	for( unsigned int s = 0; s < shards.size(); s++ ) {
+		AIShard *shard = shards[s];
+		if( shard->playerID != playerID ) {
+			if( player != NULL ) {
+				Scenario_Lua::PushSprite( shard->L, player );
+			} else {
+				lua_pushnil( shard->L );
+			}
+			lua_setglobal( shard->L, "PLAYER" );
+			shard->playerID = playerID;
+		}
+	}
+
+	AIShardJob job( &shards );
+	jobs->ParallelFor( shards.size(), 1, &job );
+
+	for( unsigned int s = 0; s < shards.size(); s++ ) {
+		vector<AICommand> &commands = shards[s]->commands;
+		for( unsigned int c = 0; c < commands.size(); c++ ) {
+			Apply( commands[c] );
+		}
+		commands.clear();
+	}
+}
+
+/**\brief Send a call to the shard that owns an AI.
+ */
+void AIShards::Post( int id, const AIMessage &message ) {
+	GetOwner( id )->inbox.push_back( message );
+}
+
+/**\brief Send a call to every shard.
+ */
+void AIShards::Broadcast( const AIMessage &message ) {
+	for( unsigned int s = 0; s < shards.size(); s++ ) {
+		shards[s]->inbox.push_back( message );
+	}
+}
+
+/**\brief Make the change that a shard asked for.
+ */
+void AIShards::Apply( const AICommand &command ) {
+	Sprite *sprite = scenario->GetSpriteManager()->GetSprite( command.ship );
+	if( sprite == NULL ) {
+		return; // The Ship was destroyed after the shard looked at it.
+	}
+	AI *ai = (AI*)sprite;
+
+	switch( command.kind ) {
+		case AICommand::ROTATE:
+			ai->Rotate( command.direction, false );
+			break;
+		case AICommand::ACCELERATE:
+			ai->Accelerate( false );
+			break;
+		case AICommand::FIRE_PRIMARY:
+			ai->lastPrimaryFire = ai->FirePrimary( command.target );
+			break;
+		case AICommand::FIRE_SECONDARY:
+			ai->lastSecondaryFire = ai->FireSecondary( command.target );
+			break;
+		case AICommand::SET_NAME:
+			ai->SetName( command.text );
+			break;
+		case AICommand::HIRE_ESCORT:
+			if( sprite->GetDrawOrder() == DRAW_ORDER_PLAYER ) {
+				((Player*)sprite)->AddHiredEscort( command.text, command.pay, command.target );
+			}
+			break;
+	}
+}
+
+/**\brief Register the AIShards functions.
+ * \details These are registered in the main Lua state and in every shard.
+ *          When the AI are not sharded, post and broadcast do nothing.
+ */
+void AIShards::RegisterAIShards( lua_State *L ) {
+	static const luaL_Reg shardFunctions[] = {
+		{"count", &AIShards::LuaCount},
+		{"isShard", &AIShards::LuaIsShard},
+		{"post", &AIShards::LuaPost},
+		{"broadcast", &AIShards::LuaBroadcast},
+		{NULL, NULL}
+	};
+
+	luaL_openlib(L, "AIShards", shardFunctions, 0);
+	lua_pop(L, 1);
+}
+
+/**\brief Read a function name and its arguments from the Lua stack.
+ * \param first The index of the function name.
+ */
+bool AIShards::ReadMessage( lua_State *L, int first, AIMessage *message ) {
+	int n = lua_gettop(L);
+	message->function = luaL_checkstring(L, first);
+	message->arguments.resize( n - first );
+	for( int a = first + 1; a <= n; a++ ) {
+		if( !message->arguments[a - first - 1].Read( L, a ) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**\brief Lua callable function to get the number of AI shards.
+ * \returns 0 when the AI are not sharded.
+ */
+int AIShards::LuaCount( lua_State *L ) {
+	AIShards *shards = Scenario_Lua::GetScenario(L)->GetAIShards();
+	lua_pushinteger(L, ( shards != NULL ) ? shards->GetCount() : 0 );
+	return 1;
+}
+
+/**\brief Lua callable function to check whether this Lua state is an AI shard.
+ */
+int AIShards::LuaIsShard( lua_State *L ) {
+	lua_pushboolean(L, AIShard::Get(L) != NULL );
+	return 1;
+}
+
+/**\brief Lua callable function to run a function in the shard that owns an AI.
+ * \details AIShards.post(id, "function", ...)
+ */
+int AIShards::LuaPost( lua_State *L ) {
+	int n = lua_gettop(L);
+	if( n < 2 ) {
+		return luaL_error(L, "Got %d arguments expected at least 2 (id, function, ...)", n);
+	}
+	int id = luaL_checkinteger(L, 1);
+
+	AIShards *shards = Scenario_Lua::GetScenario(L)->GetAIShards();
+	if( shards == NULL || AIShard::Get(L) != NULL ) {
+		return 0;
+	}
+
+	AIMessage message;
+	if( !ReadMessage( L, 2, &message ) ) {
+		return luaL_error(L, "Only nil, booleans, numbers, strings and tables can be sent to an AI shard.");
+	}
+	shards->Post( id, message );
+	return 0;
+}
+
+/**\brief Lua callable function to run a function in every shard.
+ * \details AIShards.broadcast("function", ...)
+ */
+int AIShards::LuaBroadcast( lua_State *L ) {
+	int n = lua_gettop(L);
+	if( n < 1 ) {
+		return luaL_error(L, "Got %d arguments expected at least 1 (function, ...)", n);
+	}
+
+	AIShards *shards = Scenario_Lua::GetScenario(L)->GetAIShards();
+	if( shards == NULL || AIShard::Get(L) != NULL ) {
+		return 0;
+	}
+
+	AIMessage message;
+	if( !ReadMessage( L, 1, &message ) ) {
+		return luaL_error(L, "Only nil, booleans, numbers, strings and tables can be sent to an AI shard.");
+	}
+	shards->Broadcast( message );
+	return 0;
+}
+
+/**\class AIShard
+ * \brief One of the Lua states that run the AI.
+ * \see AIShards
+ */
+
+/**\brief Create the Lua state and load the AI scripts into it.
+ * \param number Which shard this is.
+ */
+AIShard::AIShard( Scenario *scenario, int number ) {
+	this->number = number;
+	loaded = false;
+	playerID = -1;
+
+	L = lua_open();
+	if( L == NULL ) {
+		LogMsg(ERR, "Could not initialize the Lua VM for AI shard %d.", number );
+		return;
+	}
+	LuaCost::Attach( L );
+	luaL_openlibs( L );
+
+	lua_pushstring(L, "EPIAR_AISHARD");
+	lua_pushlightuserdata(L, this);
+	lua_settable(L, LUA_REGISTRYINDEX);
+
+	Scenario_Lua::StoreScenario( L, scenario );
+	Scenario_Lua::RegisterScenario( L );
+	Planets_Lua::RegisterPlanets( L );
+	AI_Lua::RegisterAI( L );
+	AIShards::RegisterAIShards( L );
+
+	// Anything that changes a Ship, other than the recorded commands, may not be called while thinking.
+	static const char *forbidden[] = {
+		"SetRadarColor", "Damage", "Repair", "Explode", "Remove", "Land", "SetLuaControlFunc",
+		"SetShieldBooster", "SetEngineBooster", "SetDamageBooster",
+		"AddWeapon", "AddToWeaponList", "RemoveWeapon", "RemoveFromWeaponList", "AddAmmo",
+		"SetModel", "SetEngine", "AddOutfit", "RemoveOutfit", "SetCredits",
+		"StoreCommodities", "DiscardCommodities", "AcceptMission", "RejectMission",
+		"SetMerciful", "UpdateFavor", "SetStateMachine", "SetHullDamage", "SetShieldDamage",
+		"SetWeaponSlotStatus", "SetWeaponSlotFG", "SetTarget",
+		NULL
+	};
+	luaL_getmetatable(L, EPIAR_SHIP);
+	for( int f = 0; forbidden[f] != NULL; f++ ) {
+		lua_pushstring(L, forbidden[f]);
+		lua_pushfstring(L, "Ship:%s", forbidden[f]);
+		lua_pushcclosure(L, &AIShard::Forbidden, 1);
+		lua_settable(L, -3);
+	}
+	lua_pop(L, 1);
+
+	lua_getglobal(L, EPIAR_SHIP);
+	lua_pushstring(L, "new");
+	lua_pushstring(L, "Ship.new");
+	lua_pushcclosure(L, &AIShard::Forbidden, 1);
+	lua_settable(L, -3);
+	lua_pop(L, 1);
+
+	// Fleet orders build each member's autopilot with APInit.  The player's own
+	// Autopilot stays in the main Lua state, so it is always nil in a shard.
+	loaded = Lua::Load( L, "data/scripts/utilities.lua" )
+	      && Lua::Load( L, "data/scripts/autopilot.lua" )
+	      && Lua::Load( L, "data/scripts/ai.lua" )
+	      && Lua::Load( L, "data/scripts/fleet.lua" );
+
+	// Give each shard its own random numbers.
+	lua_getglobal(L, "math");
+	lua_getfield(L, -1, "randomseed");
+	lua_pushinteger(L, static_cast<lua_Integer>( time(NULL) ) + number );
+	lua_call(L, 1, 0);
+	lua_pop(L, 1);
+}
+
+/**\brief Close the Lua state.
+ */
+AIShard::~AIShard() {
+	if( L != NULL ) {
+		LuaCost::Detach( L );
+		lua_close( L );
+		L = NULL;
+	}
+}
+
+/**\brief Find the shard that owns a Lua state.
+ * \returns NULL for the main Lua state.
+ */
+AIShard *AIShard::Get( lua_State *L ) {
+	lua_pushstring(L, "EPIAR_AISHARD");
+	lua_gettable(L, LUA_REGISTRYINDEX);
+	AIShard *shard = static_cast<AIShard*>( lua_touserdata(L, -1) );
+	lua_pop(L, 1);
+	return shard;
+}
+
+/**\brief Run the messages, then the state machine of each AI.
+ * \details This runs on a worker thread.
+ */
+void AIShard::Think( void ) {
+	for( unsigned int m = 0; m < inbox.size(); m++ ) {
+		Deliver( inbox[m] );
+	}
+	inbox.clear();
+
+	for( unsigned int a = 0; a < thinkers.size(); a++ ) {
+		thinkers[a]->Decide( L );
+	}
+	thinkers.clear();
+}
+
+/**\brief Call the function named by a message.
+ */
+void AIShard::Deliver( const AIMessage &message ) {
+	const int initialStackTop = lua_gettop(L);
+	const string &name = message.function;
+	size_t split = name.find_first_of( ":." );
+	int self = 0;
+
+	if( split == string::npos ) {
+		lua_getglobal(L, name.c_str() );
+	} else {
+		lua_getglobal(L, name.substr( 0, split ).c_str() );
+		if( !lua_istable(L, -1) ) {
+			LogMsg(ERR, "AI shard %d has no table for '%s'.", number, name.c_str() );
+			lua_settop(L, initialStackTop);
+			return;
+		}
+		lua_getfield(L, -1, name.substr( split + 1 ).c_str() );
+		if( name[split] == ':' ) {
+			lua_pushvalue(L, -2);
+			self = 1;
+		}
+	}
+
+	if( !lua_isfunction(L, -1 - self) ) {
+		LogMsg(ERR, "AI shard %d has no function '%s'.", number, name.c_str() );
+		lua_settop(L, initialStackTop);
+		return;
+	}
+
+	for( unsigned int a = 0; a < message.arguments.size(); a++ ) {
+		message.arguments[a].Push( L );
+	}
+	if( lua_pcall(L, self + message.arguments.size(), 0, 0) != 0 ) {
+		LogMsg(ERR, "AI shard %d failed to run '%s': %s", number, name.c_str(), lua_tostring(L, -1) );
+	}
+	lua_settop(L, initialStackTop);
+}
+
+/**\brief Raises a Lua error for a function that a shard may not call.
+ */
+int AIShard::Forbidden( lua_State *L ) {
+	return luaL_error(L, "%s cannot be called by a sharded AI.", lua_tostring(L, lua_upvalueindex(1)) );
+}
+
+/**\class LuaValue
+ * \brief A copy of a plain Lua value.
+ */
+
+/**\brief Copy the value at a stack index.
+ * \returns false if the value, or something in it, cannot be copied.
+ */
+bool LuaValue::Read( lua_State *L, int index, int depth ) {
+	if( index < 0 ) {
+		index = lua_gettop(L) + index + 1;
+	}
+	type = lua_type(L, index);
+
+	switch( type ) {
+		case LUA_TNIL:
+			return true;
+		case LUA_TBOOLEAN:
+			number = lua_toboolean(L, index);
+			return true;
+		case LUA_TNUMBER:
+			number = lua_tonumber(L, index);
+			return true;
+		case LUA_TSTRING:
+			text = lua_tostring(L, index);
+			return true;
+		case LUA_TTABLE:
+			if( depth >= LUAVALUE_MAX_DEPTH ) {
+				return false;
+			}
+			lua_pushnil(L);
+			while( lua_next(L, index) != 0 ) {
+				keys.push_back( LuaValue() );
+				values.push_back( LuaValue() );
+				if( !keys.back().Read( L, -2, depth + 1 ) || !values.back().Read( L, -1, depth + 1 ) ) {
+					lua_pop(L, 2);
+					return false;
+				}
+				lua_pop(L, 1);
+			}
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**\brief Push a new copy of this value.
+ */
+void LuaValue::Push( lua_State *L ) const {
+	switch( type ) {
+		case LUA_TBOOLEAN:
+			lua_pushboolean(L, number != 0.0 );
+			break;
+		case LUA_TNUMBER:
+			lua_pushnumber(L, number );
+			break;
+		case LUA_TSTRING:
+			lua_pushlstring(L, text.c_str(), text.size() );
+			break;
+		case LUA_TTABLE:
+			lua_createtable(L, 0, keys.size() );
+			for( unsigned int f = 0; f < keys.size(); f++ ) {
+				keys[f].Push( L );
+				values[f].Push( L );
+				lua_settable(L, -3);
+			}
+			break;
+		default:
+			lua_pushnil(L);
+			break;
+	}
+}
+
+/** @} */
@@ -0,0 +1,118 @@
+/**\file			ai_shards.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Runs the AI state machines in several Lua states at once
+ * \details
+ */
+
+#ifndef __H_AI_SHARDS__
+#define __H_AI_SHARDS__
+
+#include "includes.h"
+#include "sprites/spritehandle.h"
+#include "utilities/jobsystem.h"
+#include "utilities/lua.h"
+
+class AI;
+class Scenario;
+class Sprite;
+
+// A nil, boolean, number, string or table of these, copied out of one lua_State so that it can be pushed into another.
+class LuaValue {
+	public:
+		LuaValue() : type(LUA_TNIL), number(0.0) {}
+
+		bool Read( lua_State *L, int index, int depth = 0 );
+		void Push( lua_State *L ) const;
+
+	private:
+		int type;                ///< The Lua type.
+		double number;           ///< LUA_TNUMBER, or LUA_TBOOLEAN as 0 or 1.
+		string text;             ///< LUA_TSTRING.
+		vector<LuaValue> keys;   ///< LUA_TTABLE keys.
+		vector<LuaValue> values; ///< LUA_TTABLE values, in the same order as the keys.
+};
+
+// A Lua function call sent from the main Lua state to a shard.
+struct AIMessage {
+	string function;            ///< A global function, or a "Table:method" or "Table.function".
+	vector<LuaValue> arguments;
+};
+
+// A change to a Ship that a shard asked for.  These are applied by the main thread.
+struct AICommand {
+	enum Kind { ROTATE, ACCELERATE, FIRE_PRIMARY, FIRE_SECONDARY, SET_NAME, HIRE_ESCORT };
+
+	AICommand() : kind(ACCELERATE), direction(0.0f), target(-1), pay(0) {}
+
+	Kind kind;
+	SpriteHandle ship;
+	float direction;   ///< ROTATE
+	int target;        ///< FIRE_PRIMARY and FIRE_SECONDARY target, HIRE_ESCORT escort ID
+	int pay;           ///< HIRE_ESCORT
+	string text;       ///< SET_NAME name, HIRE_ESCORT type
+};
+
+class AIShard {
+	public:
+		AIShard( Scenario *scenario, int number );
+		~AIShard();
+
+		bool IsLoaded( void ) { return loaded; }
+
+		static AIShard *Get( lua_State *L );
+
+		// Called by AI_Lua instead of changing the Ship.
+		void Record( const AICommand &command ) { commands.push_back( command ); }
+
+	private:
+		friend class AIShards;
+		friend class AIShardJob;
+
+		void Think( void );
+		void Deliver( const AIMessage &message );
+
+		static int Forbidden( lua_State *L );
+
+		lua_State *L;
+		bool loaded;
+		int number;                 ///< Which shard this is.
+		int playerID;               ///< The Player that PLAYER refers to, or -1.
+
+		vector<AI*> thinkers;       ///< The AI that think this tick.
+		vector<AIMessage> inbox;    ///< Calls to run before thinking.
+		vector<AICommand> commands; ///< Changes recorded while thinking.
+};
+
+class AIShards {
+	public:
+		AIShards( Scenario *scenario, int count );
+		~AIShards();
+
+		int GetCount( void ) { return shards.size(); }
+		AIShard *GetOwner( int id ) { return shards[ id % shards.size() ]; }
+
+		void Assign( AI *ai );
+		void Think( Sprite *player );
+
+		void Post( int id, const AIMessage &message );
+		void Broadcast( const AIMessage &message );
+
+		static void RegisterAIShards( lua_State *L );
+
+	private:
+		static bool ReadMessage( lua_State *L, int first, AIMessage *message );
+		static int LuaCount( lua_State *L );
+		static int LuaIsShard( lua_State *L );
+		static int LuaPost( lua_State *L );
+		static int LuaBroadcast( lua_State *L );
+
+		void Apply( const AICommand &command );
+
+		Scenario *scenario;
+		vector<AIShard*> shards;
+		JobSystem *jobs;            ///< One thread per shard, counting the main thread.
+};
+
+#endif // __H_AI_SHARDS__
@@ -20,28 +20,38 @@
 
 /**\class Effect
  * \brief Various Animation effects.
+ * \details Effects are created with new and deleted by the SpriteManager like
+ *          any other Sprite, but their memory comes from a SpritePool.
  */
 
+SpritePool Effect::pool( "Effect", sizeof(Effect) );
+
 /**\brief Creates a new Effect at specified coordinate with Animation file
  */
-Effect::Effect(Coordinate pos, string filename, float loopPercent) {
+Effect::Effect(Coordinate pos, string filename, float loopPercent) :
+	visual( filename )
+{
 	SetWorldPosition(pos);
-	visual = new Animation(filename);
-	visual->SetLoopPercent( loopPercent );
+	visual.SetLoopPercent( loopPercent );
 }
 
 /**\brief Destroy an Effect
  */
 Effect::~Effect() {
-	delete visual;
 }
 
 /**\brief Updates the Effect
  */
 void Effect::Update( lua_State *L ) {
-	Sprite::Update( L );
-	if( visual->Update() == true ) {
-		SpriteManager *sprites = Scenario_Lua::GetScenario(L)->GetSpriteManager();
+	UpdateWithoutLua( Scenario_Lua::GetScenario(L)->GetSpriteManager() );
+}
+
+/**\brief Updates the Effect without touching Lua.
+ * \details This may run on a worker thread, so it only changes this Effect.
+ */
+void Effect::UpdateWithoutLua( SpriteManager *sprites ) {
+	Sprite::Update( NULL );
+	if( visual.Update() == true ) {
 		sprites->Delete( (Sprite*)this );
 	}
 }
@@ -50,7 +60,7 @@ void Effect::Update( lua_State *L ) {
  */
 void Effect::Draw( void ) {
 	Coordinate pos = GetScreenPosition();
-	visual->Draw( pos.GetX(), pos.GetY(), this->GetAngle());
+	visual.Queue( GetRenderLayer(), GetID(), pos.GetX(), pos.GetY(), this->GetAngle());
 }
 
 /**\fn Effect::GetDrawOrder( )
@@ -12,6 +12,7 @@
 
 #include "graphics/animation.h"
 #include "sprites/sprite.h"
+#include "sprites/spritepool.h"
 #include "graphics/image.h"
 #include "includes.h"
 
@@ -20,12 +21,20 @@ class Effect : public Sprite {
 		Effect(Coordinate pos, string filename, float loopPercent);
 		~Effect();
 		void Update( lua_State *L );
+		bool NeedsLua( void ) { return false; }
+		void UpdateWithoutLua( SpriteManager *sprites );
 		void Draw(void);
 		virtual int GetDrawOrder( void ) {
 			return( DRAW_ORDER_EFFECT);
 		}
+
+		static void* operator new( size_t size ) { return pool.Allocate( size ); }
+		static void operator delete( void *p ) { pool.Free( p ); }
+		static SpritePool* GetPool( void ) { return &pool; }
 	private:
-		Animation *visual;
+		static SpritePool pool; ///< Every Effect is kept here.
+
+		Animation visual;
 };
 
 #endif // __H_EFFECT__
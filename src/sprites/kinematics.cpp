@@ -0,0 +1,204 @@
+/**\file			kinematics.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Structure of arrays storage for Sprite positions and momentum
+ * \details
+ */
+
+#include "includes.h"
+#include "sprites/kinematics.h"
+#include "sprites/sprite.h"
+#include "utilities/jobsystem.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class KinematicsStore
+ * \brief Keeps the position and momentum of every Sprite in flat arrays.
+ * \details
+ * Moving a Sprite is pure streaming math, so rather than moving each Sprite
+ * through a virtual Update call, the SpriteManager moves every Sprite at
+ * once by calling Integrate.
+ *
+ * While a Sprite is in the store, its position and momentum accessors read
+ * and write the store's arrays.  When it is removed, the values are copied
+ * back into the Sprite, so a Sprite can leave one SpriteManager and join
+ * another.
+ *
+ * The arrays are grouped by DRAW_ORDER so that Projectiles, which are the
+ * most numerous, are contiguous.
+ *
+ * \see Sprite::Update
+ */
+
+/**\brief Constructs an empty store.
+ */
+KinematicsStore::KinematicsStore() {
+}
+
+/**\brief Release every Sprite.
+ */
+KinematicsStore::~KinematicsStore() {
+	for( int g = 0; g < KINEMATIC_GROUPS; g++ ) {
+		while( !groups[g].owners.empty() ) {
+			Remove( groups[g].owners.back() );
+		}
+	}
+}
+
+/**\brief The group that a kind of Sprite is kept in.
+ */
+int KinematicsStore::GroupOf( int drawOrder ) {
+	switch( drawOrder ) {
+		case DRAW_ORDER_PLANET: return 0;
+		case DRAW_ORDER_PROJECTILE: return 1;
+		case DRAW_ORDER_SHIP: return 2;
+		case DRAW_ORDER_PLAYER: return 3;
+		default: return 4;
+	}
+}
+
+/**\brief Take over the kinematics of a Sprite.
+ */
+void KinematicsStore::Add( Sprite *sprite ) {
+	assert( sprite->kinematics == NULL );
+	int g = GroupOf( sprite->GetDrawOrder() );
+	Group &group = groups[g];
+
+	group.x.push_back( sprite->worldPosition.GetX() );
+	group.y.push_back( sprite->worldPosition.GetY() );
+	group.vx.push_back( sprite->momentum.GetX() );
+	group.vy.push_back( sprite->momentum.GetY() );
+	group.lastVx.push_back( sprite->lastMomentum.GetX() );
+	group.lastVy.push_back( sprite->lastMomentum.GetY() );
+	group.ax.push_back( sprite->acceleration.GetX() );
+	group.ay.push_back( sprite->acceleration.GetY() );
+	group.owners.push_back( sprite );
+
+	sprite->kinematics = this;
+	sprite->kinematicGroup = g;
+	sprite->kinematicIndex = group.owners.size() - 1;
+}
+
+/**\brief Give a Sprite back its own kinematics.
+ * \details The last Sprite in the group is moved into the hole.
+ */
+void KinematicsStore::Remove( Sprite *sprite ) {
+	assert( sprite->kinematics == this );
+	Group &group = groups[ sprite->kinematicGroup ];
+	Uint32 i = sprite->kinematicIndex;
+	Uint32 last = group.owners.size() - 1;
+
+	sprite->kinematics = NULL;
+	sprite->worldPosition = Coordinate( group.x[i], group.y[i] );
+	sprite->momentum = Coordinate( group.vx[i], group.vy[i] );
+	sprite->lastMomentum = Coordinate( group.lastVx[i], group.lastVy[i] );
+	sprite->acceleration = Coordinate( group.ax[i], group.ay[i] );
+
+	if( i != last ) {
+		group.x[i] = group.x[last];
+		group.y[i] = group.y[last];
+		group.vx[i] = group.vx[last];
+		group.vy[i] = group.vy[last];
+		group.lastVx[i] = group.lastVx[last];
+		group.lastVy[i] = group.lastVy[last];
+		group.ax[i] = group.ax[last];
+		group.ay[i] = group.ay[last];
+		group.owners[i] = group.owners[last];
+		group.owners[i]->kinematicIndex = i;
+	}
+	group.x.pop_back();
+	group.y.pop_back();
+	group.vx.pop_back();
+	group.vy.pop_back();
+	group.lastVx.pop_back();
+	group.lastVy.pop_back();
+	group.ax.pop_back();
+	group.ay.pop_back();
+	group.owners.pop_back();
+}
+
+// Integrates a slice of one group on a worker thread.
+class IntegrateJob : public Job {
+	public:
+		IntegrateJob( KinematicsStore::Group *_group ) : group(_group) {}
+		void Run( int begin, int end ) { KinematicsStore::IntegrateRange( *group, begin, end ); }
+	private:
+		KinematicsStore::Group *group;
+};
+
+/**\brief Move every Sprite in the direction of its momentum.
+ * \details Since this is a space simulation, there is no Friction; momentum does not decrease over time.
+ * Every Sprite is independent, so the result is the same with or without a JobSystem.
+ */
+void KinematicsStore::Integrate( JobSystem *jobs ) {
+	for( int g = 0; g < KINEMATIC_GROUPS; g++ ) {
+		const size_t n = groups[g].owners.size();
+		if( jobs == NULL ) {
+			IntegrateRange( groups[g], 0, n );
+		} else {
+			IntegrateJob job( &groups[g] );
+			jobs->ParallelFor( n, KINEMATIC_GRAIN, &job );
+		}
+	}
+}
+
+/**\brief Move the Sprites [begin,end) of one group.
+ */
+void KinematicsStore::IntegrateRange( Group &group, size_t begin, size_t end ) {
+	if( begin >= end ) {
+		return;
+	}
+	const size_t n = end;
+
+	double * __restrict x = &group.x[0];
+	double * __restrict y = &group.y[0];
+	const double * __restrict vx = &group.vx[0];
+	const double * __restrict vy = &group.vy[0];
+	double * __restrict lastVx = &group.lastVx[0];
+	double * __restrict lastVy = &group.lastVy[0];
+	double * __restrict ax = &group.ax[0];
+	double * __restrict ay = &group.ay[0];
+	size_t i = begin;
+
+#ifdef __SSE2__
+	// Two Sprites at a time
+	for( ; i + 2 <= n; i += 2 ) {
+		__m128d mx = _mm_loadu_pd( vx + i );
+		__m128d my = _mm_loadu_pd( vy + i );
+		_mm_storeu_pd( x + i, _mm_add_pd( _mm_loadu_pd( x + i ), mx ) );
+		_mm_storeu_pd( y + i, _mm_add_pd( _mm_loadu_pd( y + i ), my ) );
+		_mm_storeu_pd( ax + i, _mm_sub_pd( _mm_loadu_pd( lastVx + i ), mx ) );
+		_mm_storeu_pd( ay + i, _mm_sub_pd( _mm_loadu_pd( lastVy + i ), my ) );
+		_mm_storeu_pd( lastVx + i, mx );
+		_mm_storeu_pd( lastVy + i, my );
+	}
+#endif
+
+	for( ; i < n; i++ ) {
+		x[i] += vx[i];
+		y[i] += vy[i];
+		ax[i] = lastVx[i] - vx[i];
+		ay[i] = lastVy[i] - vy[i];
+		lastVx[i] = vx[i];
+		lastVy[i] = vy[i];
+	}
+}
+
+/**\brief The number of Sprites in the store.
+ */
+unsigned int KinematicsStore::Count( void ) {
+	unsigned int total = 0;
+	for( int g = 0; g < KINEMATIC_GROUPS; g++ ) {
+		total += groups[g].owners.size();
+	}
+	return total;
+}
+
+/** @} */
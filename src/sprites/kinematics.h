@@ -0,0 +1,60 @@
+/**\file			kinematics.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Structure of arrays storage for Sprite positions and momentum
+ * \details
+ */
+
+#ifndef __H_KINEMATICS__
+#define __H_KINEMATICS__
+
+#include "includes.h"
+#include "utilities/coordinate.h"
+
+class Sprite;
+class JobSystem;
+
+// Sprites are grouped by their DRAW_ORDER so that each kind is contiguous.
+#define KINEMATIC_GROUPS 5
+
+// The number of Sprites integrated by each job.
+#define KINEMATIC_GRAIN  2048
+
+class KinematicsStore {
+	public:
+		KinematicsStore();
+		~KinematicsStore();
+
+		void Add( Sprite *sprite );
+		void Remove( Sprite *sprite );
+
+		void Integrate( JobSystem *jobs = NULL );
+
+		unsigned int Count( void );
+
+		// Accessors used by Sprite.  The group and index are owned by the Sprite.
+		inline Coordinate GetPosition( int g, Uint32 i ) const { return Coordinate( groups[g].x[i], groups[g].y[i] ); }
+		inline void SetPosition( int g, Uint32 i, const Coordinate& c ) { groups[g].x[i] = c.GetX(); groups[g].y[i] = c.GetY(); }
+		inline Coordinate GetMomentum( int g, Uint32 i ) const { return Coordinate( groups[g].vx[i], groups[g].vy[i] ); }
+		inline void SetMomentum( int g, Uint32 i, const Coordinate& c ) { groups[g].vx[i] = c.GetX(); groups[g].vy[i] = c.GetY(); }
+		inline Coordinate GetAcceleration( int g, Uint32 i ) const { return Coordinate( groups[g].ax[i], groups[g].ay[i] ); }
+
+	private:
+		friend class IntegrateJob;
+
+		struct Group {
+			vector<double> x, y;           ///< World position.
+			vector<double> vx, vy;         ///< Momentum.
+			vector<double> lastVx, lastVy; ///< Momentum after the previous Integrate.
+			vector<double> ax, ay;         ///< Change in momentum during the previous Integrate.
+			vector<Sprite*> owners;        ///< The Sprite at each index.
+		};
+
+		static int GroupOf( int drawOrder );
+		static void IntegrateRange( Group &group, size_t begin, size_t end );
+
+		Group groups[KINEMATIC_GROUPS];
+};
+
+#endif // __H_KINEMATICS__
@@ -36,6 +36,7 @@ class Planet : public Sprite, public Component {
 		);
 		
 		void Update( lua_State *L );
+		bool NeedsLua( void ) { return false; }
 
 		virtual int GetDrawOrder( void ) { return( DRAW_ORDER_PLANET ); }
 		
@@ -28,10 +28,15 @@
  * The Ship decides where and how the Projectile is created.
  * The Weapon defines the effect of the projectile.
  *
+ * Projectiles are created with new and deleted by the SpriteManager like any
+ * other Sprite, but their memory comes from a SpritePool.
+ *
  * \see Ship
  * \see Weapon
  */
 
+SpritePool Projectile::pool( "Projectile", sizeof(Projectile) );
+
 /**\brief Constructor
  */
 Projectile::Projectile(float damageBooster, float angleToFire, Coordinate worldPosition, Coordinate firedMomentum, Weapon* _weapon)
@@ -72,8 +77,9 @@ Projectile::~Projectile(void)
 /**\brief Update the Projectile
  *
  * Projectiles do all the normal Sprite things like moving.
- * Projectiles check for collisions with nearby Ships, and if they collide,
- * they deal damage to that ship. Note that since each projectile knows which ship fired it and will never collide with them.
+ * Collisions are not checked here.  The SpriteManager checks every
+ * Projectile at once after all Sprites have been updated.
+ * \see Impact
  *
  * Projectiles have a life time limit (in milli-seconds).  Each tick they need
  * to check if they've lived too long and need to disappear.
@@ -82,30 +88,15 @@ Projectile::~Projectile(void)
  * means that they will turn slightly to head towards their target.
  */
 void Projectile::Update( lua_State *L ) {
-	Sprite::Update( L ); // update momentum and other generic sprite attributes
-	SpriteManager *sprites = Scenario_Lua::GetScenario(L)->GetSpriteManager();
-
-	// Check for projectile collisions
-	Sprite* impact = sprites->GetNearestSprite( (Sprite*)this, 100,DRAW_ORDER_SHIP|DRAW_ORDER_PLAYER );
-	if( (impact != NULL) && (impact->GetID() != ownerID) && ((this->GetWorldPosition() - impact->GetWorldPosition()).GetMagnitude() < impact->GetRadarSize() )) {
-		int damageDone = (weapon->GetPayload())*damageBoost;
-
-		((Ship*)impact)->Damage( damageDone );
-
-		if(impact->GetDrawOrder() == DRAW_ORDER_SHIP) {
-			((AI*)impact)->AddEnemy(ownerID, damageDone);
-		}
+	UpdateWithoutLua( Scenario_Lua::GetScenario(L)->GetSpriteManager() );
+}
 
-		sprites->Delete( (Sprite*)this );
-		
-		// Create a fire burst where this projectile hit the ship's shields.
-		// TODO: This shows how much we need to improve our collision detection.
-		Effect* hit = new Effect(this->GetWorldPosition(), "data/animations/shield.ani", 0);
-
-		hit->SetAngle( -this->GetAngle() );
-		hit->SetMomentum( impact->GetMomentum() );
-		sprites->Add( hit );
-	}
+/**\brief Update the Projectile without touching Lua.
+ * \details This may run on a worker thread, so it only changes this Projectile.
+ * \see Update
+ */
+void Projectile::UpdateWithoutLua( SpriteManager *sprites ) {
+	Sprite::Update( NULL ); // update momentum and other generic sprite attributes
 
 	// Expire the projectile after a time period
 	if (( Timer::GetTicks() > secondsOfLife + start )) {
@@ -113,14 +104,48 @@ void Projectile::Update( lua_State *L ) {
 	}
 
 	// Track the target
-	Sprite* target = sprites->GetSpriteByID( targetID );
+	// Sprite IDs are never reused, so the ID only needs to be looked up once.
+	if( targetID != 0 ) {
+		target = sprites->GetHandleByID( targetID );
+		targetID = 0;
+	}
+	Sprite* targetSprite = sprites->GetSprite( target );
 	float tracking = weapon->GetTracking();
-	if( target != NULL && tracking > 0.00000001f ) {
-		float angleTowards = normalizeAngle( ( target->GetWorldPosition() - this->GetWorldPosition() ).GetAngle() - GetAngle() );
+	if( targetSprite != NULL && tracking > 0.00000001f ) {
+		float angleTowards = normalizeAngle( ( targetSprite->GetWorldPosition() - this->GetWorldPosition() ).GetAngle() - GetAngle() );
 		SetMomentum( GetMomentum().RotateBy( angleTowards*tracking ) );
 		SetAngle( GetMomentum().GetAngle() );
 	}
 }
 
+/**\brief Hit a Ship.
+ *
+ * Projectiles deal damage to the Ship that they collide with and then disappear.
+ * Note that since each projectile knows which ship fired it and will never collide with them.
+ *
+ * \param impact The Ship or Player that this Projectile is inside of.
+ * \param sprites The SpriteManager that found the collision.
+ * \see SpriteManager::Collide
+ */
+void Projectile::Impact( Sprite *impact, SpriteManager *sprites ) {
+	int damageDone = (weapon->GetPayload())*damageBoost;
+
+	((Ship*)impact)->Damage( damageDone );
+
+	if(impact->GetDrawOrder() == DRAW_ORDER_SHIP) {
+		((AI*)impact)->AddEnemy(ownerID, damageDone);
+	}
+
+	sprites->Delete( (Sprite*)this );
+
+	// Create a fire burst where this projectile hit the ship's shields.
+	// TODO: This shows how much we need to improve our collision detection.
+	Effect* hit = new Effect(this->GetWorldPosition(), "data/animations/shield.ani", 0);
+
+	hit->SetAngle( -this->GetAngle() );
+	hit->SetMomentum( impact->GetMomentum() );
+	sprites->Add( hit );
+}
+
 /** @} */
 
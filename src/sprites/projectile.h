@@ -11,8 +11,12 @@
 #define __H_PROJECTILE__
 
 #include "sprites/sprite.h"
+#include "sprites/spritepool.h"
 #include "engine/weapons.h"
 #include "includes.h"
+
+class SpriteManager;
+
 class Projectile :
 	public Sprite
 {
@@ -20,16 +24,27 @@ public:
 	Projectile(float damageBooster, float angleToFire, Coordinate worldPosition, Coordinate firedMomentum, Weapon* weapon);
 	~Projectile(void);
 	void Update( lua_State *L );
+	bool NeedsLua( void ) { return false; }
+	void UpdateWithoutLua( SpriteManager *sprites );
+	void Impact( Sprite *impact, SpriteManager *sprites );
+	int GetOwnerID() { return ownerID; }
 	void SetOwnerID(int id) { ownerID = id; }
 	void SetTargetID(int id) { targetID = id; }
 	int GetDrawOrder( void ) {
 			return( DRAW_ORDER_PROJECTILE );
 	}
+
+	static void* operator new( size_t size ) { return pool.Allocate( size ); }
+	static void operator delete( void *p ) { pool.Free( p ); }
+	static SpritePool* GetPool( void ) { return &pool; }
 private:
+	static SpritePool pool; ///< Every Projectile is kept here.
+
 	Uint32 secondsOfLife; //time to live before projectile blows up
 	Uint32 start;
 	int ownerID;
 	int targetID;
+	SpriteHandle target; ///< The targetID, once it has been looked up.
 	float damageBoost;
 	Weapon *weapon;
 };
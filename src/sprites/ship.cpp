@@ -504,7 +504,7 @@ void Ship::Draw( void ) {
 
 	Sprite::Draw();
 
-	// Draw the flare animation, if required
+	// Queue the flare animation, if required.  It goes in the layer above this Ship.
 	if( status.isAccelerating ) {
 		float direction = GetAngle();
 		float tx, ty;
@@ -515,7 +515,7 @@ void Ship::Draw( void ) {
 				static_cast<float>(screenPosition.GetX()),
 				static_cast<float>(screenPosition.GetY()), &tx, &ty,
 				static_cast<float>( trig->DegToRad( direction ) ));
-		flareAnimation->Draw( (int)tx, (int)ty, direction );
+		flareAnimation->Queue( GetRenderLayer() + 1, GetID(), (int)tx, (int)ty, direction );
 
 		status.isAccelerating = false;
 	}
@@ -531,7 +531,7 @@ void Ship::Draw( void ) {
 				static_cast<float>(position.GetScreenX()),
 				static_cast<float>(position.GetScreenY()), &tx, &ty,
 				static_cast<float>( trig->DegToRad( direction ) ));
-		flareAnimation->Draw( (int)tx, (int)ty, direction );
+		flareAnimation->Queue( GetRenderLayer() + 1, GetID(), (int)tx, (int)ty, direction );
 
 		status.isRotatingLeft = false;
 		status.isRotatingRight = false;
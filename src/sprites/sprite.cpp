@@ -6,12 +6,13 @@
  * \details
  */
 
-#include "menu.h"
 #include "includes.h"
 #include "common.h"
 #include "engine/camera.h"
+#include "graphics/renderqueue.h"
 #include "sprites/sprite.h"
 #include "utilities/log.h"
+#include "utilities/spatialgrid.h"
 #include "utilities/timer.h"
 
 /** \addtogroup Sprites
@@ -19,7 +20,7 @@
  */
 
 // Sprite ID 0 is only used as a NULL
-long int Sprite::sprite_ids = 1;
+SDL_atomic_t Sprite::sprite_ids = { 1 };
 
 /**\class Sprite
  * \brief Supertype for all drawable objects existing at a point in the universe with an angle and momentum.
@@ -53,7 +54,12 @@ long int Sprite::sprite_ids = 1;
  *          Sets the radarColor as Grey.
  */
 Sprite::Sprite() {
-	id = sprite_ids++;
+	// Spatial queries on worker threads create Sprites too.
+	id = SDL_AtomicAdd( &sprite_ids, 1 );
+
+	kinematics = NULL;
+	kinematicGroup = 0;
+	kinematicIndex = 0;
 
 	// Momentum caps
 	angle = 0.;
@@ -64,14 +70,23 @@ Sprite::Sprite() {
 	radarColor = WHITE * 0.7f;
 
 	interpolationUpdateCheck = 0;
+	screenPass = 0;
+	gridMember = GRID_UNFILED;
 }
 
 Coordinate Sprite::GetWorldPosition( void ) const {
+	if( kinematics ) {
+		return kinematics->GetPosition( kinematicGroup, kinematicIndex );
+	}
 	return worldPosition;
 }
 
 void Sprite::SetWorldPosition( Coordinate coord ) {
-	worldPosition = coord;
+	if( kinematics ) {
+		kinematics->SetPosition( kinematicGroup, kinematicIndex, coord );
+	} else {
+		worldPosition = coord;
+	}
 }
 
 Coordinate Sprite::GetScreenPosition( void ) const {
@@ -80,24 +95,52 @@ Coordinate Sprite::GetScreenPosition( void ) const {
 
 /**\brief Move this Sprite in the direction of their current momentum.
  * \details Since this is a space simulation, there is no Friction; momentum does not decrease over time.
+ * Sprites in a SpriteManager have already been moved by its KinematicsStore.
  */
 void Sprite::Update( lua_State *L ) {
+	if( kinematics ) {
+		return;
+	}
 	worldPosition += momentum;
 	acceleration = lastMomentum - momentum;
 	lastMomentum = momentum;
 }
 
-void Sprite::UpdateScreenCoordinates( void ) {
-	Camera *camera = Menu::GetCurrentScenario()->GetCamera();
+/**\brief Translate this Sprite's position onto the screen.
+ * \details Only Sprites that can appear on screen are updated.  A Sprite that
+ *          was off screen during the previous pass has a stale screen position,
+ *          so it must not be interpolated until it has been updated twice.
+ * \param camera The Camera that the screen follows.
+ * \param pass The SpriteManager's current visibility pass.
+ * \sa SpriteManager::UpdateVisibility
+ */
+void Sprite::UpdateScreenCoordinates( Camera *camera, Uint32 pass ) {
+	if( screenPass + 1 != pass ) interpolationUpdateCheck = 0;
+	screenPass = pass;
 
+	Coordinate world = GetWorldPosition();
 	oldScreenPosition = screenPosition;
-	camera->TranslateWorldToScreen( worldPosition, screenPosition );
+	camera->TranslateWorldToScreen( world, screenPosition );
 
 	if(interpolationUpdateCheck < 2) interpolationUpdateCheck++;
 }
 
+/**\brief The RenderQueue layer that this kind of Sprite is drawn in.
+ */
+Uint8 Sprite::GetRenderLayer( void ) {
+	switch( GetDrawOrder() ) {
+		case DRAW_ORDER_PLANET: return RENDER_LAYER_PLANET;
+		case DRAW_ORDER_PROJECTILE: return RENDER_LAYER_PROJECTILE;
+		case DRAW_ORDER_SHIP: return RENDER_LAYER_SHIP;
+		case DRAW_ORDER_PLAYER: return RENDER_LAYER_PLAYER;
+		case DRAW_ORDER_EFFECT: return RENDER_LAYER_EFFECT;
+		default: return RENDER_LAYER_EFFECT;
+	}
+}
+
 /**\brief Draw
- * \details The Sprite is drawn centered on wx,wy.
+ * \details The Sprite is queued centered on wx,wy.
+ *          SpriteManager::Draw flushes the RenderQueue once every Sprite is queued.
  *          This will attempt to Draw the sprite even if wx,wy are completely off the Screen.
  *          Avoid drawing sprites that are too far off the Screen.
  * \sa SpriteManager::Draw
@@ -112,9 +155,9 @@ void Sprite::Draw( void ) {
 			interpolatedScreenPosition.SetX(oldScreenPosition.GetX() * (1.0f - fframe) + screenPosition.GetX() * fframe);
 			interpolatedScreenPosition.SetY(oldScreenPosition.GetY() * (1.0f - fframe) + screenPosition.GetY() * fframe);
 
-			image->DrawCentered( interpolatedScreenPosition.GetX(), interpolatedScreenPosition.GetY(), angle );
+			RenderQueue::SubmitImage( GetRenderLayer(), id, image, interpolatedScreenPosition.GetX(), interpolatedScreenPosition.GetY(), angle );
 		} else {
-			image->DrawCentered( screenPosition.GetX(), screenPosition.GetY(), angle );
+			RenderQueue::SubmitImage( GetRenderLayer(), id, image, screenPosition.GetX(), screenPosition.GetY(), angle );
 		}
 	} else {
 		LogMsg(WARN, "Attempt to draw a sprite before an image was assigned." );
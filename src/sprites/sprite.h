@@ -13,6 +13,8 @@
 #include "graphics/video.h"
 #include "utilities/lua.h"
 #include "utilities/coordinate.h"
+#include "sprites/spritehandle.h"
+#include "sprites/kinematics.h"
 
 // With the draw order, higher numbers are drawn later (on top)
 // By using non-overlapping bits we can bit mask during searches
@@ -23,6 +25,9 @@
 #define DRAW_ORDER_EFFECT              0x0010 ///< Draw order for Effect Sprites (Explosions)
 #define DRAW_ORDER_ALL                 0xFFFF ///< Default DRAW_ORDER for searches that filter.
 
+class SpriteManager;
+class Camera;
+
 class Sprite {
 	public:
 		Sprite();
@@ -34,10 +39,17 @@ class Sprite {
 		Coordinate GetScreenPosition( void ) const;
 
 		virtual void Update( lua_State *L );
-		void UpdateScreenCoordinates( void );
+		// Sprites that never touch Lua may be updated on a worker thread.
+		virtual bool NeedsLua( void ) { return true; }
+		virtual void UpdateWithoutLua( SpriteManager *sprites ) { Update( NULL ); }
+		void UpdateScreenCoordinates( Camera *camera, Uint32 pass );
+		Uint32 GetScreenPass( void ) const { return screenPass; } ///< The last visibility pass that found this Sprite on screen.
 		virtual void Draw( void );
 
 		int GetID( void ) { return id; }
+		static int GetNextID( void ) { return SDL_AtomicGet( &sprite_ids ); } ///< Changes whenever a Sprite is created.
+		SpriteHandle GetHandle( void ) const { return handle; }
+		void SetHandle( SpriteHandle _handle ) { handle = _handle; }
 
 		float GetAngle( void ) const {
 			return( angle );
@@ -46,12 +58,15 @@ class Sprite {
 			this->angle = angle;
 		}
 		Coordinate GetMomentum( void ) const {
+			if( kinematics ) return kinematics->GetMomentum( kinematicGroup, kinematicIndex );
 			return momentum;
 		}
 		void SetMomentum( Coordinate momentum ) {
-			this->momentum = momentum;
+			if( kinematics ) kinematics->SetMomentum( kinematicGroup, kinematicIndex, momentum );
+			else this->momentum = momentum;
 		}
 		Coordinate GetAcceleration( void ) const {
+			if( kinematics ) return kinematics->GetAcceleration( kinematicGroup, kinematicIndex );
 			return acceleration;
 		}
 		void SetImage( Image *image ) {
@@ -66,13 +81,22 @@ class Sprite {
 			return image;
 		}
 		int GetRadarSize( void ) { return radarSize; }
+		void SetRadarSize( int size ) { radarSize = size; }
 		virtual Color GetRadarColor( void ) { return radarColor; }
 		virtual int GetDrawOrder( void ) = 0;
+		Uint8 GetRenderLayer( void );
 
 	private:
-		static long int sprite_ids; ///< The ID for the next Sprite.
+		friend class KinematicsStore;
+		friend class SpatialGrid;
+
+		static SDL_atomic_t sprite_ids; ///< The ID for the next Sprite.
 
 		int id; ///< The unique ID of this Sprite.
+		SpriteHandle handle; ///< Where the SpriteManager keeps this Sprite.  Null until it is added.
+		KinematicsStore *kinematics; ///< Where the position and momentum are kept while in a SpriteManager.  NULL uses the fields below.
+		int kinematicGroup; ///< This Sprite's group in the KinematicsStore.
+		Uint32 kinematicIndex; ///< This Sprite's index in its KinematicsStore group.
 		Coordinate oldScreenPosition, screenPosition; ///< The Current position of this Sprite.
 		Coordinate worldPosition; ///< The Current position of this Sprite.
 		Coordinate momentum; ///< The current Speed and Direction that this Sprite is moving (not pointing).
@@ -83,6 +107,8 @@ class Sprite {
 		int radarSize; ///< A Rough appoximation of this Sprite's size.
 		Color radarColor; ///< The color of this Sprite.
 		int interpolationUpdateCheck; // we need two logical loops before interpolated coordinates can be used
+		Uint32 screenPass; ///< The last visibility pass that updated screenPosition.
+		Uint32 gridMember; ///< This Sprite's index in the members of its SpatialGrid, or GRID_UNFILED.
 
     protected:
         bool playerCheck;              ///< Flag for player Sprite, true if the Sprite is an instance of Player class
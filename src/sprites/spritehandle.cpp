@@ -0,0 +1,89 @@
+/**\file			spritehandle.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Generational handles to Sprites owned by a SpriteManager
+ * \details
+ */
+
+#include "includes.h"
+#include "sprites/spritehandle.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+#define SLOT_NONE 0xFFFFFFFFu
+
+/**\class SpriteSlotMap
+ * \brief Gives every Sprite a handle that can be looked up in constant time.
+ * \details
+ * Each Sprite added to the SpriteManager is stored in a Slot.  The handle
+ * records the Slot and the Slot's generation at the time of insertion.
+ * When a Sprite is removed, its Slot's generation is incremented, so old
+ * handles no longer match and Get returns NULL instead of a dangling pointer.
+ *
+ * Free Slots are reused, so the Slots stay densely packed no matter how many
+ * Sprites have been created over time.
+ *
+ * Handles are only meaningful to the SpriteSlotMap that created them.
+ *
+ * \see SpriteHandle
+ * \see SpriteManager::GetSprite
+ */
+
+/**\brief Constructs an empty SpriteSlotMap.
+ */
+SpriteSlotMap::SpriteSlotMap() {
+	firstFree = SLOT_NONE;
+	count = 0;
+}
+
+/**\brief Store a Sprite.
+ * \returns The handle for this Sprite.
+ */
+SpriteHandle SpriteSlotMap::Insert( Sprite *sprite ) {
+	SpriteHandle handle;
+	assert( sprite != NULL );
+
+	if( firstFree != SLOT_NONE ) {
+		handle.slot = firstFree;
+		firstFree = slots[firstFree].nextFree;
+	} else {
+		Slot fresh;
+		fresh.generation = 1;
+		fresh.nextFree = SLOT_NONE;
+		handle.slot = slots.size();
+		slots.push_back( fresh );
+	}
+
+	Slot &slot = slots[handle.slot];
+	slot.sprite = sprite;
+	slot.nextFree = SLOT_NONE;
+	handle.generation = slot.generation;
+	count++;
+	return handle;
+}
+
+/**\brief Forget a Sprite.
+ * \details Every handle to this Sprite becomes stale.
+ * \returns False if the handle was already stale.
+ */
+bool SpriteSlotMap::Remove( SpriteHandle handle ) {
+	if( Get( handle ) == NULL ) {
+		return false;
+	}
+
+	Slot &slot = slots[handle.slot];
+	slot.sprite = NULL;
+	slot.generation++;
+	if( slot.generation == 0 ) {
+		slot.generation = 1; // Zero is reserved for the null handle.
+	}
+	slot.nextFree = firstFree;
+	firstFree = handle.slot;
+	count--;
+	return true;
+}
+
+/** @} */
@@ -0,0 +1,59 @@
+/**\file			spritehandle.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Generational handles to Sprites owned by a SpriteManager
+ * \details
+ */
+
+#ifndef __H_SPRITEHANDLE__
+#define __H_SPRITEHANDLE__
+
+#include "includes.h"
+
+class Sprite;
+
+// A reference to a Sprite that can tell when the Sprite has been deleted.
+struct SpriteHandle {
+	Uint32 slot;        ///< Position in the SpriteSlotMap.
+	Uint32 generation;  ///< Zero for the null handle.
+
+	SpriteHandle() : slot(0), generation(0) {}
+	bool IsNull() const { return generation == 0; }
+	bool operator==( const SpriteHandle& other ) const { return slot == other.slot && generation == other.generation; }
+	bool operator!=( const SpriteHandle& other ) const { return !(*this == other); }
+};
+
+class SpriteSlotMap {
+	public:
+		SpriteSlotMap();
+
+		SpriteHandle Insert( Sprite *sprite );
+		bool Remove( SpriteHandle handle );
+
+		/**\brief Get the Sprite that a handle refers to.
+		 * \returns NULL if the Sprite has been removed or the handle is null.
+		 */
+		inline Sprite* Get( SpriteHandle handle ) const {
+			if( handle.slot < slots.size() && slots[handle.slot].generation == handle.generation ) {
+				return slots[handle.slot].sprite;
+			}
+			return NULL;
+		}
+
+		unsigned int Size( void ) const { return count; }
+		unsigned int Capacity( void ) const { return slots.size(); }
+
+	private:
+		struct Slot {
+			Sprite *sprite;     ///< NULL when the Slot is free.
+			Uint32 generation;  ///< Incremented every time the Slot is freed.
+			Uint32 nextFree;    ///< The next free Slot, when this Slot is free.
+		};
+
+		vector<Slot> slots;
+		Uint32 firstFree;       ///< The most recently freed Slot.
+		unsigned int count;     ///< The number of Slots in use.
+};
+
+#endif // __H_SPRITEHANDLE__
@@ -8,11 +8,16 @@
 
 #include "includes.h"
 #include "common.h"
+#include "graphics/renderqueue.h"
 #include "sprites/ai.h"
+#include "sprites/ai_shards.h"
 #include "sprites/effects.h"
+#include "sprites/projectile.h"
 #include "sprites/spritemanager.h"
 #include "utilities/log.h"
+#include "utilities/profiler.h"
 #include "utilities/quadtree.h"
+#include "utilities/spatialindex.h"
 #include "engine/camera.h"
 #include "engine/scenario_lua.h"
 
@@ -32,22 +37,38 @@
  *   - This list can be requested as a whole, or filtered by requesting only a
  *     certain Sprite Type.
  *   \see GetSprites
- * - The SpriteManager has a set of QuadTrees.
- *   - The QuadTree is a recursive datastructure that stores the Sprites by their
- *     Universal location.  The Quadtree segments the Sprites based on how
- *     relativly close the Sprites are.
- *   - Each QuadTree is only a finite size, but can theoretically hold an infinte
- *     number of sprites.
- *   - The entire universe is broken up into a grid of QuadTrees.
- *     Only grid positions with Sprites in them are actually populated by QuadTrees.
- *   - The QuadTrees cannot be accessed directly, but are used implicitely when
+ * - The SpriteManager has a SpatialIndex.
+ *   - The SpatialIndex stores the Sprites by their Universal location.
+ *   - The backend is chosen by the "options/simulation/spatial-index" option.
+ *     By default the entire universe is broken up into a grid of QuadTrees.
+ *     Alternatively, a loose hashed uniform grid can be used.
+ *   - The SpatialIndex cannot be accessed directly, but is used implicitely when
  *     requesting sprites by a location.
- *   \see QuadTree
+ *   \see SpatialIndex
+ *   \see QuadTreeIndex
+ *   \see SpatialGrid
  *   \see GetSpritesNear
  *   \see GetNearestSprite
- * - The SpriteManager has a map of all Sprites by their unique ID.
+ * - The SpriteManager has a hash map of all Sprites by their unique ID.
  *   - Sprites can be queried by passing an ID.
  *   \see GetSpriteByID
+ * - The SpriteManager has a SpriteSlotMap of all Sprites.
+ *   - Every Sprite is given a SpriteHandle when it is added.
+ *   - Sprites can be queried by passing a handle.  This is faster than
+ *     using the ID and is the preferred way to hold on to a Sprite.
+ *   \see GetSprite
+ *
+ * Each Update first moves every Sprite at once, then updates the Sprites that
+ * do not need Lua, split across the worker threads chosen by the
+ * "options/simulation/update-threads" option.  The remaining Sprites are
+ * updated one at a time.  Deletions requested by the worker threads are
+ * batched like any other, so the results do not depend on the thread count.
+ *   \see JobSystem
+ *   \see Sprite::NeedsLua
+ *
+ * When the AI are sharded, their state machines run between those two steps,
+ * split across the AIShards.
+ *   \see AIShards
  *
  * Sprites are never deleted immediately.  This is to prevent a Sprite from
  * being deleted during the middle of the Update Loop.  Instead, 'deleted'
@@ -68,7 +89,25 @@ SpriteManager::SpriteManager() :
 	player = NULL;
 
 	spritelist = new list<Sprite*>();
-	spritelookup = new map<int,Sprite*>();
+	spritelookup = new unordered_map<int,Sprite*>();
+	index = SpatialIndex::Create( OPTION(string, "options/simulation/spatial-index") );
+	LogMsg(INFO, "Using the '%s' spatial index.", index->GetName().c_str() );
+	jobs = new JobSystem( OPTION(int, "options/simulation/update-threads") );
+	deleteLock = SDL_CreateMutex();
+
+	queryCount = 0;
+	queryTicks = 0;
+	queryLock = 0;
+	lastQueryCount = 0;
+	lastQueryTime = 0.0f;
+	lastIndexTime = 0.0f;
+	lastLuaTime = 0.0f;
+	lastCollisionTime = 0.0f;
+	lastNodesAcquired = 0;
+	lastNodeAllocations = 0;
+
+	radarRange = 0.0f;
+	visiblePass = 0;
 
 	//fill in the ticksToBandNum map based on the semiRegularPeriod and numSemiRegularBands
 	int updateGap = semiRegularPeriod / numSemiRegularBands;
@@ -79,7 +118,9 @@ SpriteManager::SpriteManager() :
 }
 
 SpriteManager::~SpriteManager() {
-
+	delete index;
+	delete jobs;
+	SDL_DestroyMutex( deleteLock );
 }
 
 /**\brief Adds a sprite to the manager.
@@ -88,7 +129,9 @@ SpriteManager::~SpriteManager() {
 void SpriteManager::Add( Sprite *sprite ) {
 	spritelist->push_back(sprite);
 	spritelookup->insert(make_pair(sprite->GetID(),sprite));
-	GetQuadrant( sprite->GetWorldPosition() )->Insert( sprite );
+	sprite->SetHandle( slots.Insert( sprite ) );
+	kinematics.Add( sprite );
+	index->Insert( sprite );
 }
 
 /**\brief Adds player sprite to the manager.
@@ -109,11 +152,19 @@ bool SpriteManager::DeleteSprite( Sprite *sprite ) {
 
 	spritelist->remove( sprite );
 	spritelookup->erase( sprite->GetID() );
+	slots.Remove( sprite->GetHandle() );
+	sprite->SetHandle( SpriteHandle() );
 
-	GetQuadrant( sprite->GetWorldPosition() )->Delete( sprite );
+	index->Remove( sprite );
+	kinematics.Remove( sprite );
+
+	// Forget the Sprite before the next visibility pass, in case the game is paused.
+	// The visible sets are compacted once by ForgetDeleted, not once per Sprite.
+	forgotten.push_back( sprite );
 
 	// Delete the sprite itself unless it is a Planet or Player.
 	// Planets and Players are special sprites since they are Components and get saved.
+	// Projectiles and Effects go back to their SpritePool.
 	if( !(sprite->GetDrawOrder() & (DRAW_ORDER_PLAYER | DRAW_ORDER_PLANET )) ) {
 		delete sprite;
 	}
@@ -132,6 +183,7 @@ void SpriteManager::DeleteByType( int type ) {
 			i = spritelist->begin(); // TODO: spritelist->remove() is called which ... makes this necessary? Right?
 		}
 	}
+	ForgetDeleted();
 }
 
 // Remove every sprite (planet, AI ship, projectile, effect, etc.) except the player's sprite
@@ -145,6 +197,7 @@ void SpriteManager::DeleteAllExceptPlayer( void ) {
 			i = spritelist->begin(); // TODO: spritelist->remove() is called which ... makes this necessary? Right?
 		}
 	}
+	ForgetDeleted();
 }
 
 /**\brief Deletes a sprite.
@@ -153,49 +206,94 @@ void SpriteManager::DeleteAllExceptPlayer( void ) {
  * This just queues the sprite up to be deleted.
  */
 bool SpriteManager::Delete( Sprite *sprite ) {
+	// Worker threads may delete Sprites during Update.
+	// The list is sorted before it is used, so the order does not matter.
+	SDL_LockMutex( deleteLock );
 	spritesToDelete.push_back(sprite);
+	SDL_UnlockMutex( deleteLock );
 
 	return true;
 }
 
-void SpriteManager::UpdateScreenCoordinates( void ) {
+/**\brief Find every Projectile that is inside of a Ship.
+ * \details
+ * This runs once per tick after every Sprite has moved.  Each Projectile that
+ * hit a Ship or the Player is told about the impact.
+ * Projectiles never hit the Ship that fired them.
+ * \see Broadphase
+ */
+void SpriteManager::Collide( void ) {
 	list<Sprite *>::iterator i;
 
+	broadphase.Clear();
 	for( i = spritelist->begin(); i != spritelist->end(); ++i ) {
-		(*i)->UpdateScreenCoordinates();
+		int drawOrder = (*i)->GetDrawOrder();
+		if( drawOrder == DRAW_ORDER_PROJECTILE ) {
+			broadphase.AddProjectile( *i, ((Projectile*)(*i))->GetOwnerID() );
+		} else if( drawOrder & (DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER) ) {
+			broadphase.AddTarget( *i );
+		}
+	}
+
+	collisions.clear();
+	broadphase.Run( &collisions );
+
+	vector<Collision>::iterator hit;
+	for( hit = collisions.begin(); hit != collisions.end(); ++hit ) {
+		((Projectile*)hit->projectile)->Impact( hit->target, this );
 	}
 }
 
+// The number of Lua free Sprites updated by each job.
+#define LUA_FREE_GRAIN 256
+
+// The Profiler name for each kind of Sprite.
+static const char* DrawOrderName( int drawOrder ) {
+	switch( drawOrder ) {
+		case DRAW_ORDER_PLANET: return "Planets";
+		case DRAW_ORDER_PROJECTILE: return "Projectiles";
+		case DRAW_ORDER_SHIP: return "Ships";
+		case DRAW_ORDER_PLAYER: return "Player";
+		case DRAW_ORDER_EFFECT: return "Effects";
+		default: return "Other";
+	}
+}
+
+// Updates a slice of the Lua free Sprites on a worker thread.
+class LuaFreeUpdateJob : public Job {
+	public:
+		LuaFreeUpdateJob( vector<Sprite*> *_sprites, SpriteManager *_manager ) : sprites(_sprites), manager(_manager) {}
+		void Run( int begin, int end ) {
+			for( int s = begin; s < end; s++ ) {
+				(*sprites)[s]->UpdateWithoutLua( manager );
+			}
+		}
+	private:
+		vector<Sprite*> *sprites;
+		SpriteManager *manager;
+};
+
 /**\brief SpriteManager update function.
- * \details Update the sprites inside each quadrant
+ * \details Update the sprites inside each quadrant.
+ *          Sprites that do not need Lua are updated first, in parallel.
+ *          The rest are then updated in the order that they were added.
  * \param lowFps If true, forces the wave-update method to be used rather than the full-update
  */
 void SpriteManager::Update( lua_State *L, bool lowFps) {
-	//this will contain every quadrant that we will potentially want to update
-	list<QuadTree*> quadList;
-
 	//if update-all is given then we update every quadrant
 	//we do the same if tickCount == 0 even if update-all is not given
 	// (in wave update mode, tickCount == 0 is when we want to update all quadrants)
-	if( ! lowFps || tickCount == 0) {
-		//need to get all of the quadrants in our map
-		GetAllQuadrants(&quadList);
-	}
-	else
-	{
+	bool updateAll = ( ! lowFps || tickCount == 0 );
+	Coordinate currentCenter;
+	int semiRegularBand = -1;
+
+	if( !updateAll ) {
 		//wave update mode with tickCount != 0 -- update some quadrants
 		Camera* camera = Scenario_Lua::GetScenario(L)->GetCamera();
-		Coordinate currentPoint (camera->GetFocusCoordinate());	//always update centered on where we're at
-
-		quadList.push_back (GetQuadrant (currentPoint)); //we ALWAYS update the current quadrant
+		currentCenter = GetQuadrantCenter( camera->GetFocusCoordinate() ); //always update centered on where we're at
 
-		//we also ALWAYS update the 'regular' bands
+		//we ALWAYS update the current quadrant and the 'regular' bands
 		//	the first band is at index 1 - index 0 would be the single quadrant in the middle
-		//	when we get the list of quadrants back we splice them onto the end of our overall list
-		for (int i = 1; i <= numRegularBands; i ++) {
-			list<QuadTree*> tempBandList = GetQuadrantsInBand (currentPoint, i);
-			quadList.splice (quadList.end(), tempBandList);
-		}
 
 		//now - we SOMETIMES update the semi-regular bands
 		//   the ticks that each band is updated in is stored in the map
@@ -204,54 +302,117 @@ void SpriteManager::Update( lua_State *L, bool lowFps) {
 		int semiRegularTick = tickCount % semiRegularPeriod;
 		map<int,int>::iterator findBand = ticksToBandNum.find (semiRegularTick);
 		if (findBand != ticksToBandNum.end()) {		//found the key
-			//cout << "tick = " << tickCount << ", semiRegularTick = " << semiRegularTick << ", band = " << findBand->second << endl;
-			list<QuadTree*> tempBandList = GetQuadrantsInBand (currentPoint, findBand->second);
-			quadList.splice (quadList.end(), tempBandList);
-		}
-		else {
-			//no semi-regular bands to update at this tick, do nothing
+			semiRegularBand = findBand->second;
 		}
 	}
 
-	// Find and Fix any Sprites that have moved out of bounds.
-	list<Sprite *> all_oob;
-	list<QuadTree*>::iterator iter;
-	for ( iter = quadList.begin(); iter != quadList.end(); ++iter ) {
-		(*iter)->Update(L);
-		list<Sprite *>* oob = (*iter)->FixOutOfBounds();
-		all_oob.splice(all_oob.end(), *oob );
-		delete oob;
+	// Decide how often the AI think, based on where the camera is looking.
+	if( L != NULL ) {
+		Camera* camera = Scenario_Lua::GetScenario(L)->GetCamera();
+		thinking.BeginTick( camera->GetFocusCoordinate(), static_cast<float>( max( Video::GetWidth(), Video::GetHeight() ) ) );
 	}
 
-	// Move sprites to adjacent Quadrants as they cross boundaries
+	// Move every Sprite, including the ones that will be skipped below.
+	Profiler::Push( "Kinematics" );
+	kinematics.Integrate( jobs );
+	Profiler::Pop();
+
+	// Update the Sprites that do not need Lua on the worker threads.
+	// They only change themselves, so the order does not matter.
+	Profiler::Push( "Lua free Sprites" );
 	list<Sprite *>::iterator i;
-	for( i = all_oob.begin(); i != all_oob.end(); ++i ) {
-		GetQuadrant( (*i)->GetWorldPosition() )->Insert( *i );
+	luaFree.clear();
+	for( i = spritelist->begin(); i != spritelist->end(); ++i ) {
+		if( !(*i)->NeedsLua() && !SkipThisTick( *i, updateAll, currentCenter, semiRegularBand ) ) {
+			luaFree.push_back( *i );
+		}
+	}
+	LuaFreeUpdateJob luaFreeJob( &luaFree, this );
+	jobs->ParallelFor( luaFree.size(), LUA_FREE_GRAIN, &luaFreeJob );
+	Profiler::Pop();
+
+	// Run the AI state machines in the AIShards, then apply what they decided.
+	Uint64 luaStart = SDL_GetPerformanceCounter();
+	Profiler::Push( "AIShards" );
+	AIShards *shards = ( L != NULL ) ? Scenario_Lua::GetScenario(L)->GetAIShards() : NULL;
+	if( shards != NULL ) {
+		for( i = spritelist->begin(); i != spritelist->end(); ++i ) {
+			if( (*i)->GetDrawOrder() == DRAW_ORDER_SHIP && !SkipThisTick( *i, updateAll, currentCenter, semiRegularBand ) ) {
+				AI *ai = (AI*)(*i);
+				if( !ai->IsDisabled() && thinking.ShouldThink( ai, ai->IsInCombat() ) ) {
+					shards->Assign( ai );
+				}
+			}
+		}
+		shards->Think( player );
 	}
+	Profiler::Pop();
+
+	// Update the remaining Sprites, one at a time.
+	// Sprites created during this loop are appended to the spritelist, but
+	// they will not be updated until the next tick.
+	Profiler::Push( "Lua Sprites" );
+	bool profiling = Profiler::IsActive();
+	size_t remaining = spritelist->size();
+	for( i = spritelist->begin(); remaining > 0; ++i, --remaining ) {
+		if( (*i)->NeedsLua() && !SkipThisTick( *i, updateAll, currentCenter, semiRegularBand ) ) {
+			Uint64 spriteStart = profiling ? SDL_GetPerformanceCounter() : 0;
+			(*i)->Update( L );
+			if( profiling ) {
+				Profiler::Accumulate( DrawOrderName( (*i)->GetDrawOrder() ), SDL_GetPerformanceCounter() - spriteStart );
+			}
+		}
+	}
+	Profiler::Pop();
+	Uint64 luaTicks = SDL_GetPerformanceCounter() - luaStart;
+
+	// Move sprites within the index as they cross boundaries
+	Uint64 indexStart = SDL_GetPerformanceCounter();
+	Profiler::Push( "Reindex" );
+	index->Reindex( jobs );
+	Profiler::Pop();
+	Uint64 indexTicks = SDL_GetPerformanceCounter() - indexStart;
+
+	// Let Projectiles hit Ships
+	Uint64 collisionStart = SDL_GetPerformanceCounter();
+	Profiler::Push( "Collide" );
+	Collide();
+	Profiler::Pop();
+	Uint64 collisionTicks = SDL_GetPerformanceCounter() - collisionStart;
 
 	// Delete all sprites queued to be deleted
+	PROFILE_SCOPE( "Delete" );
 	if (!spritesToDelete.empty()) {
-		spritesToDelete.sort(); // The list has to be sorted or unique doesn't work correctly.
-		spritesToDelete.unique();
+		vector<Sprite *>::iterator d;
+		sort( spritesToDelete.begin(), spritesToDelete.end() ); // The list has to be sorted or unique doesn't work correctly.
+		spritesToDelete.erase( unique( spritesToDelete.begin(), spritesToDelete.end() ), spritesToDelete.end() );
 
 		// Tell the AI that they've been killed
-		for( i = spritesToDelete.begin(); i != spritesToDelete.end(); ++i ) {
-			if( (*i)->GetDrawOrder() == DRAW_ORDER_SHIP ) {
-				((AI*)(*i))->Killed(L);
+		for( d = spritesToDelete.begin(); d != spritesToDelete.end(); ++d ) {
+			if( (*d)->GetDrawOrder() == DRAW_ORDER_SHIP ) {
+				((AI*)(*d))->Killed(L);
 			}
 		}
 
-		for( i = spritesToDelete.begin(); i != spritesToDelete.end(); ++i ) {
-			DeleteSprite(*i);
+		for( d = spritesToDelete.begin(); d != spritesToDelete.end(); ++d ) {
+			DeleteSprite(*d);
 		}
 		spritesToDelete.clear();
+		ForgetDeleted();
 	}
 
-	for ( iter = quadList.begin(); iter != quadList.end(); ++iter ) {
-		(*iter)->ReBallance();
-	}
-
-	DeleteEmptyQuadrants();
+	// Record the spatial index costs for this tick
+	double frequency = static_cast<double>( SDL_GetPerformanceFrequency() );
+	lastQueryCount = queryCount;
+	lastQueryTime = static_cast<float>( 1000.0 * queryTicks / frequency );
+	lastIndexTime = static_cast<float>( 1000.0 * indexTicks / frequency );
+	lastLuaTime = static_cast<float>( 1000.0 * luaTicks / frequency );
+	lastCollisionTime = static_cast<float>( 1000.0 * collisionTicks / frequency );
+	queryCount = 0;
+	queryTicks = 0;
+	lastNodesAcquired = index->GetNodesAcquired();
+	lastNodeAllocations = index->GetNodeAllocations();
+	index->ResetNodeCounters();
 
 	// Update the tick count after all updates for this tick are done
 	UpdateTickCount();
@@ -273,31 +434,6 @@ int SpriteManager::GetAIShipCount( void ) {
 	return count;
 }
 
-/**\brief Deletes empty QuadTrees (Internal use)
- */
-void SpriteManager::DeleteEmptyQuadrants() {
-	map<Coordinate,QuadTree*>::iterator iter;
-	// Delete QuadTrees that are empty
-	// TODO: Delete QuadTrees that are far away from
-	list<QuadTree*> emptyTrees;
-	// Collect empty trees
-	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
-		if ( iter->second->Count() == 0 ) {
-			emptyTrees.push_back(iter->second);
-		}
-	}
-	// Delete empty trees
-	list<QuadTree*>::iterator emptyIter;
-	for ( emptyIter = emptyTrees.begin(); emptyIter != emptyTrees.end(); ++emptyIter) {
-		//cout<<"Deleting the empty tree at "<<(*emptyIter)->GetCenter()<<endl;
-		trees.erase((*emptyIter)->GetCenter());
-		delete (*emptyIter);
-	}
-	if( emptyTrees.size() ) {
-		AdjustBoundaries();
-	}
-}
-
 /** \brief Comparator function for ordering Sprites
  *
  * \details The goal here is to order the sprites in a deterministic way.
@@ -320,31 +456,115 @@ bool compareSpritePtrs(Sprite* a, Sprite* b){
 	}
 }
 
+/**\brief Finds the Sprites that can be seen this tick.
+ * \details A single spatial query finds every Sprite that could be drawn or
+ *          shown on the Radar.  Only the Sprites that can be drawn have their
+ *          screen coordinates updated.  Draw, the Radar and the Hud reuse these
+ *          sets until the next pass.
+ * \param camera The Camera that the screen follows.
+ * \param radarRange The range of the Radar.
+ * \sa GetOnScreen, GetRadarSprites, IsOnScreen
+ */
+void SpriteManager::UpdateVisibility( Camera *camera, float radarRange ) {
+	vector<Sprite *>::iterator i;
+	float screenRange = (Video::GetHalfHeight() < Video::GetHalfWidth() ? Video::GetHalfWidth() : Video::GetHalfHeight()) * V_SQRT2;
+
+	visibleFocus = camera->GetFocusCoordinate();
+	this->radarRange = radarRange;
+
+	// Zero means that no pass has been made
+	if( ++visiblePass == 0 ) visiblePass = 1;
+
+	nearby.clear();
+	GetSpritesNear( visibleFocus, screenRange > radarRange ? screenRange : radarRange, &nearby, DRAW_ORDER_ALL );
+
+	// Use the same test as the SpatialIndex so that each set matches its own query.
+	onscreen.clear();
+	radar.clear();
+	for( i = nearby.begin(); i != nearby.end(); ++i ) {
+		float distanceSquared = (visibleFocus - (*i)->GetWorldPosition()).GetMagnitudeSquared();
+		float sizeSquared = static_cast<float>( (*i)->GetRadarSize() * (*i)->GetRadarSize() );
+		if( distanceSquared < screenRange*screenRange + sizeSquared ) {
+			onscreen.push_back( *i );
+		}
+		if( distanceSquared < radarRange*radarRange + sizeSquared ) {
+			radar.push_back( *i );
+		}
+	}
+
+	sort( onscreen.begin(), onscreen.end(), compareSpritePtrs );
+
+	for( i = onscreen.begin(); i != onscreen.end(); ++i ) {
+		(*i)->UpdateScreenCoordinates( camera, visiblePass );
+	}
+}
+
+// Matches the Sprites in a sorted list of deleted Sprites.
+struct IsForgotten {
+	IsForgotten( const vector<Sprite*>& _deleted ) : deleted(_deleted) {}
+	bool operator() ( Sprite *sprite ) const {
+		return binary_search( deleted.begin(), deleted.end(), sprite );
+	}
+	const vector<Sprite*>& deleted;
+};
+
+/**\brief Removes the deleted Sprites from the visible sets.
+ * \details One pass over onscreen and radar for every Sprite deleted since the
+ *          last call.  The deleted pointers are only compared, never followed.
+ * \sa DeleteSprite
+ */
+void SpriteManager::ForgetDeleted( void ) {
+	if( forgotten.empty() ) {
+		return;
+	}
+	sort( forgotten.begin(), forgotten.end() );
+	if( !onscreen.empty() ) {
+		onscreen.erase( remove_if( onscreen.begin(), onscreen.end(), IsForgotten( forgotten ) ), onscreen.end() );
+	}
+	if( !radar.empty() ) {
+		radar.erase( remove_if( radar.begin(), radar.end(), IsForgotten( forgotten ) ), radar.end() );
+	}
+	forgotten.clear();
+}
+
+/**\brief The Sprites that should be shown on the Radar.
+ * \details When the Radar range has changed since the last visibility pass,
+ *          the Sprites are found again around the same focus.
+ * \param range The range of the Radar.
+ */
+const vector<Sprite*>& SpriteManager::GetRadarSprites( float range ) {
+	if( range != radarRange ) {
+		radarRange = range;
+		radar.clear();
+		GetSpritesNear( visibleFocus, range, &radar, DRAW_ORDER_ALL );
+	}
+	return radar;
+}
+
 /**\brief Draws the current sprites
+ * \details The Sprites were found by the last UpdateVisibility.  They are
+ *          queued, then drawn with one draw call per texture.
+ * \sa RenderQueue
  */
 void SpriteManager::Draw( Coordinate focus ) {
-	list<Sprite *>::iterator i;
-	list<Sprite*> *onscreen = NULL;
-	float r = (Video::GetHalfHeight() < Video::GetHalfWidth() ? Video::GetHalfWidth() : Video::GetHalfHeight()) * V_SQRT2;
-	onscreen = GetSpritesNear( focus, r, DRAW_ORDER_ALL);
-
-	onscreen->sort(compareSpritePtrs);
+	vector<Sprite *>::iterator i;
 
-	for( i = onscreen->begin(); i != onscreen->end(); ++i ) {
+	for( i = onscreen.begin(); i != onscreen.end(); ++i ) {
 		(*i)->Draw();
 	}
 
-	delete onscreen;
+	RenderQueue::Flush();
 }
 
 /**\brief Draws the current sprites
  */
 void SpriteManager::DrawQuadrantMap( Coordinate focus ) {
-	GetQuadrant( focus )->Draw( GetQuadrantCenter( focus ) );
+	index->Draw( focus );
 }
 
 /**\brief Retrieves a list of the current sprites.
- * \return std::list of Sprite pointers.
+ * \return std::list of Sprite pointers.  The caller must delete it.
+ * \see GetSprites(vector<Sprite*>*,int,SpriteFilter*)
  */
 list<Sprite *> *SpriteManager::GetSprites(int type) {
 	list<Sprite *>::iterator i;
@@ -363,128 +583,43 @@ list<Sprite *> *SpriteManager::GetSprites(int type) {
 	return( filtered);
 }
 
+/**\brief Collect the current sprites into a caller-owned buffer.
+ * \param sprites [out] Matching Sprites are appended.  Reuse this between calls to avoid allocating.
+ * \param type A DRAW_ORDER mask.
+ * \param filter If given, only Sprites that it accepts are collected.
+ */
+void SpriteManager::GetSprites(vector<Sprite*> *sprites, int type, SpriteFilter *filter) {
+	list<Sprite *>::iterator i;
+	for( i = spritelist->begin(); i != spritelist->end(); ++i ) {
+		if( ((*i)->GetDrawOrder() & type) && ( filter == NULL || filter->Accept(*i) ) ) {
+			sprites->push_back( (*i) );
+		}
+	}
+}
+
 /**\brief Queries for sprite by the ID
  * \param id Identification of the sprite.
  */
 Sprite *SpriteManager::GetSpriteByID(int id) {
-	map<int,Sprite*>::iterator val = spritelookup->find( id );
+	unordered_map<int,Sprite*>::iterator val = spritelookup->find( id );
 	if( val != spritelookup->end() ){
 		return val->second;
 	}
 	return NULL;
 }
 
-/**\brief Retrieves nearby QuadTrees in a square band at <bandIndex> quadrants distant from the coordinate
- * \param c Coordinate
- * \param bandIndex number of quadrants distant from c
- * \return std::list of QuadTree pointers.
- */
-list<QuadTree*> SpriteManager::GetQuadrantsInBand ( Coordinate c, int bandIndex) {
-	// The possibleQuadrants here are the quadrants that are in the square band
-	//  at distance bandIndex from the coordinate
-	// After we get the possible quadrants we prune them by making sure they exist
-	//  (ie that something is in them)
-
-	list<QuadTree*> nearbyQuadrants;
-	set<Coordinate> possibleQuadrants;
-
-	//note that the QUADRANTSIZE define is the
-	//	distance from the middle to the edge of a quadrant
-	//to get the square band of co-ordinates we have to
-	//		- start at bottom left
-	//			loop over increasing Y (to get 'west' line)
-	//			loop over increasing X (to get 'south' line)
-	//		- start at top right
-	//			loop over decreasing Y (to get 'east' line)
-	//			loop over decreasing X (to get 'north' line)
-
-	int edgeDistance = bandIndex * QUADRANTSIZE * 2;		//number of pixels from middle to the band
-	Coordinate bottomLeft (c - Coordinate (edgeDistance, edgeDistance));
-	Coordinate topLeft (c + Coordinate (-edgeDistance, edgeDistance));
-	Coordinate topRight (c + Coordinate (edgeDistance, edgeDistance));
-	Coordinate bottomRight (c + Coordinate (edgeDistance, -edgeDistance));
-
-	//the 'full' length of one of the lines is (bandindex * 2) + 1
-	//we don't need the +1 as we deal with the corners individually, separately
-	int bandLength = (bandIndex * 2);
-
-	//deal with the un-included corners first
-	//we're using bottomLeft and topRight as the anchors,
-	// so topLeft and bottomRight are added here
-	possibleQuadrants.insert (GetQuadrantCenter (topLeft));
-	possibleQuadrants.insert (GetQuadrantCenter (bottomRight));
-	for (int i = 0; i < bandLength; i ++) {
-		int offset = ((QUADRANTSIZE * 2) * i);
-		Coordinate west, south, north, east;
-
-		west = GetQuadrantCenter (bottomLeft + Coordinate (0, offset));
-		south = GetQuadrantCenter (bottomLeft + Coordinate (offset, 0));
-		north = GetQuadrantCenter (topRight - Coordinate (offset, 0));
-		east = GetQuadrantCenter (topRight - Coordinate (0, offset));
-
-		possibleQuadrants.insert (west);		//west
-		possibleQuadrants.insert (south);		//south
-		possibleQuadrants.insert (north);		//north
-		possibleQuadrants.insert (east);		//east
-	}
-
-	//here we're checking to see if this possible quadrant is one of the existing quadrants
-	// and if it is then we add its QuadTree to the vector we're returning
-	// if it's not then there's nothing in it anyway so we don't care about it
-	set<Coordinate>::iterator it;
-	map<Coordinate,QuadTree*>::iterator iter;
-	for(it = possibleQuadrants.begin(); it != possibleQuadrants.end(); ++it) {
-		iter = trees.find(*it);
-		if(iter != trees.end()) {
-			nearbyQuadrants.push_back(iter->second);
-		}
-
-	}
-	return nearbyQuadrants;
-}
-
-
-/**\brief Retrieves nearby QuadTrees
- * \param c Coordinate
- * \param r Radius
- * \return std::list of QuadTree pointers.
- */
-list<QuadTree*> SpriteManager::GetQuadrantsNear( Coordinate c, float r) {
-	// The possibleQuadrants are those trees adjacent and within a radius r
-	// Gather more trees when r is greater than the size of a quadrant
-	map<Coordinate,QuadTree*>::iterator iter;
-	list<QuadTree*> nearbyQuadrants;
-	set<Coordinate> possibleQuadrants;
-
-	Coordinate center = GetQuadrantCenter(c);
-
-	possibleQuadrants.insert( center );
-	float R = r;
-	do{
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-R,-0)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-0,+R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+0,-R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+R,+0)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-R,-R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-R,+R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+R,-R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+R,+R)));
-		R/=2;
-	} while(R>QUADRANTSIZE);
-	set<Coordinate>::iterator it;
-	for(it = possibleQuadrants.begin(); it != possibleQuadrants.end(); ++it) {
-		//here we're checking to see if this possible quadrant is one of the existing quadrants
-		// and if it is then we add its QuadTree to the vector we're returning
-		//how about we try creating the quadrant if it does not already exist
-		iter = trees.find(*it);
-		if(iter != trees.end() && iter->second->PossiblyNear(c,r)){
-			nearbyQuadrants.push_back(iter->second);
-		}
+/**\brief Get the handle of a Sprite from its ID.
+ * \details Look up the handle once and then use GetSprite to avoid the ID lookup.
+ * \returns A null handle if there is no such Sprite.
+ */
+SpriteHandle SpriteManager::GetHandleByID(int id) {
+	Sprite *sprite = GetSpriteByID( id );
+	if( sprite == NULL ) {
+		return SpriteHandle();
 	}
-	return nearbyQuadrants;
+	return sprite->GetHandle();
 }
 
-
 /**\brief Creates a binary comparison object that can be passed to stl sort.
  * Sprites will be sorted by distance from the point in ascending order.
  * \relates Sprite
@@ -510,29 +645,71 @@ struct compareSpriteDistFromPoint
 	Coordinate point;
 };
 
+// Appends the visited Sprites to a list or vector, optionally filtered.
+template<class Container>
+class SpriteCollector : public SpriteVisitor {
+	public:
+		SpriteCollector( Container *_sprites, SpriteFilter *_filter ) : sprites( _sprites ), filter( _filter ) {}
+		void Visit( Sprite *sprite ) {
+			if( filter == NULL || filter->Accept( sprite ) ) {
+				sprites->push_back( sprite );
+			}
+		}
+	private:
+		Container *sprites;
+		SpriteFilter *filter;
+};
+
 /**\brief Returns a list of sprites that are near coordinate.
  * \param c Coordinate
  * \param r Radius
- * \return std::list of Sprite pointers.
+ * \return std::list of Sprite pointers, sorted by distance.  The caller must delete it.
+ * \see GetSpritesNear(Coordinate,float,vector<Sprite*>*,int,bool,SpriteFilter*)
  */
 list<Sprite*> *SpriteManager::GetSpritesNear(Coordinate c, float r, int type) {
 	list<Sprite*> *sprites = new list<Sprite*>();
+	SpriteCollector< list<Sprite*> > collector( sprites, NULL );
 
-	// Search the possible quadrants
-	list<QuadTree*> nearbyQuadrants = GetQuadrantsNear(c,r);
-	list<QuadTree*>::iterator it;
-	for(it = nearbyQuadrants.begin(); it != nearbyQuadrants.end(); ++it) {
-			list<Sprite *>* nearby = new list<Sprite*>;
-			(*it)->GetSpritesNear(c,r,nearby,type);
-			sprites->splice(sprites->end(), *nearby);
-			delete nearby;
-	}
+	VisitSpritesNear( c, r, &collector, type );
 
 	// Sort sprites by their distance from the coordinate c
 	sprites->sort(compareSpriteDistFromPoint(c));
 	return( sprites );
 }
 
+/**\brief Collect the sprites that are near a coordinate into a caller-owned buffer.
+ * \param c Coordinate
+ * \param r Radius
+ * \param nearby [out] Matching Sprites are appended.  Reuse this between calls to avoid allocating.
+ * \param type A DRAW_ORDER mask.
+ * \param sortByDistance Sort the appended Sprites by their distance from c.
+ * \param filter If given, only Sprites that it accepts are collected.
+ */
+void SpriteManager::GetSpritesNear(Coordinate c, float r, vector<Sprite*> *nearby, int type, bool sortByDistance, SpriteFilter *filter) {
+	size_t start = nearby->size();
+	SpriteCollector< vector<Sprite*> > collector( nearby, filter );
+
+	VisitSpritesNear( c, r, &collector, type );
+
+	if( sortByDistance ) {
+		sort( nearby->begin() + start, nearby->end(), compareSpriteDistFromPoint(c) );
+	}
+}
+
+/**\brief Call a visitor for every sprite that is near a coordinate.
+ * \details The Sprites are visited in no particular order.
+ *          The visitor must not add or delete Sprites.
+ * \param c Coordinate
+ * \param r Radius
+ * \param visitor Called once for each Sprite.
+ * \param type A DRAW_ORDER mask.
+ */
+void SpriteManager::VisitSpritesNear(Coordinate c, float r, SpriteVisitor *visitor, int type) {
+	Uint64 start = SDL_GetPerformanceCounter();
+	index->GetSpritesNear( c, r, visitor, type );
+	RecordQuery( SDL_GetPerformanceCounter() - start );
+}
+
 /**\brief Get a Sprite nearest to another Sprite.
  * \details Rather than just accept a Coordinate, this requires another Sprite
  *          because the common usage is to look for a nearby enemy or
@@ -553,31 +730,40 @@ list<Sprite*> *SpriteManager::GetSpritesNear(Coordinate c, float r, int type) {
  * \todo Build the Dummy example above into the SpriteManager.
  *
  */
-Sprite* SpriteManager::GetNearestSprite(Sprite* obj, float r, int type) {
-	float tmpdist;
-	Sprite* closest=NULL;
-	Sprite* possible=NULL;
+Sprite* SpriteManager::GetNearestSprite(Sprite* obj, float r, int type, SpriteFilter *filter) {
 	if(obj==NULL)
 		return (Sprite*)NULL;
-	list<QuadTree*> nearbyQuadrants = GetQuadrantsNear(obj->GetWorldPosition(),r);
-	list<QuadTree*>::iterator it;
-	for(it = nearbyQuadrants.begin(); it != nearbyQuadrants.end(); ++it) {
-		possible = (*it)->GetNearestSprite(obj,r, type);
-		if(possible!=NULL) {
-			tmpdist = (obj->GetWorldPosition()-possible->GetWorldPosition()).GetMagnitude();
-			if(tmpdist<r) {
-				r = tmpdist;
-				closest = possible;
-			}
-		}
-	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	Sprite* closest = index->GetNearestSprite( obj, r, type, filter );
+	RecordQuery( SDL_GetPerformanceCounter() - start );
+
 	return closest;
 }
 
-Sprite* SpriteManager::GetNearestSprite(Coordinate c, float r, int type) {
+// A Sprite that only has a position, used to search around a Coordinate.
+// Unlike an Effect, it does not load anything, so it is safe on worker threads.
+class PointSprite : public Sprite {
+	public:
+		PointSprite( Coordinate c ) { SetWorldPosition( c ); }
+		int GetDrawOrder( void ) { return 0; }
+		void Draw( void ) {}
+};
+
+Sprite* SpriteManager::GetNearestSprite(Coordinate c, float r, int type, SpriteFilter *filter) {
 	// This dummy variable is a local variable and will be deleted immediately after.
-	Effect dummy( c, "data/animations/shield.ani", 0);
-	return GetNearestSprite( &dummy, r, type );
+	PointSprite dummy( c );
+	return GetNearestSprite( &dummy, r, type, filter );
+}
+
+/**\brief Add one spatial query to this tick's statistics.
+ * \details Queries may run on several threads at once.
+ */
+void SpriteManager::RecordQuery( Uint64 ticks ) {
+	SDL_AtomicLock( &queryLock );
+	queryTicks += ticks;
+	queryCount++;
+	SDL_AtomicUnlock( &queryLock );
 }
 
 /**\brief Returns QuadTree center.
@@ -585,54 +771,41 @@ Sprite* SpriteManager::GetNearestSprite(Coordinate c, float r, int type) {
  * \return Coordinate of centerpointer
  */
 Coordinate SpriteManager::GetQuadrantCenter(Coordinate point){
-	// Figure out where the new Tree should go.
-	// Quadrants are tiled adjacent to the central Quadrant centered at (0,0).
-	double cx, cy;
-	cx = float(floor( (point.GetX()+QUADRANTSIZE)/(QUADRANTSIZE*2.0f)) * QUADRANTSIZE*2.f);
-	cy = float(floor( (point.GetY()+QUADRANTSIZE)/(QUADRANTSIZE*2.0f)) * QUADRANTSIZE*2.f);
-	return Coordinate(cx,cy);
+	return QuadTreeIndex::GetQuadrantCenter( point );
 }
 
-/**\brief Gets the number of Sprites in the SpriteManager
+/**\brief Returns the number of the square band of Quadrants around center that contains point.
+ * \details Band 0 is the Quadrant centered on center, band 1 is the ring of
+ *          eight Quadrants around it, and so on.
+ * \param center The center of a Quadrant.
+ * \param point Coordinate
  */
-int SpriteManager::GetNumSprites() {
-	unsigned int total = 0;
-	map<Coordinate,QuadTree*>::iterator iter;
-
-	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
-		total += iter->second->Count();
-	}
-
-	assert( total == spritelist->size() );
-	assert( total == spritelookup->size() );
-
-	return total;
+int SpriteManager::GetBand( Coordinate center, Coordinate point ) {
+	Coordinate offset = GetQuadrantCenter( point ) - center;
+	double distance = max( fabs( offset.GetX() ), fabs( offset.GetY() ) );
+	return TO_INT( floor( distance / (QUADRANTSIZE*2.0f) + 0.5 ) );
 }
 
-/**\brief Returns QuadTree at Coordinate
- * \param point Coordinate
+/**\brief Whether a Sprite is outside of the bands updated by this tick of the wave update.
  */
-QuadTree* SpriteManager::GetQuadrant( Coordinate point ) {
-	Coordinate treeCenter = GetQuadrantCenter(point);
-
-	// Check in the known Quadrant
-	map<Coordinate,QuadTree*>::iterator iter;
-	iter = trees.find( treeCenter );
-	if( iter != trees.end() ) {
-		return iter->second;
+bool SpriteManager::SkipThisTick( Sprite *sprite, bool updateAll, Coordinate currentCenter, int semiRegularBand ) {
+	if( updateAll ) {
+		return false;
 	}
+	int band = GetBand( currentCenter, sprite->GetWorldPosition() );
+	return ( band > numRegularBands && band != semiRegularBand );
+}
 
-	// Create the new Tree and attach it to the universe
-	QuadTree *newTree = new QuadTree(treeCenter, QUADRANTSIZE);
-	assert(treeCenter == newTree->GetCenter() );
-	assert(newTree->Contains(point));
-	trees.insert(make_pair(treeCenter, newTree));
-	AdjustBoundaries();
+/**\brief Gets the number of Sprites in the SpriteManager
+ */
+int SpriteManager::GetNumSprites() {
+	unsigned int total = index->Count();
 
-	// Debug
-	//cout<<"A Tree at "<<treeCenter<<" was created to contain "<<point<<". "<<trees.size()<<" Quadrants exist now."<<endl;
+	assert( total == spritelist->size() );
+	assert( total == spritelookup->size() );
+	assert( total == slots.Size() );
 
-	return newTree;
+	return total;
 }
 
 /**\brief Get the min/max planet positions. Useful when generating traffic.
@@ -658,33 +831,15 @@ void SpriteManager::GetBoundaries(float *north, float *south, float *east, float
 	}
 }
 
-/** Adjust the Edges based on the locations of the populated QuadTrees
- */
-void SpriteManager::AdjustBoundaries()
-{
-	Coordinate c;
-	map<Coordinate,QuadTree*>::iterator iter;
-
-	northEdge = southEdge = eastEdge = westEdge = 0;
-	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
-		c = iter->first;
-		if( c.GetY() > northEdge) northEdge = c.GetY();
-		if( c.GetY() < southEdge) southEdge = c.GetY();
-		if( c.GetX() > eastEdge)  eastEdge  = c.GetX();
-		if( c.GetX() < westEdge)  westEdge  = c.GetX();
-	}
-}
-
 /**\brief Save an XML file of all of the Sprites.
  * \details
- * Traverse each Quadtree looking for sprites.
+ * Traverse the SpatialIndex looking for sprites.
  * Each Sprite will be an XML node.
- * Each Quadtee Leaf or Node will be an XML Node.
+ * For the QuadTree index, each Quadtee Leaf or Node will be an XML Node.
  *
- * The point of this is to create a file that could be useful for debugging quadtree problems.
+ * The point of this is to create a file that could be useful for debugging spatial index problems.
  */
 void SpriteManager::Save() {
-	map<Coordinate,QuadTree*>::iterator iter;
 	xmlDocPtr doc = NULL;       /* document pointer */
 	xmlNodePtr root_node = NULL;/* node pointers */
 
@@ -692,9 +847,7 @@ void SpriteManager::Save() {
 	root_node = xmlNewNode(NULL, BAD_CAST "Sprites" );
 	xmlDocSetRootElement(doc, root_node);
 
-	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
-		xmlAddChild( root_node, iter->second->ToNode() );
-	}
+	index->Save( root_node );
 
 	xmlSaveFormatFileEnc( "Sprites.xml" , doc, "ISO-8859-1", 1);
 	xmlFreeDoc( doc );
@@ -710,22 +863,4 @@ void SpriteManager::UpdateTickCount ()
 		tickCount -= fullUpdatePeriod;
 }
 
-/**\brief Populate a list of all Quadtrees.
- * \details Used for looping between all Quadrants.
- * \warn
- * This is not very efficient, but std::transform doesn't work...
- * (if for some reason we got transform working, the idea would be to have
- *   a helper method to get map->second to pass as the 4th argument of transform
- *   with the third argument being a back_inserter into the list we want)
- */
-void SpriteManager::GetAllQuadrants (list<QuadTree*> *newList)
-{
-	map<Coordinate,QuadTree*>::iterator mapIter = trees.begin();
-	while (mapIter != trees.end())
-	{
-		newList->push_back (mapIter->second);
-		++ mapIter;
-	}
-}
-
 /** @} */
@@ -9,8 +9,16 @@
 #ifndef __H_SPRITEMANAGER__
 #define __H_SPRITEMANAGER__
 
+#include "sprites/kinematics.h"
 #include "sprites/sprite.h"
+#include "sprites/spritehandle.h"
+#include "sprites/thinkscheduler.h"
+#include "utilities/broadphase.h"
+#include "utilities/jobsystem.h"
 #include "utilities/quadtree.h"
+#include "utilities/spatialindex.h"
+
+class Camera;
 
 class SpriteManager {
 	public:
@@ -25,35 +33,80 @@ class SpriteManager {
 		void DeleteAllExceptPlayer( void );
 
 		void Update( lua_State *L, bool lowFps);
-		void UpdateScreenCoordinates( void );
+		void UpdateVisibility( Camera *camera, float radarRange );
 		void Draw( Coordinate focus );
 		void DrawQuadrantMap( Coordinate focus );
 
 		int GetAIShipCount( void );
 
 		Sprite *GetSpriteByID(int id);
+		Sprite *GetSprite(SpriteHandle handle) { return slots.Get( handle ); }
+		SpriteHandle GetHandleByID(int id);
 		list<Sprite*> *GetSprites(int type = DRAW_ORDER_ALL);
 		list<Sprite*> *GetSpritesNear(Coordinate c, float r, int type = DRAW_ORDER_ALL);
-		Sprite* GetNearestSprite(Sprite *obj, float r, int type = DRAW_ORDER_ALL);
-		Sprite* GetNearestSprite(Coordinate c, float r, int type = DRAW_ORDER_ALL);
+		Sprite* GetNearestSprite(Sprite *obj, float r, int type = DRAW_ORDER_ALL, SpriteFilter *filter = NULL);
+		Sprite* GetNearestSprite(Coordinate c, float r, int type = DRAW_ORDER_ALL, SpriteFilter *filter = NULL);
+
+		// Queries that fill a caller-owned buffer or call a visitor instead of allocating a list.
+		void GetSprites(vector<Sprite*> *sprites, int type = DRAW_ORDER_ALL, SpriteFilter *filter = NULL);
+		void GetSpritesNear(Coordinate c, float r, vector<Sprite*> *nearby, int type = DRAW_ORDER_ALL, bool sortByDistance = false, SpriteFilter *filter = NULL);
+		void VisitSpritesNear(Coordinate c, float r, SpriteVisitor *visitor, int type = DRAW_ORDER_ALL);
 
 		Coordinate GetQuadrantCenter( Coordinate point );
-		int GetNumQuadrants() { return trees.size(); }
+		int GetNumQuadrants() { return index->GetNumRegions(); }
 		int GetNumSprites();
 		void GetBoundaries(float *northEdge, float *southEdge, float *eastEdge, float *westEdge);
 
+		// The Sprites found by the last UpdateVisibility.
+		const vector<Sprite*>& GetOnScreen() { return onscreen; }
+		const vector<Sprite*>& GetRadarSprites( float range );
+		bool IsOnScreen( Sprite *sprite ) { return visiblePass != 0 && sprite->GetScreenPass() == visiblePass; }
+
+		string GetSpatialIndexName() { return index->GetName(); }
+		Uint32 GetQueryCount() { return lastQueryCount; }
+		float GetQueryTime() { return lastQueryTime; }
+		float GetIndexTime() { return lastIndexTime; }
+		float GetLuaTime() { return lastLuaTime; }
+		float GetCollisionTime() { return lastCollisionTime; }
+		Uint32 GetNodesAcquired() { return lastNodesAcquired; }
+		Uint32 GetNodeAllocations() { return lastNodeAllocations; }
+		Uint32 GetNumIndexNodes() { return index->GetNumNodes(); }
+		Uint64 GetIndexNodeBytes() { return index->GetNodeBytes(); }
+
+		ThinkScheduler* GetThinkScheduler() { return &thinking; }
+
 		void Save();
 
 	private:
 		// These structures each contain a complete list of all Sprites.
 		// Each one is useful for a different purpose, depending on the way that the sprites need to be accessed.
-		map<Coordinate,QuadTree*> trees;    ///< Collection of all Sprites. Use this tree when referring to the sprites at a location.
+		SpatialIndex *index;                ///< Collection of all Sprites. Use this index when referring to the sprites at a location.
 		list<Sprite*> *spritelist;          ///< Collection of all Sprites. Use this list when referring to all sprites.
-		map<int,Sprite*> *spritelookup;     ///< Collection of all Sprites. Use the map when referring to sprites by their unique ID.
+		unordered_map<int,Sprite*> *spritelookup; ///< Collection of all Sprites. Use the map when referring to sprites by their unique ID.
+		SpriteSlotMap slots;                ///< Collection of all Sprites. Use the slots when referring to sprites by their SpriteHandle.
+		KinematicsStore kinematics;         ///< The positions and momentum of all Sprites.  Moves every Sprite at once.
 
 		Sprite *player;                     ///< The Player Sprite.
 
-		list<Sprite *> spritesToDelete;     ///< The list of Sprites that should be deleted at the end of this Update.
+		vector<Sprite *> spritesToDelete;   ///< The Sprites that should be deleted at the end of this Update.  Kept between ticks to avoid reallocating.
+		SDL_mutex *deleteLock;              ///< Guards spritesToDelete while Sprites are updated on worker threads.
+
+		ThinkScheduler thinking;            ///< Decides which AI run their state machine this tick.
+
+		JobSystem *jobs;                    ///< Worker threads for the Lua free parts of Update.
+		vector<Sprite*> luaFree;            ///< The Sprites updated on worker threads this tick.
+
+		// The visible Sprites are found once per tick and shared by Draw, the Radar and the Hud.
+		vector<Sprite*> nearby;             ///< Every Sprite within the screen or radar range.  Kept between ticks to avoid reallocating.
+		vector<Sprite*> onscreen;           ///< The Sprites being drawn, in draw order.
+		vector<Sprite*> radar;              ///< The Sprites within radarRange of visibleFocus.
+		vector<Sprite*> forgotten;          ///< The Sprites deleted since onscreen and radar were last compacted.  Kept between ticks to avoid reallocating.
+		Coordinate visibleFocus;            ///< The Camera focus during the last visibility pass.
+		float radarRange;                   ///< The range used to fill radar.
+		Uint32 visiblePass;                 ///< Counts the visibility passes.  Sprites stamped with this pass are on screen.
+
+		Broadphase broadphase;              ///< Finds Projectiles that hit Ships.
+		vector<Collision> collisions;       ///< The Projectiles that hit something this tick.
 
 		int tickCount;                      ///< Counts number of ticks to track updates to quadrants.  Max value is the number of ticks to update all quadrants
 		const int semiRegularPeriod;        ///< The period at which every semi-regular quadrant is updated
@@ -63,17 +116,25 @@ class SpriteManager {
 		const int numSemiRegularBands;      ///< The number of bands surrounding the centre point that are updated semi-regularly
 		map<int, int> ticksToBandNum;       ///< The key is the tick# that the value band# will be updated at
 
-		float northEdge, southEdge, eastEdge, westEdge; ///< The Edges of the universe
+		// Spatial index statistics, so that the index backends can be compared.
+		Uint32 queryCount;                  ///< Number of spatial queries since the last Update.
+		Uint64 queryTicks;                  ///< Time spent in spatial queries since the last Update.
+		SDL_SpinLock queryLock;             ///< Guards queryCount and queryTicks.
+		Uint32 lastQueryCount;              ///< Number of spatial queries during the last tick.
+		float lastQueryTime;                ///< Milliseconds spent in spatial queries during the last tick.
+		float lastIndexTime;                ///< Milliseconds spent re-indexing Sprites during the last tick.
+		float lastLuaTime;                  ///< Milliseconds spent updating the Sprites that need Lua during the last tick.
+		float lastCollisionTime;            ///< Milliseconds spent checking collisions during the last tick.
+		Uint32 lastNodesAcquired;           ///< Spatial index nodes handed out during the last tick, reused or newly allocated.
+		Uint32 lastNodeAllocations;         ///< Heap allocations for spatial index nodes during the last tick.
 
 		bool DeleteSprite( Sprite *sprite );
-		void DeleteEmptyQuadrants( void );
-		QuadTree* GetQuadrant( Coordinate point );
-		list<QuadTree*> GetQuadrantsNear( Coordinate c, float r);
-		list<QuadTree*> GetQuadrantsInBand ( Coordinate c, int bandIndex);
-		void AdjustBoundaries();
+		void ForgetDeleted( void );
+		void Collide( void );
+		void RecordQuery( Uint64 ticks );
+		int GetBand( Coordinate center, Coordinate point );
+		bool SkipThisTick( Sprite *sprite, bool updateAll, Coordinate currentCenter, int semiRegularBand );
 		void UpdateTickCount();
-
-		void GetAllQuadrants( list<QuadTree*> *newTree);
 };
 
 #endif // __H_SPRITEMANAGER__
@@ -0,0 +1,98 @@
+/**\file			spritepool.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Recycles the memory of short lived Sprites
+ * \details
+ */
+
+#include "includes.h"
+#include "sprites/spritepool.h"
+
+/**\class SpritePool
+ * \brief A free list of slots for one class of Sprite.
+ * \details
+ * Projectiles and Effects only live for a moment, but a battle creates
+ * thousands of them every second.  Those classes replace operator new and
+ * operator delete with Allocate and Free on their own SpritePool, so that
+ * creating one runs its constructor on a recycled slot and deleting one, as
+ * SpriteManager::DeleteSprite does, puts the slot back.
+ *
+ * Slots are allocated SPRITEPOOL_BLOCKSIZE at a time and are never returned
+ * to the heap, so the capacity is the most that were alive at once, rounded
+ * up to a whole block.
+ * \see QuadTreePool
+ */
+
+/**\brief Constructs an empty pool.
+ * \param name What the pool holds, for the stats.  A string literal.
+ * \param objectSize The size of the class that uses this pool.
+ */
+SpritePool::SpritePool( const char *name, size_t objectSize ) {
+	this->name = name;
+	this->objectSize = objectSize;
+	capacity = 0;
+	highWater = 0;
+	lock = 0;
+}
+
+/**\brief Frees every block.
+ * \note Objects that were never deleted are freed without being destroyed.
+ */
+SpritePool::~SpritePool() {
+	for( unsigned int b = 0; b < blocks.size(); b++ ) {
+		delete [] blocks[b];
+	}
+}
+
+/**\brief Get a slot for a new object.
+ * \param size Must be the objectSize.  Classes derived from a pooled class
+ *             must not be created with new.
+ */
+void* SpritePool::Allocate( size_t size ) {
+	assert( size == objectSize );
+	SDL_AtomicLock( &lock );
+	if( freeSlots.empty() ) {
+		Grow();
+	}
+	void *slot = freeSlots.back();
+	freeSlots.pop_back();
+	if( GetInUse() > highWater ) {
+		highWater = GetInUse();
+	}
+	SDL_AtomicUnlock( &lock );
+	return slot;
+}
+
+/**\brief Return the slot of a destroyed object.
+ */
+void SpritePool::Free( void *object ) {
+	if( object == NULL ) {
+		return;
+	}
+	SDL_AtomicLock( &lock );
+	freeSlots.push_back( object ); // Never reallocates, see Grow
+	SDL_AtomicUnlock( &lock );
+}
+
+/**\brief Add another block of slots.
+ */
+void SpritePool::Grow( void ) {
+	// new[] of char is aligned for any object that fits in it, and objectSize
+	// is a multiple of the alignment of the class.
+	char *block = new char[ objectSize * SPRITEPOOL_BLOCKSIZE ];
+	blocks.push_back( block );
+	capacity += SPRITEPOOL_BLOCKSIZE;
+	// Reserve room for every slot so that Free never has to allocate.
+	freeSlots.reserve( capacity );
+	for( int s = SPRITEPOOL_BLOCKSIZE - 1; s >= 0; s-- ) {
+		freeSlots.push_back( block + s * objectSize );
+	}
+}
+
+/**\brief Print the use of the pool.
+ */
+void SpritePool::Print( void ) {
+	printf( "%s pool: %u in use, %u at most, %u slots in %u blocks\n",
+		name, GetInUse(), highWater, capacity, GetAllocations() );
+}
@@ -0,0 +1,45 @@
+/**\file			spritepool.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Recycles the memory of short lived Sprites
+ * \details
+ */
+
+#ifndef __H_SPRITEPOOL__
+#define __H_SPRITEPOOL__
+
+#include "includes.h"
+
+#define SPRITEPOOL_BLOCKSIZE 128
+
+class SpritePool {
+	public:
+		SpritePool( const char *name, size_t objectSize );
+		~SpritePool();
+
+		void* Allocate( size_t size );
+		void Free( void *object );
+
+		const char* GetName( void ) { return name; }
+		size_t GetObjectSize( void ) { return objectSize; }
+		unsigned int GetCapacity( void ) { return capacity; }
+		unsigned int GetInUse( void ) { return capacity - freeSlots.size(); }
+		unsigned int GetHighWater( void ) { return highWater; }
+		unsigned int GetAllocations( void ) { return blocks.size(); }
+
+		void Print( void );
+
+	private:
+		void Grow( void );
+
+		const char *name;
+		size_t objectSize;
+		vector<char*> blocks;     ///< Every block of SPRITEPOOL_BLOCKSIZE objects.
+		vector<void*> freeSlots;  ///< Slots that are ready to be reused.
+		unsigned int capacity;    ///< Total number of slots in all blocks.
+		unsigned int highWater;   ///< The most slots that were ever in use at once.
+		SDL_SpinLock lock;
+};
+
+#endif // __H_SPRITEPOOL__
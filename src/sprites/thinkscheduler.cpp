@@ -0,0 +1,99 @@
+/**\file			thinkscheduler.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Decides how often each AI runs its state machine
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "sprites/sprite.h"
+#include "sprites/thinkscheduler.h"
+#include "utilities/quadtree.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class ThinkScheduler
+ * \brief Level of detail for the AI.
+ * \details
+ * Running the Lua state machine is the most expensive part of an AI, but
+ * nobody can see how quickly a ship on the other side of the sector reacts.
+ * Each tick, the ThinkScheduler sorts the AI into tiers by their distance
+ * from the camera focus:
+ * - Within one screen, an AI thinks every "options/simulation/ai-think-near" ticks.
+ * - Within the same Quadrant, every "options/simulation/ai-think-quadrant" ticks.
+ * - Anywhere else, every "options/simulation/ai-think-far" ticks.
+ *
+ * An AI that is fighting always thinks every tick.  Setting
+ * "options/simulation/ai-lod" to 0 makes every AI think every tick.
+ *
+ * Only thinking is skipped.  Ships still move, and still fly in whichever
+ * direction their last thought sent them.  The AI in each tier are staggered
+ * by their ID so that they do not all think during the same tick.
+ *
+ * \see AI::Update
+ */
+
+/**\brief Reads the tiers from the options.
+ */
+ThinkScheduler::ThinkScheduler() {
+	enabled = OPTION(int, "options/simulation/ai-lod") != 0;
+	nearPeriod = max( 1, OPTION(int, "options/simulation/ai-think-near") );
+	quadrantPeriod = max( 1, OPTION(int, "options/simulation/ai-think-quadrant") );
+	farPeriod = max( 1, OPTION(int, "options/simulation/ai-think-far") );
+
+	nearSquared = 0.0f;
+	tick = 0;
+	thinks = skips = 0;
+	lastThinks = lastSkips = 0;
+}
+
+/**\brief Start scheduling a new tick.
+ * \param focus Where the camera is looking.
+ * \param screenRadius How far from the focus counts as "within one screen".
+ */
+void ThinkScheduler::BeginTick( Coordinate focus, float screenRadius ) {
+	this->focus = focus;
+	focusQuadrant = QuadTreeIndex::GetQuadrantCenter( focus );
+	nearSquared = screenRadius * screenRadius;
+	tick++;
+
+	lastThinks = thinks;
+	lastSkips = skips;
+	thinks = skips = 0;
+}
+
+/**\brief Whether an AI should run its state machine this tick.
+ */
+bool ThinkScheduler::ShouldThink( Sprite *ai, bool inCombat ) {
+	int period = 1;
+
+	if( enabled && !inCombat ) {
+		Coordinate position = ai->GetWorldPosition();
+		if( (position - focus).GetMagnitudeSquared() <= nearSquared ) {
+			period = nearPeriod;
+		} else if( SameQuadrant( QuadTreeIndex::GetQuadrantCenter( position ) ) ) {
+			period = quadrantPeriod;
+		} else {
+			period = farPeriod;
+		}
+	}
+
+	if( (tick + ai->GetID()) % period == 0 ) {
+		thinks++;
+		return true;
+	}
+	skips++;
+	return false;
+}
+
+/**\brief Whether a Quadrant center is the focus Quadrant.
+ */
+bool ThinkScheduler::SameQuadrant( Coordinate quadrant ) {
+	return quadrant.GetX() == focusQuadrant.GetX() && quadrant.GetY() == focusQuadrant.GetY();
+}
+
+/** @} */
@@ -0,0 +1,44 @@
+/**\file			thinkscheduler.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Decides how often each AI runs its state machine
+ * \details
+ */
+
+#ifndef __H_THINKSCHEDULER__
+#define __H_THINKSCHEDULER__
+
+#include "includes.h"
+#include "utilities/coordinate.h"
+
+class Sprite;
+
+class ThinkScheduler {
+	public:
+		ThinkScheduler();
+
+		void BeginTick( Coordinate focus, float screenRadius );
+		bool ShouldThink( Sprite *ai, bool inCombat );
+
+		Uint32 GetThinks( void ) { return lastThinks; }
+		Uint32 GetSkips( void ) { return lastSkips; }
+
+	private:
+		bool SameQuadrant( Coordinate quadrant );
+
+		bool enabled;            ///< When false, every AI thinks every tick.
+		int nearPeriod;          ///< Ticks between thoughts within one screen of the focus.
+		int quadrantPeriod;      ///< Ticks between thoughts within the focus Quadrant.
+		int farPeriod;           ///< Ticks between thoughts anywhere else.
+
+		Coordinate focus;        ///< The camera focus this tick.
+		Coordinate focusQuadrant; ///< The center of the Quadrant that contains the focus.
+		float nearSquared;       ///< The square of the near distance.
+		Uint32 tick;             ///< Counts every tick, so that each AI is staggered.
+
+		Uint32 thinks, skips;         ///< Decisions made during this tick.
+		Uint32 lastThinks, lastSkips; ///< Decisions made during the previous tick.
+};
+
+#endif // __H_THINKSCHEDULER__
@@ -6,7 +6,7 @@
  */
 
 #include "includes.h"
-#include "Utilities/argparser.h"
+#include "utilities/argparser.h"
 
 /**\brief This function tests all the available options of the ArgParser
  * class.*/
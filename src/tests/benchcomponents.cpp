@@ -0,0 +1,76 @@
+/**\file			benchcomponents.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Scenario loading micro-benchmark.
+ * \details
+ * Times Components::Load for each XML file of the main Scenario.  The
+ * Components look up each other while they load, so the whole Scenario is
+ * loaded once first and registered with the Menu.
+ */
+
+#include "includes.h"
+#include "menu.h"
+#include "engine/scenario.h"
+#include "graphics/video.h"
+#include "tests/microbench.h"
+
+#define COMPONENTS_SCENARIO "main"
+
+// Delete a collection along with everything in it.
+static void FreeComponents( Components *components ) {
+	list<string> *names = components->GetNames();
+	for( list<string>::iterator n = names->begin(); n != names->end(); ++n ) {
+		delete components->Get( *n );
+	}
+	delete components;
+}
+
+// Time loading one XML file into a new collection of type T.
+template<class T> static void BenchLoad( const string& label, Scenario *scenario, const string& file ) {
+	string path = "data/scenario/" COMPONENTS_SCENARIO "/" + scenario->Get( file );
+	MicroBench bench( label + "::Load", 1 );
+	int count = 0;
+
+	for( int run = 0; run < MICROBENCH_RUNS; run++ ) {
+		T *components = new T();
+		bench.Start();
+		components->Load( path );
+		bench.Stop();
+		count = components->Size();
+		FreeComponents( components );
+	}
+
+	bench.Print();
+	cout<<"    "<<count<<" from "<<path<<endl;
+}
+
+/**\brief Time loading each kind of Component.
+ * \details Images are only loaded for their size, as when running headless.
+ */
+int test_bench_components(int argc, char **argv){
+	Video::Initialize( true );
+
+	Scenario *scenario = new Scenario();
+	Menu::SetCurrentScenario( scenario );
+	if( !scenario->Load( COMPONENTS_SCENARIO ) ) {
+		cout<<"Failed: Could not load the scenario '"<<COMPONENTS_SCENARIO<<"'"<<endl;
+		Menu::SetCurrentScenario( NULL );
+		delete scenario;
+		return -1;
+	}
+
+	BenchLoad<Commodities>( "Commodities", scenario, "commodities" );
+	BenchLoad<Engines>( "Engines", scenario, "engines" );
+	BenchLoad<Weapons>( "Weapons", scenario, "weapons" );
+	BenchLoad<Models>( "Models", scenario, "models" );
+	BenchLoad<Outfits>( "Outfits", scenario, "outfits" );
+	BenchLoad<Technologies>( "Technologies", scenario, "technologies" );
+	BenchLoad<Alliances>( "Alliances", scenario, "alliances" );
+	BenchLoad<Sectors>( "Sectors", scenario, "sectors" );
+	BenchLoad<Planets>( "Planets", scenario, "planets" );
+
+	Menu::SetCurrentScenario( NULL );
+	delete scenario;
+	Video::Shutdown();
+	return 0;
+}
@@ -0,0 +1,10 @@
+/**\file			benchcomponents.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Scenario loading micro-benchmark.
+ */
+
+#ifndef __H_TEST_BENCHCOMPONENTS__
+#define __H_TEST_BENCHCOMPONENTS__
+int test_bench_components(int argc, char **argv);
+#endif//__H_TEST_BENCHCOMPONENTS__
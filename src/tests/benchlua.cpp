@@ -0,0 +1,83 @@
+/**\file			benchlua.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Lua call micro-benchmark.
+ * \details
+ * Times the cost of crossing from C++ into Lua: Lua::Call with and without
+ * arguments, and AI::Decide running a state machine that does nothing.
+ */
+
+#include "includes.h"
+#include "sprites/ai.h"
+#include "tests/microbench.h"
+#include "utilities/lua.h"
+
+#define LUA_CALLS 100000
+
+// The functions and state machine to call.  None of them do any work.
+static const char *benchScript =
+	"function benchNoop() end\n"
+	"function benchArgs(i, d, s) end\n"
+	"BenchMachine = {\n"
+	"	default = function(id,x,y,angle,speed,vector) end,\n"
+	"	Moving = function(id,x,y,angle,speed,vector) return \"default\" end,\n"
+	"}\n";
+
+/**\brief Time Lua::Call and AI::Decide.
+ */
+int test_bench_lua(int argc, char **argv){
+	Lua::Init();
+	lua_State *L = Lua::CurrentState();
+	Lua::Run( benchScript );
+
+	AI *ai = new AI( "Bench", "BenchMachine" );
+	AI *mover = new AI( "Bench", "BenchMachine" );
+
+	MicroBench call( "Lua::Call()", LUA_CALLS );
+	MicroBench callArgs( "Lua::Call(\"ids\")", LUA_CALLS );
+	MicroBench decide( "AI::Decide", LUA_CALLS );
+	MicroBench transition( "AI::Decide with a new state", LUA_CALLS );
+
+	for( int run = 0; run < MICROBENCH_RUNS; run++ ) {
+		call.Start();
+		for( int c = 0; c < LUA_CALLS; c++ ) {
+			Lua::Call( "benchNoop" );
+		}
+		call.Stop();
+
+		callArgs.Start();
+		for( int c = 0; c < LUA_CALLS; c++ ) {
+			Lua::Call( "benchArgs", "ids", c, 0.5, "bench" );
+		}
+		callArgs.Stop();
+
+		decide.Start();
+		for( int c = 0; c < LUA_CALLS; c++ ) {
+			ai->Decide( L );
+		}
+		decide.Stop();
+
+		transition.Start();
+		for( int c = 0; c < LUA_CALLS; c++ ) {
+			mover->SetState( "Moving" );
+			mover->Decide( L );
+		}
+		transition.Stop();
+	}
+
+	call.Print();
+	callArgs.Print();
+	decide.Print();
+	transition.Print();
+
+	int retval = 0;
+	if( lua_gettop( L ) != 0 ) {
+		cout<<"Failed: The Lua stack was left with "<<lua_gettop( L )<<" values"<<endl;
+		retval = -1;
+	}
+
+	delete ai;
+	delete mover;
+	Lua::Close();
+	return retval;
+}
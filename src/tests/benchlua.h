@@ -0,0 +1,10 @@
+/**\file			benchlua.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Lua call micro-benchmark.
+ */
+
+#ifndef __H_TEST_BENCHLUA__
+#define __H_TEST_BENCHLUA__
+int test_bench_lua(int argc, char **argv);
+#endif//__H_TEST_BENCHLUA__
@@ -0,0 +1,108 @@
+/**\file			benchmath.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Coordinate and Trig micro-benchmark.
+ * \details
+ * Times the vector and angle math that every Sprite does every tick.
+ */
+
+#include "includes.h"
+#include "tests/microbench.h"
+#include "utilities/coordinate.h"
+#include "utilities/trig.h"
+
+#define MATH_VALUES 1024
+#define MATH_OPS    1000000
+
+/**\brief Time the Coordinate operators and the Trig lookups.
+ * \details Every result is added to a sum that is printed, so that none of
+ *          the work can be optimized away.
+ */
+int test_bench_math(int argc, char **argv){
+	Trig *trig = Trig::Instance();
+	vector<Coordinate> points;
+	vector<float> angles;
+	srand( 1 );
+
+	for( int v = 0; v < MATH_VALUES; v++ ) {
+		points.push_back( Coordinate( rand() % 2000 - 1000, rand() % 2000 - 1000 ) );
+		angles.push_back( ( rand() % 7200 ) / 10.0f - 360.0f );
+	}
+
+	MicroBench add( "Coordinate::operator+", MATH_OPS );
+	MicroBench magnitude( "Coordinate::GetMagnitude", MATH_OPS );
+	MicroBench angle( "Coordinate::GetAngle", MATH_OPS );
+	MicroBench rotate( "Coordinate::RotateBy", MATH_OPS );
+	MicroBench normalize( "normalizeAngle", MATH_OPS );
+	MicroBench cosine( "Trig::GetCos(int)", MATH_OPS );
+	MicroBench sine( "Trig::GetSin(double)", MATH_OPS );
+	MicroBench rotatePoint( "Trig::RotatePoint", MATH_OPS );
+	double sum = 0.0;
+
+	for( int run = 0; run < MICROBENCH_RUNS; run++ ) {
+		Coordinate total;
+		add.Start();
+		for( int o = 0; o < MATH_OPS; o++ ) {
+			total = total + points[ o % MATH_VALUES ];
+		}
+		add.Stop();
+		sum += total.GetX();
+
+		magnitude.Start();
+		for( int o = 0; o < MATH_OPS; o++ ) {
+			sum += points[ o % MATH_VALUES ].GetMagnitude();
+		}
+		magnitude.Stop();
+
+		angle.Start();
+		for( int o = 0; o < MATH_OPS; o++ ) {
+			sum += points[ o % MATH_VALUES ].GetAngle();
+		}
+		angle.Stop();
+
+		rotate.Start();
+		for( int o = 0; o < MATH_OPS; o++ ) {
+			sum += points[ o % MATH_VALUES ].RotateBy( angles[ o % MATH_VALUES ] ).GetY();
+		}
+		rotate.Stop();
+
+		normalize.Start();
+		for( int o = 0; o < MATH_OPS; o++ ) {
+			sum += normalizeAngle( angles[ o % MATH_VALUES ] );
+		}
+		normalize.Stop();
+
+		cosine.Start();
+		for( int o = 0; o < MATH_OPS; o++ ) {
+			sum += trig->GetCos( static_cast<int>( angles[ o % MATH_VALUES ] ) );
+		}
+		cosine.Stop();
+
+		sine.Start();
+		for( int o = 0; o < MATH_OPS; o++ ) {
+			sum += trig->GetSin( trig->DegToRad( static_cast<double>( angles[ o % MATH_VALUES ] ) ) );
+		}
+		sine.Stop();
+
+		rotatePoint.Start();
+		for( int o = 0; o < MATH_OPS; o++ ) {
+			float x, y;
+			const Coordinate &p = points[ o % MATH_VALUES ];
+			trig->RotatePoint( p.GetX(), p.GetY(), 0.0f, 0.0f, &x, &y, static_cast<float>( trig->DegToRad( static_cast<double>( angles[ o % MATH_VALUES ] ) ) ) );
+			sum += x + y;
+		}
+		rotatePoint.Stop();
+	}
+
+	cout<<"  Checksum "<<sum<<endl;
+	add.Print();
+	magnitude.Print();
+	angle.Print();
+	rotate.Print();
+	normalize.Print();
+	cosine.Print();
+	sine.Print();
+	rotatePoint.Print();
+
+	return 0;
+}
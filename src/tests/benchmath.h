@@ -0,0 +1,10 @@
+/**\file			benchmath.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Coordinate and Trig micro-benchmark.
+ */
+
+#ifndef __H_TEST_BENCHMATH__
+#define __H_TEST_BENCHMATH__
+int test_bench_math(int argc, char **argv);
+#endif//__H_TEST_BENCHMATH__
@@ -0,0 +1,162 @@
+/**\file			benchspatial.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Spatial index micro-benchmarks.
+ * \details
+ * Times the QuadTree operations directly, then the same queries through the
+ * SpriteManager, which finds the Quadrants near a point before searching them.
+ */
+
+#include "includes.h"
+#include "sprites/spritemanager.h"
+#include "tests/benchsprite.h"
+#include "tests/microbench.h"
+#include "utilities/quadtree.h"
+
+#define SPATIAL_SPRITES 5000
+#define SPATIAL_EXTRA   1000
+#define SPATIAL_QUERIES 2000
+#define SPATIAL_RADIUS  500.0f
+
+// Counts the Sprites found, so that the queries cannot be optimized away.
+class SpriteCounter : public SpriteVisitor {
+	public:
+		SpriteCounter() : found( 0 ) {}
+		void Visit( Sprite *sprite ) { found++; }
+		long found;
+};
+
+static void MakeSprites( vector<Sprite*> *sprites, int count, float area ) {
+	for( int s = 0; s < count; s++ ) {
+		Coordinate pos( (rand() / float(RAND_MAX) - 0.5f) * area,
+		                (rand() / float(RAND_MAX) - 0.5f) * area );
+		sprites->push_back( new BenchSprite( s % 4 ? DRAW_ORDER_PROJECTILE : DRAW_ORDER_SHIP, pos, 10 ) );
+	}
+}
+
+static void DeleteSprites( vector<Sprite*> *sprites ) {
+	for( unsigned int s = 0; s < sprites->size(); s++ ) delete (*sprites)[s];
+	sprites->clear();
+}
+
+/**\brief Time QuadTree::Insert, Delete, GetSpritesNear and GetNearestSprite.
+ * \details Every run starts from a balanced tree of SPATIAL_SPRITES Sprites.
+ */
+int test_bench_quadtree(int argc, char **argv){
+	vector<Sprite*> resident, extra;
+	vector<Coordinate> points;
+	QuadTreePool pool;
+	srand( 1 );
+
+	// Keep everything inside one Quadrant.
+	float area = QUADRANTSIZE * 1.9f;
+	MakeSprites( &resident, SPATIAL_SPRITES, area );
+	MakeSprites( &extra, SPATIAL_EXTRA, area );
+	for( int q = 0; q < SPATIAL_QUERIES; q++ ) {
+		points.push_back( Coordinate( (rand() / float(RAND_MAX) - 0.5f) * area,
+		                              (rand() / float(RAND_MAX) - 0.5f) * area ) );
+	}
+
+	MicroBench insert( "QuadTree::Insert", SPATIAL_EXTRA );
+	MicroBench remove( "QuadTree::Delete", SPATIAL_EXTRA );
+	MicroBench near( "QuadTree::GetSpritesNear", SPATIAL_QUERIES );
+	MicroBench nearest( "QuadTree::GetNearestSprite", SPATIAL_QUERIES );
+	SpriteCounter counter;
+	long nearestFound = 0;
+
+	for( int run = 0; run < MICROBENCH_RUNS; run++ ) {
+		QuadTree *tree = pool.Acquire( Coordinate( 0, 0 ), QUADRANTSIZE );
+		for( int s = 0; s < SPATIAL_SPRITES; s++ ) {
+			tree->Insert( resident[s] );
+		}
+		tree->ReBallance();
+
+		insert.Start();
+		for( int s = 0; s < SPATIAL_EXTRA; s++ ) {
+			tree->Insert( extra[s] );
+		}
+		insert.Stop();
+		tree->ReBallance();
+
+		near.Start();
+		for( int q = 0; q < SPATIAL_QUERIES; q++ ) {
+			tree->GetSpritesNear( points[q], SPATIAL_RADIUS, &counter );
+		}
+		near.Stop();
+
+		nearest.Start();
+		for( int q = 0; q < SPATIAL_QUERIES; q++ ) {
+			if( tree->GetNearestSprite( resident[q], SPATIAL_RADIUS ) != NULL ) nearestFound++;
+		}
+		nearest.Stop();
+
+		remove.Start();
+		for( int s = 0; s < SPATIAL_EXTRA; s++ ) {
+			tree->Delete( extra[s] );
+		}
+		remove.Stop();
+
+		pool.Release( tree );
+	}
+
+	cout<<"  "<<SPATIAL_SPRITES<<" Sprites, "<<counter.found + nearestFound<<" found"<<endl;
+	insert.Print();
+	remove.Print();
+	near.Print();
+	nearest.Print();
+
+	DeleteSprites( &resident );
+	DeleteSprites( &extra );
+	return 0;
+}
+
+/**\brief Time the SpriteManager queries, which look up the nearby Quadrants first.
+ * \details The Sprites are spread over many Quadrants so that most queries
+ *          cross a Quadrant boundary.
+ */
+int test_bench_spritemanager(int argc, char **argv){
+	SpriteManager *sprites = new SpriteManager();
+	vector<Sprite*> all;
+	vector<Sprite*> nearby;
+	vector<Coordinate> points;
+	srand( 1 );
+
+	float area = QUADRANTSIZE * 10.0f;
+	MakeSprites( &all, SPATIAL_SPRITES, area );
+	for( unsigned int s = 0; s < all.size(); s++ ) {
+		sprites->Add( all[s] );
+	}
+	for( int q = 0; q < SPATIAL_QUERIES; q++ ) {
+		points.push_back( Coordinate( (rand() / float(RAND_MAX) - 0.5f) * area,
+		                              (rand() / float(RAND_MAX) - 0.5f) * area ) );
+	}
+
+	MicroBench near( "SpriteManager::GetSpritesNear", SPATIAL_QUERIES );
+	MicroBench nearest( "SpriteManager::GetNearestSprite", SPATIAL_QUERIES );
+	long found = 0;
+
+	for( int run = 0; run < MICROBENCH_RUNS; run++ ) {
+		near.Start();
+		for( int q = 0; q < SPATIAL_QUERIES; q++ ) {
+			nearby.clear();
+			sprites->GetSpritesNear( points[q], SPATIAL_RADIUS * 4, &nearby );
+			found += nearby.size();
+		}
+		near.Stop();
+
+		nearest.Start();
+		for( int q = 0; q < SPATIAL_QUERIES; q++ ) {
+			if( sprites->GetNearestSprite( all[q], SPATIAL_RADIUS * 4 ) != NULL ) found++;
+		}
+		nearest.Stop();
+	}
+
+	cout<<"  "<<SPATIAL_SPRITES<<" Sprites in "<<sprites->GetNumQuadrants()<<" Quadrants, "<<found<<" found"<<endl;
+	near.Print();
+	nearest.Print();
+
+	// The SpriteManager does not own the Sprites.
+	delete sprites;
+	DeleteSprites( &all );
+	return 0;
+}
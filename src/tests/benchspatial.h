@@ -0,0 +1,11 @@
+/**\file			benchspatial.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Spatial index micro-benchmarks.
+ */
+
+#ifndef __H_TEST_BENCHSPATIAL__
+#define __H_TEST_BENCHSPATIAL__
+int test_bench_quadtree(int argc, char **argv);
+int test_bench_spritemanager(int argc, char **argv);
+#endif//__H_TEST_BENCHSPATIAL__
@@ -0,0 +1,26 @@
+/**\file			benchsprite.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			A lightweight Sprite for benchmarks.
+ */
+
+#ifndef __H_TEST_BENCHSPRITE__
+#define __H_TEST_BENCHSPRITE__
+
+#include "sprites/sprite.h"
+
+// A Sprite without an Image, so that the benchmarks need no data files.
+class BenchSprite : public Sprite {
+	public:
+		BenchSprite( int _drawOrder, Coordinate pos, int size ) : drawOrder( _drawOrder ) {
+			SetWorldPosition( pos );
+			SetRadarSize( size );
+		}
+		void Update( lua_State *L ) {}
+		void Draw( void ) {}
+		int GetDrawOrder( void ) { return drawOrder; }
+	private:
+		int drawOrder;
+};
+
+#endif//__H_TEST_BENCHSPRITE__
@@ -0,0 +1,143 @@
+/**\file			collision.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Projectile collision benchmark.
+ * \details
+ * Checks a Broadphase pass over every projectile against testing each
+ * projectile against every ship, and times it against one nearest Sprite
+ * query per projectile.
+ */
+
+#include "includes.h"
+#include "sprites/sprite.h"
+#include "sprites/spritemanager.h"
+#include "utilities/broadphase.h"
+#include "tests/benchsprite.h"
+
+#define BENCH_SHIPS       500
+#define BENCH_PROJECTILES 5000
+#define BENCH_TICKS       20
+#define BENCH_AREA        16000.0f
+
+static Coordinate RandomPosition( void ) {
+	return Coordinate( (rand() / float(RAND_MAX) - 0.5f) * BENCH_AREA,
+	                   (rand() / float(RAND_MAX) - 0.5f) * BENCH_AREA );
+}
+
+static double ElapsedMS( Uint64 start ) {
+	return 1000.0 * (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+/**\brief Benchmark the projectile collision checks.
+ * \details The test fails unless the Broadphase finds exactly the hits that
+ * testing every projectile against every ship finds: the nearest ship that
+ * contains the projectile and is not the one it ignores.
+ */
+int test_collision(int argc, char **argv){
+	SpriteManager *sprites = new SpriteManager();
+	vector<Sprite*> ships, projectiles;
+	vector<int> ignoreIDs;
+	srand( 1 );
+
+	for( int s = 0; s < BENCH_SHIPS; s++ ) {
+		Sprite *ship = new BenchSprite( DRAW_ORDER_SHIP, RandomPosition(), 20 + rand() % 40 );
+		ships.push_back( ship );
+		sprites->Add( ship );
+	}
+	// Fire half of the projectiles from inside of a ship, so that there are hits to find.
+	// Some of those ignore the ship they were fired from, like a Projectile ignores its owner.
+	for( int p = 0; p < BENCH_PROJECTILES; p++ ) {
+		Coordinate pos = RandomPosition();
+		int ignoreID = 0;
+		if( p % 2 ) {
+			Sprite *near = ships[ rand() % BENCH_SHIPS ];
+			pos = near->GetWorldPosition() + Coordinate( rand() % 40 - 20, rand() % 40 - 20 );
+			if( p % 3 == 0 ) ignoreID = near->GetID();
+		}
+		Sprite *projectile = new BenchSprite( DRAW_ORDER_PROJECTILE, pos, 1 );
+		projectiles.push_back( projectile );
+		ignoreIDs.push_back( ignoreID );
+		sprites->Add( projectile );
+	}
+
+	// Reference cost: each projectile asks the SpriteManager for the nearest ship.
+	Uint64 start = SDL_GetPerformanceCounter();
+	for( int tick = 0; tick < BENCH_TICKS; tick++ ) {
+		vector<Sprite*>::iterator p;
+		for( p = projectiles.begin(); p != projectiles.end(); ++p ) {
+			sprites->GetNearestSprite( *p, 100, DRAW_ORDER_SHIP|DRAW_ORDER_PLAYER );
+		}
+	}
+	double nearestTime = ElapsedMS( start ) / BENCH_TICKS;
+
+	// One sweep over every projectile.
+	Broadphase broadphase;
+	vector<Collision> hits;
+	start = SDL_GetPerformanceCounter();
+	for( int tick = 0; tick < BENCH_TICKS; tick++ ) {
+		broadphase.Clear();
+		for( unsigned int s = 0; s < ships.size(); s++ ) {
+			broadphase.AddTarget( ships[s] );
+		}
+		for( unsigned int p = 0; p < projectiles.size(); p++ ) {
+			broadphase.AddProjectile( projectiles[p], ignoreIDs[p] );
+		}
+		hits.clear();
+		broadphase.Run( &hits );
+	}
+	double broadphaseTime = ElapsedMS( start ) / BENCH_TICKS;
+
+	int retval = 0;
+	map<Sprite*,Sprite*> found;
+	for( unsigned int h = 0; h < hits.size(); h++ ) {
+		if( found.count( hits[h].projectile ) ) {
+			cout<<"Failed: Broadphase hit projectile "<<hits[h].projectile->GetID()<<" twice"<<endl;
+			retval = -1;
+		}
+		found[ hits[h].projectile ] = hits[h].target;
+	}
+
+	// Test every projectile against every ship.
+	unsigned int expected = 0;
+	for( unsigned int p = 0; p < projectiles.size(); p++ ) {
+		Coordinate pos = projectiles[p]->GetWorldPosition();
+		Sprite *closest = NULL;
+		double mindist = 0;
+		for( unsigned int s = 0; s < ships.size(); s++ ) {
+			Coordinate ship = ships[s]->GetWorldPosition();
+			double dx = double(pos.GetX()) - ship.GetX();
+			double dy = double(pos.GetY()) - ship.GetY();
+			double dist = dx*dx + dy*dy;
+			double radius = ships[s]->GetRadarSize();
+			if( dist >= radius*radius || ships[s]->GetID() == ignoreIDs[p] ) {
+				continue;
+			}
+			if( closest == NULL || dist < mindist ) {
+				closest = ships[s];
+				mindist = dist;
+			}
+		}
+
+		map<Sprite*,Sprite*>::iterator hit = found.find( projectiles[p] );
+		Sprite *target = (hit == found.end()) ? NULL : hit->second;
+		if( closest != NULL ) {
+			expected++;
+		}
+		if( target != closest ) {
+			cout<<"Failed: projectile "<<projectiles[p]->GetID()<<" hit "<<(target ? target->GetID() : 0)
+			    <<" but should have hit "<<(closest ? closest->GetID() : 0)<<endl;
+			retval = -1;
+		}
+	}
+
+	cout<<"  "<<BENCH_SHIPS<<" ships, "<<BENCH_PROJECTILES<<" projectiles, "<<sprites->GetSpatialIndexName()<<" index"<<endl;
+	cout<<"  Nearest queries: "<<nearestTime<<" ms/tick"<<endl;
+	cout<<"  Broadphase:      "<<broadphaseTime<<" ms/tick, "<<hits.size()<<" of "<<expected<<" hits, "<<broadphase.GetNumTests()<<" pair tests"<<endl;
+
+	// The SpriteManager does not own the Sprites.
+	delete sprites;
+	for( unsigned int s = 0; s < ships.size(); s++ ) delete ships[s];
+	for( unsigned int p = 0; p < projectiles.size(); p++ ) delete projectiles[p];
+
+	return retval;
+}
@@ -0,0 +1,10 @@
+/**\file			collision.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Projectile collision benchmark.
+ */
+
+#ifndef __H_TEST_COLLISION__
+#define __H_TEST_COLLISION__
+int test_collision(int argc, char **argv);
+#endif//__H_TEST_COLLISION__
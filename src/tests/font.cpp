@@ -6,9 +6,9 @@
 
 #include "includes.h"
 #include "common.h"
-#include "UI/ui.h"
-#include "Input/input.h"
-#include "Utilities/timer.h"
+#include "ui/ui.h"
+#include "input/input.h"
+#include "utilities/timer.h"
 
 int test_font(int argc, char **argv){
 	int lh=SansSerif->LineHeight();
@@ -42,9 +42,10 @@ int test_font(int argc, char **argv){
 	Video::DrawRect(450,200,100,th,.3f,.3f,.3f);
 	SansSerif->RenderTight(450,200,str7);
 	
-	SansSerif->SetSize(50);
-	Video::DrawRect(350,300,SansSerif->TextWidth(str8),SansSerif->TightHeight(),.4f,.0f,.4f);
-	SansSerif->RenderTight(350,300,str8);
+	Font *large = new Font( "data/fonts/FreeSans.ttf", 50 );
+	Video::DrawRect(350,300,large->TextWidth(str8),large->TightHeight(),.4f,.0f,.4f);
+	large->RenderTight(350,300,str8);
+	delete large;
 
 	Video::Update();
 	SDL_Event event;
@@ -0,0 +1,111 @@
+/**\file			microbench.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Times small operations for the bench-* tests.
+ * \details
+ * The global operator new is replaced so that every heap allocation is
+ * counted.  This is only linked into epiar-bench, so the game and its
+ * tests keep the normal allocator.
+ */
+
+#include "includes.h"
+#include "tests/microbench.h"
+
+static SDL_atomic_t heapAllocations;
+
+void* operator new( size_t size ) {
+	SDL_AtomicAdd( &heapAllocations, 1 );
+	void *p = malloc( size ? size : 1 );
+	if( p == NULL ) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[]( size_t size ) {
+	return operator new( size );
+}
+
+void operator delete( void *p ) throw() {
+	free( p );
+}
+
+void operator delete[]( void *p ) throw() {
+	free( p );
+}
+
+/**\class MicroBench
+ * \brief Times one operation over several runs.
+ * \details Call Start and Stop around each run of the operation, then Print
+ *          the mean nanoseconds per operation, how much that varied between
+ *          runs, and how many heap allocations each operation made.
+ */
+
+/**\brief Prepare to time an operation.
+ * \param operations The number of times the operation is repeated in each run.
+ */
+MicroBench::MicroBench( const string& name, int operations ) :
+	name( name ),
+	operations( operations ),
+	allocations( 0 ),
+	startTicks( 0 ),
+	startAllocations( 0 )
+{
+}
+
+/**\brief The number of heap allocations made by the whole program so far.
+ */
+int MicroBench::GetAllocationCount( void ) {
+	return SDL_AtomicGet( &heapAllocations );
+}
+
+/**\brief Begin a run.
+ */
+void MicroBench::Start( void ) {
+	startAllocations = GetAllocationCount();
+	startTicks = SDL_GetPerformanceCounter();
+}
+
+/**\brief End a run.
+ */
+void MicroBench::Stop( void ) {
+	Uint64 ticks = SDL_GetPerformanceCounter() - startTicks;
+	allocations += GetAllocationCount() - startAllocations;
+	samples.push_back( 1e9 * ticks / SDL_GetPerformanceFrequency() / operations );
+}
+
+/**\brief The average nanoseconds per operation.
+ */
+double MicroBench::GetMean( void ) {
+	double total = 0.0;
+	for( unsigned int s = 0; s < samples.size(); s++ ) {
+		total += samples[s];
+	}
+	return samples.empty() ? 0.0 : total / samples.size();
+}
+
+/**\brief The standard deviation of the nanoseconds per operation between runs.
+ */
+double MicroBench::GetDeviation( void ) {
+	double mean = GetMean();
+	double total = 0.0;
+	for( unsigned int s = 0; s < samples.size(); s++ ) {
+		total += ( samples[s] - mean ) * ( samples[s] - mean );
+	}
+	return samples.size() < 2 ? 0.0 : sqrt( total / ( samples.size() - 1 ) );
+}
+
+/**\brief The average heap allocations per operation.
+ */
+double MicroBench::GetAllocations( void ) {
+	return samples.empty() ? 0.0 : static_cast<double>( allocations ) / ( samples.size() * operations );
+}
+
+/**\brief Print one line with the results.
+ */
+void MicroBench::Print( void ) {
+	double mean = GetMean();
+	printf( "  %-40s %12.1f ns/op  +/- %5.1f%%  %8.3f allocs/op  (%d runs of %d)\n",
+		name.c_str(), mean, mean > 0.0 ? 100.0 * GetDeviation() / mean : 0.0,
+		GetAllocations(), static_cast<int>( samples.size() ), operations );
+}
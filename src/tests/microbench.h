@@ -0,0 +1,39 @@
+/**\file			microbench.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Times small operations for the bench-* tests.
+ */
+
+#ifndef __H_TEST_MICROBENCH__
+#define __H_TEST_MICROBENCH__
+
+#include "includes.h"
+
+// Every micro-benchmark is repeated this many times, so that its spread can be reported.
+#define MICROBENCH_RUNS 15
+
+// Collects the time and heap allocations of one operation over several runs.
+class MicroBench {
+	public:
+		MicroBench( const string& name, int operations );
+
+		void Start( void );
+		void Stop( void );
+		void Print( void );
+
+		double GetMean( void );
+		double GetDeviation( void );
+		double GetAllocations( void );
+
+		static int GetAllocationCount( void );
+
+	private:
+		string name;
+		int operations;          ///< Operations timed between each Start and Stop.
+		vector<double> samples;  ///< Nanoseconds per operation in each run.
+		long allocations;        ///< Heap allocations in every run together.
+		Uint64 startTicks;
+		int startAllocations;
+};
+
+#endif//__H_TEST_MICROBENCH__
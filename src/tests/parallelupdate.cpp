@@ -0,0 +1,116 @@
+/**\file			parallelupdate.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Single versus multi threaded Sprite update.
+ * \details
+ * Moves and reindexes two identical universes, one on this thread and one
+ * with a JobSystem, and checks that they never diverge.
+ */
+
+#include "includes.h"
+#include "sprites/kinematics.h"
+#include "utilities/jobsystem.h"
+#include "utilities/quadtree.h"
+#include "tests/benchsprite.h"
+
+#define PARALLEL_SPRITES 20000
+#define PARALLEL_TICKS   100
+#define PARALLEL_WORKERS 3
+#define PARALLEL_AREA    60000.0f
+
+static double ElapsedMS( Uint64 start ) {
+	return 1000.0 * (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+// Records the positions of the Sprites found by a query, in the order found.
+class PositionRecorder : public SpriteVisitor {
+	public:
+		void Visit( Sprite *sprite ) { found.push_back( sprite->GetWorldPosition() ); }
+		vector<Coordinate> found;
+};
+
+static void MakeUniverse( vector<Sprite*> *sprites, KinematicsStore *store, QuadTreeIndex *index ) {
+	srand( 1 );
+	for( int s = 0; s < PARALLEL_SPRITES; s++ ) {
+		Coordinate pos( (rand() / float(RAND_MAX) - 0.5f) * PARALLEL_AREA,
+		                (rand() / float(RAND_MAX) - 0.5f) * PARALLEL_AREA );
+		Sprite *sprite = new BenchSprite( s % 4 ? DRAW_ORDER_PROJECTILE : DRAW_ORDER_SHIP, pos, 10 );
+		sprite->SetMomentum( Coordinate( rand() % 200 / 10.0 - 10.0, rand() % 200 / 10.0 - 10.0 ) );
+		sprites->push_back( sprite );
+		store->Add( sprite );
+		index->Insert( sprite );
+	}
+}
+
+/**\brief Compare the single and multi threaded integration and reindexing.
+ * \details The test fails unless both universes match bit for bit.
+ */
+int test_parallelupdate(int argc, char **argv){
+	vector<Sprite*> serialSprites, parallelSprites;
+	KinematicsStore serialStore, parallelStore;
+	QuadTreeIndex serialIndex, parallelIndex;
+	JobSystem jobs( PARALLEL_WORKERS );
+
+	MakeUniverse( &serialSprites, &serialStore, &serialIndex );
+	MakeUniverse( &parallelSprites, &parallelStore, &parallelIndex );
+
+	double serialTime = 0.0, parallelTime = 0.0;
+	for( int tick = 0; tick < PARALLEL_TICKS; tick++ ) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		serialStore.Integrate( NULL );
+		serialIndex.Reindex( NULL );
+		serialTime += ElapsedMS( start );
+
+		start = SDL_GetPerformanceCounter();
+		parallelStore.Integrate( &jobs );
+		parallelIndex.Reindex( &jobs );
+		parallelTime += ElapsedMS( start );
+	}
+
+	cout<<"  "<<PARALLEL_SPRITES<<" Sprites, "<<PARALLEL_TICKS<<" ticks, "<<jobs.GetNumWorkers()<<" workers"<<endl;
+	cout<<"  Single threaded: "<<serialTime / PARALLEL_TICKS<<" ms/tick"<<endl;
+	cout<<"  Multi threaded:  "<<parallelTime / PARALLEL_TICKS<<" ms/tick"<<endl;
+
+	int retval = 0;
+	for( int s = 0; s < PARALLEL_SPRITES; s++ ) {
+		Coordinate a = serialSprites[s]->GetWorldPosition();
+		Coordinate b = parallelSprites[s]->GetWorldPosition();
+		if( a.GetX() != b.GetX() || a.GetY() != b.GetY() ) {
+			cout<<"Failed: Sprite "<<s<<" is at "<<a<<" and "<<b<<endl;
+			retval = -1;
+			break;
+		}
+	}
+	if( serialIndex.GetNumRegions() != parallelIndex.GetNumRegions() || serialIndex.Count() != parallelIndex.Count() ) {
+		cout<<"Failed: The indexes have "<<serialIndex.GetNumRegions()<<" and "<<parallelIndex.GetNumRegions()<<" Quadrants"<<endl;
+		retval = -1;
+	}
+	// Queries must visit the same Sprites in the same order.
+	for( int q = 0; q < 20; q++ ) {
+		Coordinate point( (q - 10) * 3000.0f, (q % 5 - 2) * 5000.0f );
+		PositionRecorder serialFound, parallelFound;
+		serialIndex.GetSpritesNear( point, 4000.0f, &serialFound );
+		parallelIndex.GetSpritesNear( point, 4000.0f, &parallelFound );
+		bool same = serialFound.found.size() == parallelFound.found.size();
+		for( unsigned int f = 0; same && f < serialFound.found.size(); f++ ) {
+			same = serialFound.found[f].GetX() == parallelFound.found[f].GetX()
+			    && serialFound.found[f].GetY() == parallelFound.found[f].GetY();
+		}
+		if( !same ) {
+			cout<<"Failed: The indexes disagree near "<<point<<endl;
+			retval = -1;
+		}
+	}
+
+	// Detach the Sprites before they are deleted.
+	for( int s = 0; s < PARALLEL_SPRITES; s++ ) {
+		serialIndex.Remove( serialSprites[s] );
+		serialStore.Remove( serialSprites[s] );
+		delete serialSprites[s];
+		parallelIndex.Remove( parallelSprites[s] );
+		parallelStore.Remove( parallelSprites[s] );
+		delete parallelSprites[s];
+	}
+
+	return retval;
+}
@@ -0,0 +1,10 @@
+/**\file			parallelupdate.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Single versus multi threaded Sprite update.
+ */
+
+#ifndef __H_TEST_PARALLELUPDATE__
+#define __H_TEST_PARALLELUPDATE__
+int test_parallelupdate(int argc, char **argv);
+#endif//__H_TEST_PARALLELUPDATE__
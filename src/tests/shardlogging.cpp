@@ -0,0 +1,95 @@
+/**\file			shardlogging.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Logging from several AI shards at once.
+ * \details
+ * Runs two AI shards whose messages and state machines all fail, so that both
+ * log on every tick, and checks that every line of the log arrives whole.
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "sprites/ai.h"
+#include "sprites/ai_shards.h"
+#include "utilities/log.h"
+
+#define SHARDLOGGING_SHARDS 2
+#define SHARDLOGGING_AI     40
+#define SHARDLOGGING_TICKS  200
+
+static bool EndsWith( const string &line, const string &end ) {
+	return line.size() >= end.size() && line.compare( line.size() - end.size(), end.size(), end ) == 0;
+}
+
+/**\brief Log from two shards at once.
+ * \details The test fails unless the log holds exactly the expected lines.
+ */
+int test_shardlogging(int argc, char **argv){
+	AIShards shards( NULL, SHARDLOGGING_SHARDS );
+	if( shards.GetCount() != SHARDLOGGING_SHARDS ) {
+		cout<<"Failed: Only "<<shards.GetCount()<<" AI shards could be started"<<endl;
+		return -1;
+	}
+
+	vector<AI*> ships;
+	for( int a = 0; a < SHARDLOGGING_AI; a++ ) {
+		ships.push_back( new AI( "Broken", "NoSuchStateMachine" ) );
+	}
+	AIMessage missing;
+	missing.function = "NoSuchFunction";
+
+	// Collect what the Log prints.
+	string logOut = OPTION(string, "options/log/out");
+	SETOPTION( "options/log/out", 1 );
+	stringstream captured;
+	streambuf *console = cout.rdbuf( captured.rdbuf() );
+
+	for( int tick = 0; tick < SHARDLOGGING_TICKS; tick++ ) {
+		shards.Broadcast( missing );
+		for( int a = 0; a < SHARDLOGGING_AI; a++ ) {
+			shards.Assign( ships[a] );
+		}
+		shards.Think( NULL );
+	}
+
+	cout.rdbuf( console );
+	SETOPTION( "options/log/out", logOut );
+
+	int decided = 0, delivered = 0, garbled = 0;
+	string line;
+	while( getline( captured, line ) ) {
+		if( EndsWith( line, " (Error) - There is no State Machine named 'NoSuchStateMachine'!" ) ) {
+			decided++;
+		} else if( line.find( " (Error) - AI shard " ) != string::npos
+		        && EndsWith( line, " has no function 'NoSuchFunction'." ) ) {
+			delivered++;
+		} else {
+			if( garbled++ < 5 ) {
+				cout<<"Failed: Unexpected log line '"<<line<<"'"<<endl;
+			}
+		}
+	}
+
+	cout<<"  "<<SHARDLOGGING_SHARDS<<" shards, "<<SHARDLOGGING_AI<<" AI, "<<SHARDLOGGING_TICKS<<" ticks"<<endl;
+	cout<<"  "<<decided<<" state machine and "<<delivered<<" message errors logged"<<endl;
+
+	int retval = 0;
+	if( garbled > 0 ) {
+		cout<<"Failed: "<<garbled<<" log lines were garbled"<<endl;
+		retval = -1;
+	}
+	if( decided != SHARDLOGGING_AI * SHARDLOGGING_TICKS ) {
+		cout<<"Failed: Expected "<<SHARDLOGGING_AI * SHARDLOGGING_TICKS<<" state machine errors"<<endl;
+		retval = -1;
+	}
+	if( delivered != SHARDLOGGING_SHARDS * SHARDLOGGING_TICKS ) {
+		cout<<"Failed: Expected "<<SHARDLOGGING_SHARDS * SHARDLOGGING_TICKS<<" message errors"<<endl;
+		retval = -1;
+	}
+
+	for( int a = 0; a < SHARDLOGGING_AI; a++ ) {
+		delete ships[a];
+	}
+
+	return retval;
+}
@@ -0,0 +1,10 @@
+/**\file			shardlogging.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Logging from several AI shards at once.
+ */
+
+#ifndef __H_TEST_SHARDLOGGING__
+#define __H_TEST_SHARDLOGGING__
+int test_shardlogging(int argc, char **argv);
+#endif//__H_TEST_SHARDLOGGING__
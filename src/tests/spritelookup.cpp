@@ -0,0 +1,148 @@
+/**\file			spritelookup.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Sprite lookup benchmark.
+ * \details
+ * Compares looking Sprites up by ID in the old std::map, by ID in the
+ * SpriteManager, and by SpriteHandle in the SpriteManager.
+ */
+
+#include "includes.h"
+#include "engine/camera.h"
+#include "sprites/spritemanager.h"
+#include "tests/benchsprite.h"
+
+#define LOOKUP_SPRITES 5000
+#define LOOKUP_QUERIES 2000000
+#define LOOKUP_RADAR   1000.0f
+
+static double ElapsedNS( Uint64 start, int queries ) {
+	return 1e9 * (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency() / queries;
+}
+
+/**\brief Benchmark looking up Sprites by ID and by handle.
+ * \details Half of the Sprites are deleted and replaced first, so that the
+ * slot map has been churned and half of the old handles are stale.  The test
+ * fails unless every ID and handle finds the Sprite it was taken from, or
+ * nothing once that Sprite was deleted.  The deleted Sprites must also be gone
+ * from the visible sets, without another visibility pass.
+ */
+int test_spritelookup(int argc, char **argv){
+	SpriteManager *sprites = new SpriteManager();
+	map<int,Sprite*> oldLookup;
+	vector<Sprite*> all;
+	vector<int> ids;
+	vector<SpriteHandle> handles;
+	vector<Sprite*> expected; ///< What each ID and handle should find.
+	srand( 1 );
+
+	for( int s = 0; s < LOOKUP_SPRITES; s++ ) {
+		Sprite *sprite = new BenchSprite( DRAW_ORDER_EFFECT, Coordinate( s, s ), 10 );
+		sprites->Add( sprite );
+		all.push_back( sprite );
+	}
+
+	// Churn: remember the old handles, then replace every other Sprite.
+	for( int s = 0; s < LOOKUP_SPRITES; s++ ) {
+		ids.push_back( all[s]->GetID() );
+		handles.push_back( all[s]->GetHandle() );
+		expected.push_back( (s % 2) ? all[s] : NULL );
+	}
+	Camera camera;
+	sprites->UpdateVisibility( &camera, LOOKUP_RADAR );
+	vector<Sprite*> radarBefore = sprites->GetRadarSprites( LOOKUP_RADAR );
+	for( int s = 0; s < LOOKUP_SPRITES; s += 2 ) {
+		sprites->Delete( all[s] );
+	}
+	sprites->Update( NULL, false ); // Deletes the queued Sprites.  Effects need no Lua state.
+
+	int retval = 0;
+	set<Sprite*> survivors;
+	for( int s = 1; s < LOOKUP_SPRITES; s += 2 ) {
+		survivors.insert( all[s] );
+	}
+	const vector<Sprite*>& radar = sprites->GetRadarSprites( LOOKUP_RADAR );
+	const vector<Sprite*>& onscreen = sprites->GetOnScreen();
+	unsigned int stale = 0, kept = 0;
+	for( unsigned int i = 0; i < radarBefore.size(); i++ ) {
+		kept += survivors.count( radarBefore[i] );
+	}
+	for( unsigned int i = 0; i < radar.size(); i++ ) {
+		if( survivors.count( radar[i] ) == 0 ) stale++;
+	}
+	for( unsigned int i = 0; i < onscreen.size(); i++ ) {
+		if( survivors.count( onscreen[i] ) == 0 ) stale++;
+	}
+	if( stale > 0 || kept == 0 || radar.size() != kept ) {
+		cout<<"Failed: "<<stale<<" deleted Sprites are still visible, "<<radar.size()<<" of "<<kept<<" left on the radar"<<endl;
+		retval = -1;
+	}
+	for( int s = 0; s < LOOKUP_SPRITES; s += 2 ) {
+		all[s] = new BenchSprite( DRAW_ORDER_EFFECT, Coordinate( s, s ), 10 );
+		sprites->Add( all[s] );
+		ids.push_back( all[s]->GetID() );
+		handles.push_back( all[s]->GetHandle() );
+		expected.push_back( all[s] );
+	}
+	for( unsigned int s = 0; s < all.size(); s++ ) {
+		oldLookup[ all[s]->GetID() ] = all[s];
+	}
+
+	// Every query mix is the same: random, and about one third stale.
+	vector<unsigned int> order;
+	for( int q = 0; q < LOOKUP_QUERIES; q++ ) {
+		order.push_back( rand() % ids.size() );
+	}
+
+	for( unsigned int i = 0; i < ids.size(); i++ ) {
+		if( sprites->GetSpriteByID( ids[i] ) != expected[i] ) {
+			cout<<"Failed: ID "<<ids[i]<<" found the wrong Sprite"<<endl;
+			retval = -1;
+		}
+		if( sprites->GetSprite( handles[i] ) != expected[i] ) {
+			cout<<"Failed: The handle for ID "<<ids[i]<<" found the wrong Sprite"<<endl;
+			retval = -1;
+		}
+	}
+
+	long found = 0;
+	Uint64 start = SDL_GetPerformanceCounter();
+	for( int q = 0; q < LOOKUP_QUERIES; q++ ) {
+		map<int,Sprite*>::iterator i = oldLookup.find( ids[ order[q] ] );
+		if( i != oldLookup.end() ) found++;
+	}
+	double mapTime = ElapsedNS( start, LOOKUP_QUERIES );
+	long mapFound = found;
+
+	found = 0;
+	start = SDL_GetPerformanceCounter();
+	for( int q = 0; q < LOOKUP_QUERIES; q++ ) {
+		if( sprites->GetSpriteByID( ids[ order[q] ] ) != NULL ) found++;
+	}
+	double idTime = ElapsedNS( start, LOOKUP_QUERIES );
+	long idFound = found;
+
+	found = 0;
+	start = SDL_GetPerformanceCounter();
+	for( int q = 0; q < LOOKUP_QUERIES; q++ ) {
+		if( sprites->GetSprite( handles[ order[q] ] ) != NULL ) found++;
+	}
+	double handleTime = ElapsedNS( start, LOOKUP_QUERIES );
+	long handleFound = found;
+
+	cout<<"  "<<LOOKUP_SPRITES<<" Sprites, "<<LOOKUP_QUERIES<<" lookups"<<endl;
+	cout<<"  std::map by ID:       "<<mapTime<<" ns/lookup"<<endl;
+	cout<<"  SpriteManager by ID:  "<<idTime<<" ns/lookup"<<endl;
+	cout<<"  SpriteManager handle: "<<handleTime<<" ns/lookup"<<endl;
+
+	if( mapFound != idFound || mapFound != handleFound ) {
+		cout<<"Failed: The lookups disagree ("<<mapFound<<", "<<idFound<<", "<<handleFound<<" found)"<<endl;
+		retval = -1;
+	}
+
+	// The SpriteManager does not own the Sprites.
+	delete sprites;
+	for( unsigned int s = 0; s < all.size(); s++ ) delete all[s];
+
+	return retval;
+}
@@ -0,0 +1,10 @@
+/**\file			spritelookup.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Sprite lookup benchmark.
+ */
+
+#ifndef __H_TEST_SPRITELOOKUP__
+#define __H_TEST_SPRITELOOKUP__
+int test_spritelookup(int argc, char **argv);
+#endif//__H_TEST_SPRITELOOKUP__
@@ -15,6 +15,17 @@
 #include "tests/argparser.h"
 #include "tests/ui.h"
 #include "tests/font.h"
+#include "tests/collision.h"
+#include "tests/spritelookup.h"
+#include "tests/parallelupdate.h"
+#include "tests/shardlogging.h"
+#ifdef EPIAR_COMPILE_BENCHMARKS
+#include "tests/benchspatial.h"
+#include "tests/benchcomponents.h"
+#include "tests/benchlua.h"
+#include "tests/benchmath.h"
+#include "tests/tickallocations.h"
+#endif // EPIAR_COMPILE_BENCHMARKS
 // Header files for various subsystems
 #include "audio/audio.h"
 #include "graphics/font.h"
@@ -22,13 +33,11 @@
 #include "input/input.h"
 #include "ui/ui.h"
 #include "utilities/timer.h"
-#include "utilities/xmlfile.h"
 
-// main configuration file, used through the tree (extern in common.h)
-extern XMLFile *optionsfile;
 // main font used throughout the game
 extern Font *SansSerif, *BitType, *Serif, *Mono;
 // Test requirements
+// The options are restored by main() before any Test runs.
 #define REQUIRE_OPTIONS		(1L << 0)
 #define REQUIRE_VIDEO		(1L << 1)
 #define REQUIRE_AUDIO		(1L << 2)
@@ -46,7 +55,18 @@ Test::Test( const string& testname ):testname( testname ){
 		REQUIRE_VIDEO|REQUIRE_AUDIO|REQUIRE_OPTIONS|REQUIRE_FONTS);
 	tests["font"]=make_pair(test_font,
 		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
-
+	tests["collision"]=make_pair(test_collision,REQUIRE_OPTIONS);
+	tests["spritelookup"]=make_pair(test_spritelookup,REQUIRE_OPTIONS);
+	tests["parallelupdate"]=make_pair(test_parallelupdate,0);
+	tests["shardlogging"]=make_pair(test_shardlogging,REQUIRE_OPTIONS);
+#ifdef EPIAR_COMPILE_BENCHMARKS
+	tests["bench-quadtree"]=make_pair(test_bench_quadtree,0);
+	tests["bench-spritemanager"]=make_pair(test_bench_spritemanager,REQUIRE_OPTIONS);
+	tests["bench-components"]=make_pair(test_bench_components,REQUIRE_OPTIONS);
+	tests["bench-lua"]=make_pair(test_bench_lua,0);
+	tests["bench-math"]=make_pair(test_bench_math,0);
+	tests["tick-allocations"]=make_pair(test_tick_allocations,REQUIRE_OPTIONS);
+#endif // EPIAR_COMPILE_BENCHMARKS
 }
 
 /**\brief Runs the Test.*/
@@ -83,27 +103,22 @@ int Test::RunTest( int argc, char **argv){
 /**\brief Loads requirements for the Test.*/
 void Test::LoadRequirements( void ){
 	long testreqs = tests[this->testname].second;
-	if( testreqs & REQUIRE_OPTIONS ){
-		cout<<"  Initializing options subsystem..."<<endl;
-		optionsfile = new XMLFile( "options.xml" );
-	}
 	if( testreqs & REQUIRE_VIDEO ){
 		cout<<"  Initializing video subsystem..."<<endl;
 		Video::Initialize();
-		Video::SetWindow( 640, 480, 32 );
 	}
 	if( testreqs & REQUIRE_AUDIO ){
 		cout<<"  Initializing audio subsystem..."<<endl;
-		Audio::Instance().Initialize();
-		Audio::Instance().SetMusicVol ( 0.5f );
-		Audio::Instance().SetSoundVol ( 0.5f );
+		Audio::Instance()->Initialize();
+		Audio::Instance()->SetMusicVol ( 0.5f );
+		Audio::Instance()->SetSoundVol ( 0.5f );
 	}
 	if( testreqs & REQUIRE_FONTS ){
 		cout<<"  Initializing font subsystem..."<<endl;
-		SansSerif       = new Font( "data/fonts/FreeSans.ttf" );
-		BitType         = new Font( "data/fonts/visitor2.ttf" );
-		Serif           = new Font( "data/fonts/FreeSerif.ttf" );
-		Mono            = new Font( "data/fonts/ConsolaMono.ttf" );
+		SansSerif       = new Font( "data/fonts/FreeSans.ttf", 12 );
+		BitType         = new Font( "data/fonts/visitor2.ttf", 12 );
+		Serif           = new Font( "data/fonts/FreeSerif.ttf", 12 );
+		Mono            = new Font( "data/fonts/ConsolaMono.ttf", 12 );
 	}
 }
 
@@ -117,26 +132,24 @@ void Test::UnloadRequirements( void ){
 	}
 	if( testreqs & REQUIRE_AUDIO ){
 		cout<<"  Shutting down audio subsystem..."<<endl;
-		Audio::Instance().Shutdown();
+		Audio::Instance()->Shutdown();
 	}
 	if( testreqs & REQUIRE_VIDEO ){
 		cout<<"  Shutting down video subsystem..."<<endl;
 		Video::Shutdown();
 	}
-	if( testreqs & REQUIRE_OPTIONS ){
-		cout<<"  Shutting down options subsystem..."<<endl;
-		delete optionsfile;
-	}
 }
 
 /**\brief Simple Game loop.*/
 void Test::GameLoop( void ){
 	bool quit=false;
 	Input inputs;
+	list<InputEvent> events;
 	Timer::Update();
 	while( !quit ) {
-		quit = inputs.Update();
-		
+		events = inputs.Update();
+		quit = Input::HandleSpecificEvent( events, InputEvent( KEY, KEYTYPED, SDLK_ESCAPE ) );
+
 		int logicLoops = Timer::Update();
 		while(logicLoops--) {
 				// Update cycle
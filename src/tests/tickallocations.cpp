@@ -0,0 +1,231 @@
+/**\file			tickallocations.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Checks that a steady-state tick does not use the heap.
+ * \details
+ * Moves Sprites back and forth across Quadrant boundaries and deletes a few,
+ * while AI change state in their own lua_State and pooled Projectiles and
+ * Effects expire and are replaced.  The heap allocations of each tick are
+ * counted with the operator new from microbench.cpp.  Once everything has
+ * warmed up, a tick must not allocate.
+ */
+
+#include "includes.h"
+#include "graphics/image.h"
+#include "graphics/video.h"
+#include "sprites/ai.h"
+#include "sprites/effects.h"
+#include "sprites/projectile.h"
+#include "sprites/spritemanager.h"
+#include "utilities/luacost.h"
+#include "utilities/timer.h"
+#include "tests/benchsprite.h"
+#include "tests/microbench.h"
+
+#define TICK_SPRITES     3000
+#define TICK_DOOMED      200    // Sprites that are deleted, one at a time.
+#define TICK_AI          100
+#define TICK_PROJECTILES 400    // Kept alive by replacing those that expire.
+#define TICK_EFFECTS     100
+#define TICK_LIFETIME    40     // Milliseconds that a Projectile lives.
+#define TICK_PERIOD      100    // Ticks before the Sprites turn around.
+#define TICK_WARMUP      (4 * TICK_PERIOD)
+#define TICK_MEASURED    (4 * TICK_PERIOD)
+#define TICK_AREA        (QUADRANTSIZE * 6.0f)
+
+// Every state hands over to the next, so that each AI changes state on every
+// tick.  The long names do not fit in a std::string without the heap.
+static const char *tickStateMachine =
+	"TickAllocations = {\n"
+	"	default = function( id, x, y, angle, speed, vector ) return 'CirclingTheStation' end,\n"
+	"	CirclingTheStation = function( id, x, y, angle, speed, vector ) return 'ReturningToPatrol' end,\n"
+	"	ReturningToPatrol = function( id, x, y, angle, speed, vector ) return 'default' end,\n"
+	"}\n";
+
+// An AI that only runs its state machine, in a lua_State of its own.
+class TickAI : public AI {
+	public:
+		TickAI( lua_State *_L, Coordinate pos ) : AI( "Tick", "TickAllocations" ), L(_L) {
+			SetWorldPosition( pos );
+		}
+		void Update( lua_State *unused ) { Decide( L ); }
+	private:
+		lua_State *L;
+};
+
+static Coordinate RandomPosition( float left ) {
+	return Coordinate( left + rand() / float(RAND_MAX) * TICK_AREA,
+	                   (rand() / float(RAND_MAX) - 0.5f) * TICK_AREA );
+}
+
+// Puts a new Projectile or Effect wherever the last one there has expired, so
+// that once they are all alive every tick sees the same Sprites in the same
+// places.
+class TickSpawner {
+	public:
+		TickSpawner( Weapon *_weapon ) : weapon(_weapon) {
+			// Far to the right of everything else, so that no Projectile hits a Ship.
+			for( int p = 0; p < TICK_PROJECTILES + TICK_EFFECTS; p++ ) {
+				places.push_back( RandomPosition( 2.0f * TICK_AREA ) );
+				ids.push_back( 0 );
+			}
+		}
+		// Only the Projectiles themselves are counted.  The Sprite lists and
+		// lookups of the SpriteManager are allowed to allocate when one is Added.
+		void Respawn( SpriteManager *sprites, int *allocations ) {
+			for( int p = 0; p < TICK_PROJECTILES + TICK_EFFECTS; p++ ) {
+				if( ids[p] != 0 && sprites->GetSpriteByID( ids[p] ) != NULL ) {
+					continue;
+				}
+				Sprite *sprite;
+				if( p < TICK_PROJECTILES ) {
+					int before = MicroBench::GetAllocationCount();
+					sprite = new Projectile( 1.0f, float( p % 360 ), places[p], Coordinate(), weapon );
+					*allocations += MicroBench::GetAllocationCount() - before;
+				} else {
+					sprite = new Effect( places[p], "data/animations/shield.ani", 0 );
+				}
+				sprites->Add( sprite );
+				ids[p] = sprite->GetID();
+			}
+		}
+	private:
+		Weapon *weapon;
+		vector<Coordinate> places;
+		vector<int> ids;
+};
+
+/**\brief Fail if a tick allocated after the warm up.
+ * \details The Sprites move back and forth with the same period, and the AI
+ * visit the same states, so after the warm up every Quadrant, QuadTree node,
+ * scratch buffer, pool slot and state name that a tick needs has already been
+ * made once.  Sprites are deleted throughout.  Adding the new Projectiles and
+ * Effects to the SpriteManager is not counted, but creating a Projectile and
+ * growing either SpritePool is.
+ */
+int test_tick_allocations(int argc, char **argv){
+	Video::Initialize( true );
+	Timer::Initialize();
+
+	SpriteManager *sprites = new SpriteManager();
+	vector<Sprite*> all, doomed;
+	srand( 1 );
+
+	// Effects move on the worker threads, Ships are Collided with.
+	for( int s = 0; s < TICK_SPRITES + TICK_DOOMED; s++ ) {
+		Coordinate pos( (rand() / float(RAND_MAX) - 0.5f) * TICK_AREA,
+		                (rand() / float(RAND_MAX) - 0.5f) * TICK_AREA );
+		Sprite *sprite = new BenchSprite( s % 5 ? DRAW_ORDER_EFFECT : DRAW_ORDER_SHIP, pos, 10 );
+		sprites->Add( sprite );
+		sprite->SetMomentum( Coordinate( rand() % 3200 / 10.0 - 160.0, rand() % 3200 / 10.0 - 160.0 ) );
+		( ( s < TICK_SPRITES || sprite->GetDrawOrder() == DRAW_ORDER_SHIP ) ? all : doomed ).push_back( sprite );
+	}
+
+	lua_State *L = lua_open();
+	LuaCost::Attach( L );
+	luaL_openlibs( L );
+	if( luaL_dostring( L, tickStateMachine ) != 0 ) {
+		cout<<"Failed: "<<lua_tostring( L, -1 )<<endl;
+		LuaCost::Detach( L );
+		lua_close( L );
+		delete sprites;
+		Video::Shutdown();
+		return -1;
+	}
+	vector<AI*> ships;
+	for( int a = 0; a < TICK_AI; a++ ) {
+		AI *ai = new TickAI( L, RandomPosition( -0.5f * TICK_AREA ) );
+		sprites->Add( ai );
+		ships.push_back( ai );
+	}
+
+	Weapon weapon( "Tick", Image::Get( "data/graphics/laser_blue.png" ), NULL, "", 0, 1, 5, 0, energy_ammo, 0, 0, TICK_LIFETIME, NULL, 0.0f, 0 );
+	TickSpawner spawner( &weapon );
+
+	int retval = 0;
+	int worstTick = -1, worstAllocations = 0, spawnTicks = 0;
+	unsigned int projectileBlocks = 0, effectBlocks = 0;
+	Uint64 luaBytes = 0;
+	for( int tick = 0; tick < TICK_WARMUP + TICK_MEASURED; tick++ ) {
+		if( tick > 0 && tick % TICK_PERIOD == 0 ) {
+			for( unsigned int s = 0; s < all.size(); s++ ) {
+				all[s]->SetMomentum( all[s]->GetMomentum() * -1 );
+			}
+			for( unsigned int s = 0; s < doomed.size(); s++ ) {
+				doomed[s]->SetMomentum( doomed[s]->GetMomentum() * -1 );
+			}
+		}
+		if( tick % 4 == 0 && !doomed.empty() ) {
+			sprites->Delete( doomed.back() );
+			doomed.pop_back();
+		}
+		if( tick == TICK_WARMUP ) {
+			projectileBlocks = Projectile::GetPool()->GetAllocations();
+			effectBlocks = Effect::GetPool()->GetAllocations();
+			luaBytes = LuaCost::GetAllocated( L );
+		}
+
+		// Let the Projectiles and Effects age.
+		SDL_Delay( 1 );
+		Timer::Update();
+
+		int allocations = 0;
+		spawner.Respawn( sprites, &allocations );
+
+		int firstID = Sprite::GetNextID();
+		int before = MicroBench::GetAllocationCount();
+		sprites->Update( NULL, false );
+		allocations += MicroBench::GetAllocationCount() - before;
+
+		if( tick < TICK_WARMUP ) {
+			continue;
+		}
+		if( Sprite::GetNextID() != firstID ) {
+			spawnTicks++;
+			continue;
+		}
+		if( allocations > worstAllocations ) {
+			worstAllocations = allocations;
+			worstTick = tick;
+		}
+	}
+
+	cout<<"  "<<all.size()<<" Sprites in "<<sprites->GetNumQuadrants()<<" Quadrants, "<<TICK_MEASURED<<" ticks measured, "<<spawnTicks<<" created Sprites while updating"<<endl;
+	cout<<"  "<<TICK_AI<<" AI, "<<TICK_PROJECTILES<<" Projectiles and "<<TICK_EFFECTS<<" Effects kept alive"<<endl;
+	Projectile::GetPool()->Print();
+	Effect::GetPool()->Print();
+	if( worstAllocations > 0 ) {
+		cout<<"Failed: Tick "<<worstTick<<" made "<<worstAllocations<<" heap allocations"<<endl;
+		retval = -1;
+	}
+	if( Projectile::GetPool()->GetAllocations() != projectileBlocks || Effect::GetPool()->GetAllocations() != effectBlocks ) {
+		cout<<"Failed: The Projectile or Effect pool grew after the warm up"<<endl;
+		retval = -1;
+	}
+	if( LuaCost::GetAllocated( L ) != luaBytes ) {
+		cout<<"Failed: The AI allocated "<<LuaCost::GetAllocated( L ) - luaBytes<<" bytes in Lua"<<endl;
+		retval = -1;
+	}
+
+	// Let the Projectiles and Effects expire, since the SpriteManager does not
+	// delete the Sprites that are still in it.
+	for( int wait = 0; wait < 1000 && sprites->GetNumSprites() > int( all.size() + doomed.size() + ships.size() ); wait++ ) {
+		SDL_Delay( 1 );
+		Timer::Update();
+		sprites->Update( NULL, false );
+	}
+	delete sprites;
+	for( unsigned int s = 0; s < all.size(); s++ ) {
+		delete all[s];
+	}
+	for( unsigned int s = 0; s < doomed.size(); s++ ) {
+		delete doomed[s];
+	}
+	for( unsigned int a = 0; a < ships.size(); a++ ) {
+		delete ships[a];
+	}
+	LuaCost::Detach( L );
+	lua_close( L );
+	Video::Shutdown();
+	return retval;
+}
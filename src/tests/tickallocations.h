@@ -0,0 +1,10 @@
+/**\file			tickallocations.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \brief			Checks that a steady-state tick does not use the heap.
+ */
+
+#ifndef __H_TEST_TICKALLOCATIONS__
+#define __H_TEST_TICKALLOCATIONS__
+int test_tick_allocations(int argc, char **argv);
+#endif//__H_TEST_TICKALLOCATIONS__
@@ -6,19 +6,31 @@
  */
 
 #include "includes.h"
-#include "UI/ui.h"
-#include "Input/input.h"
-#include "Utilities/timer.h"
+#include "ui/ui.h"
+#include "ui/ui_button.h"
+#include "ui/ui_checkbox.h"
+#include "ui/ui_label.h"
+#include "ui/ui_picture.h"
+#include "ui/ui_slider.h"
+#include "ui/ui_tabs.h"
+#include "ui/ui_textbox.h"
+#include "input/input.h"
+#include "utilities/timer.h"
 
 int test_ui(int argc, char **argv){
 	bool quit=false;
 	Input inputs;
-	Timer::Update();
+	list<InputEvent> events;
+	Timer::Initialize();
+	UI::Initialize("Test");
 
 	Window *awin = static_cast<Window*>(UI::Add(new Window(0,0,200,400,"A Window")));
-	Tabs *tabcont = static_cast<Tabs*>(awin->AddChild(new Tabs(5,25,180,300,"Tabs")));
-	Tab *tab1 = static_cast<Tab*>(tabcont->AddChild(new Tab("Tab1")));
-	Tab *tab2 = static_cast<Tab*>(tabcont->AddChild(new Tab("Tab2")));
+	Tabs *tabcont = new Tabs(5,25,180,300,"Tabs");
+	Tab *tab1 = new Tab("Tab1");
+	Tab *tab2 = new Tab("Tab2");
+	awin->AddChild(tabcont);
+	tabcont->AddChild(tab1);
+	tabcont->AddChild(tab2);
 
 	tab1->AddChild(new Picture(50, 100, 50, 50, "data/graphics/corvet.png"));
 	tab1->AddChild(new Checkbox(10, 120, true, "Hello"));
@@ -30,8 +42,10 @@ int test_ui(int argc, char **argv){
 	tab2->AddChild(new Label(5,80,"Hello"));
 	
 	while( !quit ) {
-		quit = inputs.Update();
-		
+		events = inputs.Update();
+		UI::HandleInput( events );
+		quit = Input::HandleSpecificEvent( events, InputEvent( KEY, KEYTYPED, SDLK_ESCAPE ) );
+
 		Timer::Update();
 
 		Video::Erase();
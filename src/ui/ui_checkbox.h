@@ -19,7 +19,7 @@ class Checkbox : public Widget {
 		void Draw( int relx = 0, int rely = 0 );
 
 		bool IsChecked() {return checked;}
-		void Set(bool val) {checked = val;}
+		void Set(bool val) {checked = val; Invalidate();}
 	
 		string GetType( void ) { return string("Checkbox"); }
 		virtual int GetMask( void ) { return WIDGET_CHECKBOX; }
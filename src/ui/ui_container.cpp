@@ -1,7 +1,7 @@
 /**\file			ui_container.cpp
  * \author			Maoserr
  * \date			Created: Saturday, March 27, 2010
- * \date			Modified: Friday, April 15, 2016
+ * \date			Modified: Saturday, October 17, 2026
  * \brief			Container object can contain other widgets.
  */
 
@@ -22,10 +22,13 @@
 
 /**\brief Constructor, initializes default values.*/
 Container::Container( string _name, bool _mouseHandled ):
-	mouseHandled( _mouseHandled ), keyboardFocus( NULL ), mouseHover( NULL ),
+	mouseHandled( _mouseHandled ), cacheable( false ),
+	keyboardFocus( NULL ), mouseHover( NULL ),
 	lmouseDown( NULL ), mmouseDown( NULL ), rmouseDown( NULL ),
 	vscrollbar( NULL ),
-	formbutton( NULL )
+	formbutton( NULL ),
+	cache( NULL ), cacheW( 0 ), cacheH( 0 ), cacheGeneration( 0 ),
+	dirty( true ), live( false ), drawing( false )
 {
 	name = _name;
 	InnerRect.left = InnerRect.top = InnerRect.right = InnerRect.bottom = 0;
@@ -52,6 +55,11 @@ Container::~Container( void ) {
 
 	vscrollbar = NULL;
 	formbutton = NULL;
+
+	if( cache != NULL ) {
+		SDL_DestroyTexture( cache );
+		cache = NULL;
+	}
 }
 
 /**\brief Adds a child to the current container.
@@ -68,6 +76,7 @@ Container *Container::AddChild( Widget *widget ) {
 		//LogMsg(INFO, "Adding %s %s %p to %s", widget->GetType().c_str(), widget->GetName().c_str(), widget, GetName().c_str() );
 		// Check to see if widget is past the bounds.
 		ResetScrollBars();
+		MarkDirty();
 	}
 	return this;
 }
@@ -77,6 +86,7 @@ void Container::SetInnerRect( int left, int top, int right, int bottom ) {
 	InnerRect.top = top;
 	InnerRect.right = right;
 	InnerRect.bottom = bottom;
+	MarkDirty();
 }
 
 /**\brief Deletes a child from the current container.
@@ -105,6 +115,7 @@ bool Container::DelChild( Widget *widget ){
 			if( not_scrollbar ) {
 				ResetScrollBars();
 			}
+			MarkDirty();
 
 			return true;
 		}
@@ -129,6 +140,7 @@ bool Container::Detach( Widget *widget ) {
 	for( i = children.begin(); i != children.end(); ++i ) {
 		if( (*i) == widget ) {
 			i = children.erase( i );
+			MarkDirty();
 			return true;
 		}
 	}
@@ -146,6 +158,7 @@ void Container::Empty( void ){
 	children.clear();
 
 	ResetInput();
+	MarkDirty();
 }
 
 /**\brief Reset focus and events.
@@ -607,6 +620,77 @@ Widget *Container::PrevChild( Widget* widget, int mask) {
 	return( NULL );
 }
 
+/**\brief Remember that this Container must be drawn again.
+ * \details This also invalidates every Container above this one.
+ */
+void Container::MarkDirty( void ) {
+	dirty = true;
+	if( drawing ) {
+		// Something changed as it was being drawn
+		live = true;
+	}
+	Invalidate();
+}
+
+/**\brief Draw this Container from its cache texture.
+ * \details The cache is drawn again only when the Container is dirty, or
+ *          when the render targets were lost.  Containers with children that
+ *          change every frame (like a blinking cursor) are drawn directly.
+ *          The cache is drawn with the Container at (0,0), so that the children
+ *          keep the same offsets.
+ * \returns False when the caller should draw normally.
+ */
+bool Container::DrawCached( int relx, int rely ) {
+	// Called again by the Draw below
+	if( drawing ) {
+		return false;
+	}
+	if( !cacheable || !OPTION(int,"options/video/ui-cache") || OPTION(int,"options/development/debug-ui") ) {
+		return false;
+	}
+
+	if( !live && ( cache == NULL || cacheW != w || cacheH != h ) ) {
+		if( cache != NULL ) {
+			SDL_DestroyTexture( cache );
+		}
+		cacheW = w;
+		cacheH = h;
+		cache = Video::CreateRenderTarget( w, h );
+		dirty = true;
+	}
+
+	if( live || cache == NULL ) {
+		live = false;
+		dirty = true;
+		drawing = true;
+		Draw( relx, rely );
+		drawing = false;
+		return true;
+	}
+
+	if( dirty || cacheGeneration != Video::GetRenderTargetGeneration() ) {
+		dirty = false;
+		cacheGeneration = Video::GetRenderTargetGeneration();
+		drawing = true;
+		if( Video::PushRenderTarget( cache ) ) {
+			Draw( -GetX(), -GetY() );
+			Video::PopRenderTarget();
+		} else {
+			dirty = true;
+			Draw( relx, rely );
+		}
+		drawing = false;
+		if( live ) {
+			// A child changed while it was drawn, so the cache is not used
+			Draw( relx, rely );
+			return true;
+		}
+	}
+
+	Video::DrawTexture( cache, GetX() + relx, GetY() + rely, w, h );
+	return true;
+}
+
 /**\brief Draws this widget and all children widgets.
  */
 void Container::Draw( int relx, int rely ) {
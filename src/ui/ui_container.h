@@ -1,7 +1,7 @@
 /**\file			ui_container.h
  * \author			Maoserr
  * \date			Created: Saturday, March 27, 2010
- * \date			Modified: Saturday, March 27, 2010
+ * \date			Modified: Saturday, October 17, 2026
  * \brief			Container object can contain other widgets.
  */
 
@@ -45,6 +45,7 @@ class Container : public Widget {
 		virtual Widget *PrevChild( Widget* widget, int mask = WIDGET_ALL );
 
 		virtual void Draw( int relx = 0, int rely = 0 );
+		void MarkDirty( void );
 
 		xmlNodePtr ToNode();
 
@@ -53,6 +54,8 @@ class Container : public Widget {
 
 	protected:
 		virtual bool Detach( Widget *child );
+		bool DrawCached( int relx, int rely );
+
 		// Input events
 		virtual bool MouseMotion( int xi, int yi );
 		virtual bool MouseLUp( int xi, int yi );
@@ -74,6 +77,8 @@ class Container : public Widget {
 		// If mouse input is handled - We default to true
 		// On certain occasions we may need to default to false
 		bool mouseHandled;
+		// Frames and Windows draw into a texture that is reused until they change
+		bool cacheable;
 
 	private:
 		Widget *keyboardFocus; ///< Remembers which child last had focus
@@ -88,6 +93,13 @@ class Container : public Widget {
 		struct _InnerRect {
 			int left, top, right, bottom;
 		} InnerRect;
+
+		SDL_Texture *cache;     ///< The last drawing of this Container, when cacheable.
+		int cacheW, cacheH;     ///< The size of the cache texture.
+		Uint32 cacheGeneration; ///< The Video render target generation the cache was drawn in.
+		bool dirty;             ///< Does the cache need to be drawn again?
+		bool live;              ///< Did a child change while being drawn?  Then it is drawn directly.
+		bool drawing;           ///< Is this Container drawing into the cache right now?
 };
 
 #endif//__H_UI_CONTAINER__
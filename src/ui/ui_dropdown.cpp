@@ -1,7 +1,7 @@
 /**\file			ui_dropdown.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Thursday, November 18, 2010
- * \date			Modified: Friday, December 31, 2010
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -61,6 +61,7 @@ Dropdown* Dropdown::AddOption( string option ) {
 		if( options.size() == 1 ) {
 			selected = 0;
 		}
+		Invalidate();
 	}
 	return this;
 }
@@ -91,6 +92,8 @@ void Dropdown::Draw( int relx, int rely ) {
 			UI::font->RenderTight( x + (w / 2), y + (baseheight / 2), options[selected], Font::CENTER,Font::MIDDLE );
 		}
 	} else if( UI::GetZLayer() == 0 ) {
+		// Deferred to screen coordinates, so the Window around this can't be cached
+		Invalidate();
 		UI::Defer( this, relx, rely );
 	} else {
 		unsigned int i;
@@ -153,6 +156,7 @@ bool Dropdown::MouseMotion( int xi, int yi ){
 	Widget::MouseMotion( xi, yi );
 	if( opened ) {
 		hovered = (yi - y) / baseheight;
+		Invalidate();
 	}
 	return true;
 }
@@ -165,6 +169,7 @@ void Dropdown::open() {
 	x += xoffset;
 	y += yoffset;
 	opened = true;
+	Invalidate();
 }
 
 /**\brief Close the Dropdown to display the selected option
@@ -175,6 +180,7 @@ void Dropdown::close() {
 	x -= xoffset;
 	y -= yoffset;
 	opened = false;
+	Invalidate();
 }
 
 string Dropdown::GetText(){
@@ -192,6 +198,7 @@ bool Dropdown::SetText(string text){
 	for(i = 0; i < options.size(); i++){
 		if(options[i] == text){
 			selected = i;
+			Invalidate();
 			return true;
 		}
 	}
@@ -1,7 +1,7 @@
 /**\file			ui_frame.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: August 24, 2010
- * \date			Modified: August 24, 2010
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -51,6 +51,7 @@ Frame::Frame( int x, int y, int w, int h ) {
 	assert( bitmaps[8] != NULL );
 
 	SetInnerRect( 8, 8, 8, 8 );
+	cacheable = true;
 }
 
 /**\brief Adds a widget to the current Frame.
@@ -67,6 +68,10 @@ Frame *Frame::AddChild( Widget *widget ) {
  */
 void Frame::Draw( int relx, int rely ) {
 	int x, y;
+
+	if( DrawCached( relx, rely ) ) {
+		return;
+	}
 	
 	x = GetX() + relx;
 	y = GetY() + rely;
@@ -1,7 +1,7 @@
 /**\file			ui_label.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Friday, April 25, 2008
- * \date			Modified: Friday, April 25, 2008
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -41,11 +41,10 @@ void Label::Draw(  int relx, int rely ) {
 	sx = GetX() + relx;
 	sy = GetY() + rely;
 	
-	// draw the label
-	Font::XPos xpositioning = (centered) ? (Font::CENTER) : (Font::LEFT);
+	// draw the label, centered by the width measured in SetText
 	Font::YPos ypositioning = (centered) ? (Font::MIDDLE) : (Font::TOP);
 
-	UI::font->Render( sx, sy, text, xpositioning, ypositioning );
+	UI::font->Render( (centered) ? (sx - textWidth / 2) : sx, sy, text, Font::LEFT, ypositioning );
 
 	Widget::Draw( relx, rely + UI::font->TightHeight() / 2 );
 }
@@ -59,8 +58,10 @@ void Label::SetText(string newText) {
 	{
 		LogMsg(WARN, "Multiline Label: %s at %ld", text.c_str(), text.find("\n") );
 	}
-	w = UI::font->TextWidth( text );
+	textWidth = UI::font->TextWidth( text );
+	w = textWidth;
 	h = UI::font->TightHeight( );
+	Invalidate();
 }
 
 /**\brief Append some text to the current text
@@ -1,7 +1,7 @@
 /**\file			ui_label.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Friday, April 25, 2008
- * \date			Modified: Friday, April 25, 2008
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -28,6 +28,7 @@ class Label : public Widget {
 	private:
 		bool centered;
 		string text;
+		int textWidth; ///< Measured once by SetText
 };
 
 #endif // __H_LABEL__
@@ -1,7 +1,7 @@
 /**\file			ui_navmap.cpp
  * \author			Matt Zweig
  * \date			Created:  Saturday, May 28, 2011
- * \date			Modified: Sunday, April 10, 2016
+ * \date			Modified: Saturday, October 17, 2026
  * \brief			Map Widget
  * \details
  */
@@ -98,6 +98,10 @@ void NavMap::Draw( int relx, int rely ) {
 	Sectors* sectorsHandle = this->scenario->GetSectors();
 	if(sectorsHandle == NULL) return;
 
+	// The map is drawn in screen coordinates and follows the Player's route,
+	// so the Window around it can't be cached.
+	Invalidate();
+
 	sectors = sectorsHandle->GetAllSectors();
 
 	// Draw the backdrop
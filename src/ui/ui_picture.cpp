@@ -1,7 +1,7 @@
 /**\file			ui_picture.cpp
  * \author			Matt Zweig
  * \date			Created: Tuesday, November 2, 2009
- * \date			Modified: Friday, November 14, 2009
+ * \date			Modified: Saturday, October 17, 2026
  * \brief			Widget for displaying Images
  * \details
  */
@@ -127,6 +127,7 @@ Picture::Picture( int x, int y, string filename ) {
  */
 void Picture::Rotate(double angle) {
 	rotation = angle;
+	Invalidate();
 }
 
 /**\brief Center the Image on (x, y).
@@ -134,6 +135,7 @@ void Picture::Rotate(double angle) {
 void Picture::Center(int x, int y) {
 	this->x = x - (w / 2);
 	this->y = y - (h / 2);
+	Invalidate();
 }
 
 /**\brief Draw this Picture
@@ -174,6 +176,7 @@ void Picture::Set( Image *img ){
 
 	w = bitmap->GetWidth();
 	h = bitmap->GetHeight();
+	Invalidate();
 }
 
 /**\brief Change the Image in this Picture.
@@ -188,6 +191,7 @@ void Picture::Set( string filename ){
 
 	w = bitmap->GetWidth();
 	h = bitmap->GetHeight();
+	Invalidate();
 }
 
 /**\brief Set the Background color and alpha
@@ -196,6 +200,7 @@ void Picture::Set( string filename ){
 void Picture::SetColor( float r, float g, float b, float a) {
 	color = Color(r,g,b);
 	alpha = a;
+	Invalidate();
 }
 
 /** @} */
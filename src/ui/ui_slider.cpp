@@ -1,7 +1,7 @@
 /**\file			ui_slider.cpp
  * \author			Maoserr
  * \date			Created: Saturday, March 13, 2010
- * \date			Modified: Saturday, March 13, 2010
+ * \date			Modified: Saturday, October 17, 2026
  * \brief			Creates a slider widget
  */
 
@@ -130,6 +130,7 @@ void Slider::SetVal( float value ){
 			checkedval = minval;
 	}
 	this->val = checkedval;
+	Invalidate();
 }
 
 // Private functions
@@ -1,7 +1,7 @@
 /**\file			ui_tabs.cpp
  * \author			Maoserr
  * \date			Created: Sunday, March 14, 2010
- * \date			Modified: Sunday, March 14, 2010
+ * \date			Modified: Saturday, October 17, 2026
  * \brief			Implements Tab pages
  */
 
@@ -150,6 +150,7 @@ void Tabs::TabNext( void ){
 			break;
 		}
 	}
+	Invalidate();
 }
 
 /**\brief Tabs drawing function.
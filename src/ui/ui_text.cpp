@@ -1,7 +1,7 @@
 /**\file			ui_text.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Monday, August 22, 2011
- * \date			Modified: Monday, August 22, 2011
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -25,7 +25,23 @@
  *       implementation of the reflow algorithms.  However, which operation it
  *       should be optimized for remains to be seen.  Currently it's located in
  *       AppendText, but that may not be a good idea long term.
+ *
+ *       Each line is measured once, when it is wrapped, so drawing does not
+ *       measure anything.  Whole texts wrapped by SetText are also kept by
+ *       Font, width and text, so that a window that is opened again (or two
+ *       widgets with the same text) does not wrap it again.
+ */
+
+map<Text::LayoutKey,Text::Layout> Text::layouts;
+
+/**\brief Order the keys of the layout cache.
  */
+bool Text::LayoutKey::operator<( const LayoutKey& other ) const {
+	if( font != other.font ) return font < other.font;
+	if( maxwidth != other.maxwidth ) return maxwidth < other.maxwidth;
+	return hash < other.hash;
+}
+
 Text::Text( Font* _font, string _text, int _maxwidth )
 	:font(_font)
 	,maxwidth(_maxwidth)
@@ -38,8 +54,29 @@ Text::Text( Font* _font, string _text, int _maxwidth )
 /**\brief Set the text string of this Widget
  */
 void Text::SetText( string text ) {
+	LayoutKey key;
+	key.font = font;
+	key.maxwidth = maxwidth;
+	key.hash = std::hash<string>()( text );
+
+	// The hash only finds the Layout; the text must still match.
+	map<LayoutKey,Layout>::iterator found = layouts.find( key );
+	if( found != layouts.end() && found->second.text == text ) {
+		lines = found->second.lines;
+		width = found->second.width;
+		return;
+	}
+
 	lines.clear();
 	AppendText( text );
+
+	if( layouts.size() >= TEXT_LAYOUT_CACHE_MAX ) {
+		layouts.clear();
+	}
+	Layout &layout = layouts[ key ];
+	layout.text = text;
+	layout.lines = lines;
+	layout.width = width;
 }
 
 /**\brief Insert some text into the middle of the content.
@@ -63,7 +100,8 @@ void Text::AppendText( string text ) {
 	if( lines.size() > 0 )
 	{
 		// combine the last line and the input text
-		text = lines[ lines.size()-1 ] + text;
+		Line &last = lines[ lines.size()-1 ];
+		text = last.text + (last.newline ? "\n" : "") + text;
 		lines.pop_back();
 	}
 
@@ -73,7 +111,7 @@ void Text::AppendText( string text ) {
 		// Line endings always end the line.
 		if( (*iter) ==  "\n" ) {
 			curline += "\n";
-			lines.push_back( curline );
+			PushLine( curline );
 			curline = "";
 		}
 		// Spaces 
@@ -82,7 +120,7 @@ void Text::AppendText( string text ) {
 			curline += " ";
 			if( curwidth + widthspace >= maxwidth )
 			{
-				lines.push_back( curline );
+				PushLine( curline );
 				curline = "";
 			}
 		}
@@ -92,7 +130,7 @@ void Text::AppendText( string text ) {
 			string word = *iter;
 			if( font->TextWidth( curline + word ) >= maxwidth )
 			{
-				lines.push_back( curline );
+				PushLine( curline );
 				curline = "";
 			}
 			curline += word;
@@ -105,15 +143,29 @@ void Text::AppendText( string text ) {
 	// Don't forget about the last line.
 	if( curline != "" )
 	{
-		lines.push_back( curline );
+		PushLine( curline );
 	}
 
-	// Update width.
+	UpdateWidth();
+}
+
+/**\brief Add a wrapped line, and measure it.
+ */
+void Text::PushLine( const string& line ) {
+	Line wrapped;
+	wrapped.newline = ( !line.empty() && line[ line.size() - 1 ] == '\n' );
+	wrapped.text = wrapped.newline ? line.substr( 0, line.size() - 1 ) : line;
+	wrapped.width = font->TextWidth( wrapped.text );
+	lines.push_back( wrapped );
+}
+
+/**\brief The width of the widest line.
+ */
+void Text::UpdateWidth( void ) {
 	width = 0;
 	for(unsigned int i = 0; i<lines.size(); i++)
 	{
-		curwidth = font->TextWidth( curline );
-		if( curwidth > width) width = curwidth;
+		if( lines[i].width > width) width = lines[i].width;
 	}
 }
 
@@ -124,6 +176,7 @@ void Text::Erase( int delchars ) {
 	int pos = temp.size() - delchars;
 	if( pos <= 0 ) {
 		lines.clear();
+		width = 0;
 	} else {
 		temp.erase( pos );
 		SetText( temp );
@@ -134,9 +187,12 @@ void Text::Erase( int delchars ) {
  */
 string Text::GetText() {
 	string result = "";
-	vector<string>::iterator iter;
+	vector<Line>::iterator iter;
 	for(iter = lines.begin(); iter != lines.end() ; ++iter ) {
-		result += (*iter);
+		result += iter->text;
+		if( iter->newline ) {
+			result += "\n";
+		}
 	}
 	return result;
 }
@@ -144,15 +200,18 @@ string Text::GetText() {
 /**\brief Render the lines of text
  */
 void Text::Render( int x, int y, Font::XPos xpositioning, Font::YPos ypositioning ) {
-	vector<string>::iterator iter;
-
-	for(iter = lines.begin(); iter != lines.end() ; ++iter, y += (int)((float)UI::font->LineHeight() * 1.3) ) {
-		int len = iter->size();
-		if ( (*iter)[len-1] == '\n' ) {
-			font->Render( x, y, iter->substr(0, len - 1), xpositioning, ypositioning );
-		} else {
-			font->Render( x, y, *iter, xpositioning, ypositioning );
+	vector<Line>::iterator iter;
+	int lineHeight = (int)((float)UI::font->LineHeight() * 1.3);
+
+	// Align with the measured widths, so that the Font does not measure again.
+	for(iter = lines.begin(); iter != lines.end() ; ++iter, y += lineHeight ) {
+		int left = x;
+		if( xpositioning == Font::CENTER ) {
+			left = x - iter->width / 2;
+		} else if( xpositioning == Font::RIGHT ) {
+			left = x - iter->width;
 		}
+		font->Render( left, y, iter->text, Font::LEFT, ypositioning );
 	}
 }
 
@@ -1,7 +1,7 @@
 /**\file			ui_text.h
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Monday, August 22, 2011
- * \date			Modified: Monday, August 22, 2011
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -11,6 +11,8 @@
 
 #include "graphics/font.h"
 
+#define TEXT_LAYOUT_CACHE_MAX 128 ///< Layouts kept before the cache is cleared
+
 class Text {
 	public:
 		Text( Font* font, string text, int maxwidth );
@@ -32,10 +34,38 @@ class Text {
 		int GetHeight() { return lines.size() * font->TightHeight(); }
 
 	protected:
+		/// One wrapped line, measured when it was wrapped.
+		struct Line {
+			string text; ///< Without the line ending
+			bool newline; ///< Whether the line ended with '\n'
+			int width;
+		};
+
+		/// The wrapped lines of a whole text.
+		struct Layout {
+			string text;
+			vector<Line> lines;
+			int width;
+		};
+
+		/// Which Font, width and text a Layout was made for.
+		struct LayoutKey {
+			Font *font;
+			int maxwidth;
+			size_t hash;
+
+			bool operator<( const LayoutKey& other ) const;
+		};
+
+		void PushLine( const string& line );
+		void UpdateWidth( void );
+
 		Font *font; ///< The Font used to render
 		int maxwidth; ///< The total width of the text
 		int width; ///< current width
-		vector<string> lines; ///< The lines of text
+		vector<Line> lines; ///< The lines of text
+
+		static map<LayoutKey,Layout> layouts; ///< Every Text wrapped by SetText, shared by all Text
 };
 
 #endif // __H_UI_TEXT__
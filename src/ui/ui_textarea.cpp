@@ -1,7 +1,7 @@
 /**\file			ui_textbox.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Monday, November 9, 2009
- * \date			Modified: Monday, November 9, 2009
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -111,6 +111,7 @@ bool Textarea::KeyPress( SDL_Keycode key ) {
 			lines.AppendText( key_s );
 			break;
 	}
+	Invalidate();
 
 	return true;
 }
@@ -1,7 +1,7 @@
 /**\file			ui_textbox.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Monday, November 9, 2009
- * \date			Modified: Saturday, April 2, 2016
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -66,8 +66,12 @@ void Textbox::Draw( int relx, int rely ) {
 	int tw = font->Render( x + rowPad + 3, y + rowPad, text );
 
 	// draw the cursor (if it has focus and we're on an even second (easy blink every second))
-	if( IsActive() && ((SDL_GetTicks() % 500) < 300) && !this->disabled ) {
-		Video::DrawRect( x + 4 + tw, y + 3, 1, h - 6, foreground );
+	if( IsActive() && !this->disabled ) {
+		// The cursor blinks, so the Window around this can't be cached
+		Invalidate();
+		if( (SDL_GetTicks() % 500) < 300 ) {
+			Video::DrawRect( x + 4 + tw, y + 3, 1, h - 6, foreground );
+		}
 	}
 	Video::UnsetCropRect();
 
@@ -111,6 +115,7 @@ bool Textbox::KeyPress( SDL_Keycode key ) {
 	} else {
 		text.append( key_s );
 	}
+	Invalidate();
 
 	return true;
 }
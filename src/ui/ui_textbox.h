@@ -1,7 +1,7 @@
 /**\file			ui_textbox.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Monday, November 9, 2009
- * \date			Modified: Monday, November 9, 2009
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -24,7 +24,7 @@ class Textbox : public Widget {
 		virtual int GetMask( void ) { return WIDGET_TEXTBOX; }
 
 		string GetText() { return text; }
-		void SetText(string s) { text = s; }
+		void SetText(string s) { text = s; Invalidate(); }
 
 	protected:
 		bool KeyPress( SDL_Keycode key );
@@ -1,7 +1,7 @@
 /**\file			ui_widget.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, December 27, 2009
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -11,6 +11,7 @@
 #include "ui.h"
 #include "utilities/log.h"
 #include "graphics/video.h"
+#include "ui/ui_container.h"
 
 /** \addtogroup UI
  * @{
@@ -84,6 +85,17 @@ void Widget::Draw( int relx, int rely ) {
 	}
 }
 
+/**\brief Tell the Containers above this Widget that it looks different.
+ * \details Containers that cache their drawing will draw it again.
+ *          Call this whenever something that Draw uses has changed.
+ * \sa Container::MarkDirty
+ */
+void Widget::Invalidate( void ) {
+	if( parent != NULL ) {
+		((Container*)parent)->MarkDirty();
+	}
+}
+
 /**\brief Tests if point is within a rectangle.
  */
 int Widget::GetAbsX( void ) {
@@ -148,6 +160,8 @@ bool Widget::Activate( action_type type, int xi, int yi ) {
 /**\brief Widget is currently being dragged.
  */
 bool Widget::MouseDrag( int xi,int yi ){
+	Invalidate();
+
 	Activate(Action_MouseDrag, xi, yi);
 	return true;
 }
@@ -166,6 +180,8 @@ bool Widget::MouseEnter( int xi, int yi ){
 
 	hovering = true;
 
+	Invalidate();
+
 	Activate(Action_MouseEnter, xi, yi);
 
 	return true;
@@ -178,6 +194,8 @@ bool Widget::MouseLeave( void ){
 
 	hovering = false;
 
+	Invalidate();
+
 	Activate(Action_MouseLeave, 0, 0);
 
 	return true;
@@ -188,6 +206,8 @@ bool Widget::MouseLeave( void ){
 bool Widget::MouseLUp( int xi, int yi ){
 	LogMsg(DEBUG, "Mouse Left up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseLUp, xi, yi);
 
 	return true;
@@ -202,6 +222,8 @@ bool Widget::MouseLDown( int xi, int yi ) {
 	dragX = xi-x;
 	dragY = yi-y;
 
+	Invalidate();
+
 	Activate(Action_MouseLDown, xi, yi);
 
 	return true;
@@ -212,6 +234,8 @@ bool Widget::MouseLDown( int xi, int yi ) {
 bool Widget::MouseLRelease( void ){
 	LogMsg(DEBUG, "Left Mouse released in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseLRelease, 0, 0);
 
 	return true;
@@ -222,6 +246,8 @@ bool Widget::MouseLRelease( void ){
 bool Widget::MouseMUp( int xi, int yi ){
 	LogMsg(DEBUG, "Mouse Middle up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseMUp, xi, yi);
 
 	return true;
@@ -232,6 +258,8 @@ bool Widget::MouseMUp( int xi, int yi ){
 bool Widget::MouseMDown( int xi, int yi ){
 	LogMsg(DEBUG, "Mouse Middle down detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseMDown, xi, yi);
 
 	return true;
@@ -242,6 +270,8 @@ bool Widget::MouseMDown( int xi, int yi ){
 bool Widget::MouseMRelease( void ){
 	LogMsg(DEBUG, "Middle Mouse released in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseMRelease, 0, 0);
 
 	return true;
@@ -252,6 +282,8 @@ bool Widget::MouseMRelease( void ){
 bool Widget::MouseRUp( int xi, int yi ){
 	LogMsg(DEBUG, "Mouse Right up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseRUp, xi, yi);
 
 	return true;
@@ -262,6 +294,8 @@ bool Widget::MouseRUp( int xi, int yi ){
 bool Widget::MouseRDown( int xi, int yi ){
 	LogMsg(DEBUG, "Mouse Right down detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseRDown, xi, yi);
 
 	return true;
@@ -272,6 +306,8 @@ bool Widget::MouseRDown( int xi, int yi ){
 bool Widget::MouseRRelease( void ){
 	LogMsg(DEBUG, "Right Mouse released in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseRRelease, 0, 0);
 
 	return true;
@@ -282,6 +318,8 @@ bool Widget::MouseRRelease( void ){
 bool Widget::MouseWUp( int xi, int yi ){
 	LogMsg(DEBUG, "Mouse Wheel up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseWUp, xi, yi);
 
 	return false;
@@ -292,6 +330,8 @@ bool Widget::MouseWUp( int xi, int yi ){
 bool Widget::MouseWDown( int xi, int yi ){
 	LogMsg(DEBUG, "Mouse Wheel down detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseWDown, xi, yi);
 
 	return false;
@@ -305,6 +345,7 @@ bool Widget::KeyboardEnter( void ){
 	Activate(Action_KeyboardEnter, 0, 0);
 
 	keyactivated = true;
+	Invalidate();
 
 	return true;
 }
@@ -317,6 +358,7 @@ bool Widget::KeyboardLeave( void ){
 	Activate(Action_KeyboardLeave, 0, 0);
 
 	keyactivated = false;
+	Invalidate();
 
 	return true;
 }
@@ -1,7 +1,7 @@
 /**\file			ui_widget.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, December 27, 2009
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -52,10 +52,10 @@ class Widget {
 		virtual int GetW( void ){ return this->w; }
 		virtual int GetH( void ){ return this->h; }
 
-		virtual void SetX( int _x ){ x = _x; }
-		virtual void SetY( int _y ){ y = _y; }
-		virtual void SetW( int _w ){ w = _w; }
-		virtual void SetH( int _h ){ h = _h; }
+		virtual void SetX( int _x ){ x = _x; Invalidate(); }
+		virtual void SetY( int _y ){ y = _y; Invalidate(); }
+		virtual void SetW( int _w ){ w = _w; Invalidate(); }
+		virtual void SetH( int _h ){ h = _h; Invalidate(); }
 
 		virtual int GetAbsX( void );
 		virtual int GetAbsY( void );
@@ -69,8 +69,10 @@ class Widget {
 		virtual void Draw( int relx = 0, int rely = 0 );
 		bool Contains( int relx, int rely );
 
-		void Show( void ) { hidden = false; }
-		void Hide( void ) { hidden = true; }
+		void Show( void ) { hidden = false; Invalidate(); }
+		void Hide( void ) { hidden = true; Invalidate(); }
+
+		void Invalidate( void );
 
 		virtual xmlNodePtr ToNode();
 
@@ -1,7 +1,7 @@
 /**\file			ui_window.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Saturday, October 17, 2026
  * \brief
  * \details
  */
@@ -43,6 +43,7 @@ Window::Window( int w, int h, string caption ):
 	bitmaps[8] = Image::Get( "data/skin/ui_wnd_back.png" );
 
 	closeButton = NULL;
+	cacheable = true;
 }
 
 /**\brief Creates a new window with specified parameters.
@@ -68,6 +69,7 @@ Window::Window( int x, int y, int w, int h, string caption ):
 	bitmaps[8] = Image::Get( "data/skin/ui_wnd_back.png" );
 
 	closeButton = NULL;
+	cacheable = true;
 }
 
 Window::~Window() {
@@ -103,6 +105,10 @@ void Window::Center() {
 void Window::Draw( int relx, int rely ) {
 	int x, y;
 	static float alpha = 0.96f;
+
+	if( DrawCached( relx, rely ) ) {
+		return;
+	}
 	
 	x = GetX() + relx;
 	y = GetY() + rely;
@@ -0,0 +1,137 @@
+/**\file			broadphase.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Sort and sweep collision detection between projectiles and targets
+ * \details
+ */
+
+#include "includes.h"
+#include "utilities/broadphase.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class Broadphase
+ * \brief Finds every projectile that is inside of a target in one pass.
+ * \details
+ * Rather than asking the SpriteManager for the nearest Ship once per
+ * projectile, the SpriteManager hands every projectile and every target to
+ * the Broadphase once per tick.
+ *
+ * Both lists are sorted along the X axis.  The projectiles are then swept
+ * from left to right while keeping a list of the targets that overlap the
+ * sweep line, so each projectile is only compared against the targets that
+ * share its column.
+ *
+ * A projectile hits the nearest target that contains it, unless that
+ * target's ID is the one the projectile ignores (usually the Ship that fired
+ * it).
+ *
+ * The lists are reused between ticks, so a Run does not allocate once the
+ * lists have grown to fit the universe.
+ */
+
+/**\brief Constructs an empty Broadphase.
+ */
+Broadphase::Broadphase() {
+	numTests = 0;
+}
+
+/**\brief Forget every projectile and target.
+ */
+void Broadphase::Clear( void ) {
+	projectiles.clear();
+	targets.clear();
+}
+
+/**\brief Add a projectile to the next Run.
+ * \param projectile The projectile.  It is treated as a point.
+ * \param ignoreID The ID of a target that this projectile can never hit.
+ */
+void Broadphase::AddProjectile( Sprite *projectile, int ignoreID ) {
+	Entry entry;
+	Coordinate pos = projectile->GetWorldPosition();
+	entry.x = entry.minX = entry.maxX = pos.GetX();
+	entry.y = pos.GetY();
+	entry.radius = 0;
+	entry.id = ignoreID;
+	entry.sprite = projectile;
+	projectiles.push_back( entry );
+}
+
+/**\brief Add a target to the next Run.
+ * \details The target is a circle the size of its radar size.
+ */
+void Broadphase::AddTarget( Sprite *target ) {
+	Entry entry;
+	Coordinate pos = target->GetWorldPosition();
+	entry.x = pos.GetX();
+	entry.y = pos.GetY();
+	entry.radius = target->GetRadarSize();
+	entry.minX = entry.x - entry.radius;
+	entry.maxX = entry.x + entry.radius;
+	entry.id = target->GetID();
+	entry.sprite = target;
+	targets.push_back( entry );
+}
+
+/**\brief Find every projectile that is inside of a target.
+ * \param hits [out] Each projectile that hit something is appended once.
+ */
+void Broadphase::Run( vector<Collision> *hits ) {
+	numTests = 0;
+	if( projectiles.empty() || targets.empty() ) {
+		return;
+	}
+
+	sort( projectiles.begin(), projectiles.end() );
+	sort( targets.begin(), targets.end() );
+
+	active.clear();
+	unsigned int next = 0;
+	vector<Entry>::iterator p;
+	for( p = projectiles.begin(); p != projectiles.end(); ++p ) {
+		// Targets that start before the sweep line join the active list.
+		while( next < targets.size() && targets[next].minX <= p->x ) {
+			active.push_back( next++ );
+		}
+
+		// Targets that end before the sweep line can never be hit again.
+		unsigned int kept = 0;
+		for( unsigned int a = 0; a < active.size(); a++ ) {
+			if( targets[ active[a] ].maxX >= p->x ) {
+				active[kept++] = active[a];
+			}
+		}
+		active.resize( kept );
+
+		// Pick the nearest target that contains this projectile.
+		Sprite *closest = NULL;
+		double mindist = 0;
+		for( unsigned int a = 0; a < active.size(); a++ ) {
+			const Entry& t = targets[ active[a] ];
+			double dx = p->x - t.x;
+			double dy = p->y - t.y;
+			double dist = dx*dx + dy*dy;
+			numTests++;
+			if( dist >= t.radius*t.radius || t.id == p->id ) {
+				continue;
+			}
+			if( closest == NULL || dist < mindist ) {
+				closest = t.sprite;
+				mindist = dist;
+			}
+		}
+
+		if( closest != NULL ) {
+			Collision hit;
+			hit.projectile = p->sprite;
+			hit.target = closest;
+			hits->push_back( hit );
+		}
+	}
+}
+
+/** @} */
@@ -0,0 +1,49 @@
+/**\file			broadphase.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Sort and sweep collision detection between projectiles and targets
+ * \details
+ */
+
+#ifndef __H_BROADPHASE__
+#define __H_BROADPHASE__
+
+#include "includes.h"
+#include "sprites/sprite.h"
+
+// A projectile that is inside of a target.
+struct Collision {
+	Sprite *projectile;
+	Sprite *target;
+};
+
+class Broadphase {
+	public:
+		Broadphase();
+
+		void Clear( void );
+		void AddProjectile( Sprite *projectile, int ignoreID );
+		void AddTarget( Sprite *target );
+
+		void Run( vector<Collision> *hits );
+
+		unsigned int GetNumTests( void ) { return numTests; }
+
+	private:
+		struct Entry {
+			double minX, maxX;  ///< The extent of this Sprite along the sweep axis.
+			double x, y;        ///< The position of this Sprite.
+			double radius;      ///< Zero for projectiles.
+			int id;             ///< Projectiles: the ID of the target they ignore.  Targets: their own ID.
+			Sprite *sprite;
+			bool operator<( const Entry& other ) const { return minX < other.minX; }
+		};
+
+		vector<Entry> projectiles;
+		vector<Entry> targets;
+		vector<unsigned int> active; ///< The targets that overlap the sweep line.
+		unsigned int numTests;       ///< Number of projectile/target pairs tested during the last Run.
+};
+
+#endif // __H_BROADPHASE__
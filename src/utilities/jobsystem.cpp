@@ -0,0 +1,124 @@
+/**\file			jobsystem.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Fixed pool of worker threads for data parallel loops
+ * \details
+ */
+
+#include "includes.h"
+#include "utilities/jobsystem.h"
+#include "utilities/log.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class JobSystem
+ * \brief Splits a loop across a fixed pool of worker threads.
+ * \details
+ * ParallelFor cuts [0,count) into chunks of grain indices.  The workers and
+ * the calling thread take chunks until none are left, and ParallelFor does
+ * not return until every chunk has finished.  This makes each ParallelFor a
+ * barrier: everything written by the Job is visible to the caller afterwards.
+ *
+ * Which thread runs which chunk is not deterministic, so a Job must only
+ * write to data owned by its own indices.  Anything else must be collected
+ * and merged by the caller after the loop.
+ *
+ * With zero workers the loop simply runs on the calling thread.
+ */
+
+/**\brief Start the worker threads.
+ * \param workers The number of threads in addition to the calling thread.
+ */
+JobSystem::JobSystem( int workers ) {
+	job = NULL;
+	count = 0;
+	grain = 1;
+	quit = false;
+	SDL_AtomicSet( &next, 0 );
+	start = SDL_CreateSemaphore( 0 );
+	done = SDL_CreateSemaphore( 0 );
+
+	for( int w = 0; w < workers; w++ ) {
+		SDL_Thread *thread = SDL_CreateThread( WorkerMain, "EpiarWorker", this );
+		if( thread == NULL ) {
+			LogMsg(ERR, "Could not start worker thread %d: %s", w, SDL_GetError() );
+			break;
+		}
+		threads.push_back( thread );
+	}
+	if( threads.size() ) {
+		LogMsg(INFO, "Started %d worker threads.", static_cast<int>( threads.size() ) );
+	}
+}
+
+/**\brief Stop the worker threads.
+ */
+JobSystem::~JobSystem() {
+	quit = true;
+	for( unsigned int w = 0; w < threads.size(); w++ ) {
+		SDL_SemPost( start );
+	}
+	for( unsigned int w = 0; w < threads.size(); w++ ) {
+		SDL_WaitThread( threads[w], NULL );
+	}
+	SDL_DestroySemaphore( start );
+	SDL_DestroySemaphore( done );
+}
+
+/**\brief Run job over [0,count) and wait for it to finish.
+ * \param grain The number of indices in each chunk.
+ */
+void JobSystem::ParallelFor( int count, int grain, Job *job ) {
+	if( count <= 0 ) {
+		return;
+	}
+	if( threads.empty() || count <= grain ) {
+		job->Run( 0, count );
+		return;
+	}
+
+	this->job = job;
+	this->count = count;
+	this->grain = grain > 0 ? grain : 1;
+	SDL_AtomicSet( &next, 0 );
+
+	for( unsigned int w = 0; w < threads.size(); w++ ) {
+		SDL_SemPost( start );
+	}
+	RunChunks();
+	for( unsigned int w = 0; w < threads.size(); w++ ) {
+		SDL_SemWait( done );
+	}
+	this->job = NULL;
+}
+
+/**\brief Take chunks until there are none left.
+ */
+void JobSystem::RunChunks( void ) {
+	for(;;) {
+		int begin = SDL_AtomicAdd( &next, grain );
+		if( begin >= count ) {
+			return;
+		}
+		job->Run( begin, begin + grain < count ? begin + grain : count );
+	}
+}
+
+/**\brief The loop of each worker thread.
+ */
+int JobSystem::WorkerMain( void *data ) {
+	JobSystem *jobs = static_cast<JobSystem*>( data );
+	for(;;) {
+		SDL_SemWait( jobs->start );
+		if( jobs->quit ) {
+			return 0;
+		}
+		jobs->RunChunks();
+		SDL_SemPost( jobs->done );
+	}
+}
+
+/** @} */
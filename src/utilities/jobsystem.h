@@ -0,0 +1,46 @@
+/**\file			jobsystem.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Fixed pool of worker threads for data parallel loops
+ * \details
+ */
+
+#ifndef __H_JOBSYSTEM__
+#define __H_JOBSYSTEM__
+
+#include "includes.h"
+
+// One loop body.  Run is called with disjoint [begin,end) ranges, possibly at the same time.
+class Job {
+	public:
+		virtual ~Job() {}
+		virtual void Run( int begin, int end ) = 0;
+};
+
+class JobSystem {
+	public:
+		JobSystem( int workers );
+		~JobSystem();
+
+		void ParallelFor( int count, int grain, Job *job );
+
+		int GetNumWorkers( void ) { return threads.size(); }
+
+	private:
+		static int WorkerMain( void *data );
+		void RunChunks( void );
+
+		vector<SDL_Thread*> threads;
+		SDL_sem *start;       ///< Posted once per worker to start a loop.
+		SDL_sem *done;        ///< Posted by each worker when it runs out of chunks.
+
+		// The current loop.  Only written while the workers are waiting.
+		Job *job;
+		int count;
+		int grain;
+		SDL_atomic_t next;    ///< The first index of the next chunk.
+		bool quit;
+};
+
+#endif // __H_JOBSYSTEM__
@@ -14,8 +14,9 @@
 /**\class Log
  * \brief Main logging facilities for the code base. */
 
-/**\brief Empty destructor.*/
+/**\brief Destructor.*/
 Log::~Log() {
+	SDL_DestroyMutex( lock );
 }
 
 /**\brief Retrieves the current instance of the log class.*/
@@ -116,6 +117,9 @@ void Log::realLog( LogLevel lvl, const string& func, const char *message, ... )
 	static char logBuffer[4096] = {0};
 	static queue<LogEntry> preOptionsBuffer;
 
+	// The AI shards log from worker threads, and the buffers above are shared.
+	SDL_LockMutex( lock );
+
 	time( &rawtime );
 
 	timestamp = ctime( &rawtime );
@@ -171,6 +175,8 @@ void Log::realLog( LogLevel lvl, const string& func, const char *message, ... )
 		// Messages before the options are available
 		preOptionsBuffer.push( LogEntry(func, lvl, logBuffer) );
 	}
+
+	SDL_UnlockMutex( lock );
 }
 
 /**\brief Constructor, used to initialize variables.*/
@@ -214,6 +220,7 @@ Log::Log()
 	logFilename = string("Epiar-Log-") + GetTimestamp() + string(".xml");
 
 	fp = NULL;
+	lock = SDL_CreateMutex();
 }
 
 string Log::GetTimestamp( void ) {
@@ -85,6 +85,7 @@ class Log {
 		char *timestamp;
 		string logFilename;
 		FILE *fp; // pointer to the log
+		SDL_mutex *lock; // Lets worker threads log
 };
 
 class LogEntry {
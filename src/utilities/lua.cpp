@@ -13,6 +13,7 @@
 #include "utilities/file.h"
 #include "utilities/lua.h"
 #include "utilities/log.h"
+#include "utilities/luacost.h"
 
 /**\class Lua
  * \brief Lua subsystem. */
@@ -21,8 +22,6 @@ bool Lua::luaInitialized = false;
 lua_State *Lua::L = NULL;
 
 bool Lua::Load( const string& filename ) {
-	File pathTranslator; // use this to determine the physfs-resolved path, e.g. absolute/full path
-
 	if( ! luaInitialized ) {
 		if( Init() == false ) {
 			LogMsg(WARN, "Could not load Lua script. Unable to initialize Lua." );
@@ -30,6 +29,15 @@ bool Lua::Load( const string& filename ) {
 		}
 	}
 
+	return Load( L, filename );
+}
+
+/**\brief Load and run a Lua script in a Lua state other than the main one.
+ * \see AIShard
+ */
+bool Lua::Load( lua_State *L, const string& filename ) {
+	File pathTranslator; // use this to determine the physfs-resolved path, e.g. absolute/full path
+
 	if( pathTranslator.OpenRead( filename ) == false ) {
 		LogMsg(ERR,"Error loading '%s' from filesystem", filename.c_str());
 		return false;
@@ -187,6 +195,7 @@ bool Lua::Init() {
 		LogMsg(WARN, "Could not initialize Lua VM." );
 		return( false );
 	}
+	LuaCost::Attach( L );
 
 	luaL_openlibs( L );
 
@@ -199,6 +208,7 @@ bool Lua::Init() {
 
 bool Lua::Close() {
 	if( luaInitialized ) {
+		LuaCost::Detach( L );
 		lua_close( L );
 		L = NULL;
 		luaInitialized = false;
@@ -223,6 +233,10 @@ int Lua::ErrorCatch(lua_State *L) {
 }
 
 void Lua::RegisterGlobal(string name, int value) {
+	RegisterGlobal( L, name, value );
+}
+
+void Lua::RegisterGlobal(lua_State *L, string name, int value) {
 	lua_pushinteger(L, value );
 	lua_setglobal(L, name.c_str() );
 }
@@ -28,6 +28,7 @@ class Lua {
 		static bool Close();
 
 		static bool Load( const string& filename );
+		static bool Load( lua_State *L, const string& filename );
 		static int Run( string line, bool allowReturns=false );
 		static bool Call(const char *func, const char *sig="", ...);
 
@@ -36,6 +37,7 @@ class Lua {
 		static void RegisterFunctions();
 
 		static void RegisterGlobal(string name, int value);
+		static void RegisterGlobal(lua_State *L, string name, int value);
 		static void RegisterGlobal(string name, float value);
 		static void RegisterGlobal(string name, string value);
 
@@ -0,0 +1,316 @@
+/**\file			luacost.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Accounts for the time and memory used by each Lua behavior
+ * \details
+ */
+
+#include "includes.h"
+#include "utilities/log.h"
+#include "utilities/luacost.h"
+
+/**\class LuaCost
+ * \brief Finds the Lua behaviors that use the most time.
+ * \details
+ * Each call from the engine into a Lua behavior is timed with a
+ * LuaCostTimer, and the time is added up by what was called:
+ * - "AI" by state machine and state, from AI::Decide
+ * - "Mission" by Mission type and function, from Mission::RunFunction
+ * - "StatusBar" by updater, from StatusBar::Update
+ * - "Input" by command, from Input::HandleLuaCallBacks
+ *
+ * Every lua_State is Attached when it is created.  This replaces its
+ * allocator with one that counts the bytes allocated, and gives it a table of
+ * costs of its own, so that the AIShards can record costs on their own
+ * threads without locking.  The tables are only added together for a report,
+ * which must be on the main thread while the AIShards are not thinking.
+ * The allocator also keeps track of the memory each lua_State is using, which
+ * is shown by MemoryReport.
+ *
+ * From the console:
+ *   Profiler.startLuaCosts()    clears the costs and starts recording
+ *   Profiler.luaCosts(rows)     lists the most expensive behaviors
+ *   Profiler.stopLuaCosts()     stops recording
+ * While recording, a Profiler trace also shows the cost of each behavior in
+ * each frame.
+ */
+
+bool LuaCost::enabled = false;
+vector<LuaCost::State*> LuaCost::states;
+
+/**\brief Start counting the memory allocated by a lua_State.
+ * \details Call this right after creating L, and Detach it before closing it.
+ */
+void LuaCost::Attach( lua_State *L ) {
+	State *state = new State();
+	state->L = L;
+	state->alloc = lua_getallocf( L, &state->ud );
+	state->allocated = 0;
+	// Whatever lua_open allocated before this was Attached is not counted.
+	state->inUse = lua_gc( L, LUA_GCCOUNT, 0 ) * 1024 + lua_gc( L, LUA_GCCOUNTB, 0 );
+	lua_setallocf( L, &LuaCost::Allocate, state );
+	states.push_back( state );
+}
+
+/**\brief Stop counting for a lua_State that is about to be closed.
+ * \details The original allocator is put back, and it frees everything.
+ */
+void LuaCost::Detach( lua_State *L ) {
+	for( unsigned int s = 0; s < states.size(); s++ ) {
+		if( states[s]->L == L ) {
+			lua_setallocf( L, states[s]->alloc, states[s]->ud );
+			delete states[s];
+			states.erase( states.begin() + s );
+			return;
+		}
+	}
+}
+
+/**\brief Counts the growth of each allocation, then passes it on.
+ */
+void *LuaCost::Allocate( void *ud, void *ptr, size_t osize, size_t nsize ) {
+	State *state = static_cast<State*>( ud );
+	// Lua 5.1 passes an osize of 0 when ptr is NULL.
+	if( nsize > osize ) {
+		state->allocated += nsize - osize;
+	}
+	state->inUse += nsize;
+	state->inUse -= ( ptr != NULL ) ? osize : 0;
+	return state->alloc( state->ud, ptr, osize, nsize );
+}
+
+/**\brief The accounting of a lua_State, or NULL if it was never Attached.
+ */
+LuaCost::State *LuaCost::GetState( lua_State *L ) {
+	void *ud;
+	if( lua_getallocf( L, &ud ) != &LuaCost::Allocate ) {
+		return NULL;
+	}
+	return static_cast<State*>( ud );
+}
+
+/**\brief Clear all of the costs and start recording.
+ */
+void LuaCost::Start( void ) {
+	for( unsigned int s = 0; s < states.size(); s++ ) {
+		states[s]->costs.clear();
+	}
+	enabled = true;
+	LogMsg(INFO, "Started recording the cost of the Lua behaviors." );
+}
+
+/**\brief Stop recording.  The costs are kept for the report.
+ */
+void LuaCost::Stop( void ) {
+	enabled = false;
+}
+
+/**\brief The total bytes that L has allocated since it was Attached.
+ */
+Uint64 LuaCost::GetAllocated( lua_State *L ) {
+	State *state = GetState( L );
+	return ( state != NULL ) ? state->allocated : 0;
+}
+
+/**\brief The memory in use by every Attached lua_State.
+ */
+Uint64 LuaCost::GetHeapBytes( void ) {
+	Uint64 bytes = 0;
+	for( unsigned int s = 0; s < states.size(); s++ ) {
+		bytes += states[s]->inUse;
+	}
+	return bytes;
+}
+
+/**\brief Add the cost of one call.
+ * \param kind A string literal, such as "AI".
+ */
+void LuaCost::Record( lua_State *L, const char *kind, const string& group, const string& name, Uint64 ticks, Uint64 bytes ) {
+	State *state = GetState( L );
+	if( state == NULL ) {
+		return;
+	}
+	Cost &cost = state->costs[ kind ][ group ][ name ];
+	cost.calls++;
+	cost.ticks += ticks;
+	cost.bytes += bytes;
+	if( ticks > cost.maxTicks ) {
+		cost.maxTicks = ticks;
+	}
+}
+
+// Orders the report from the most to the least time.
+static bool MoreExpensive( const LuaCost::Row &a, const LuaCost::Row &b ) {
+	return a.cost.ticks > b.cost.ticks;
+}
+
+/**\brief Add up the costs of every lua_State.
+ * \param rows [out] Sorted from the most to the least total time.
+ */
+void LuaCost::GetReport( vector<Row> *rows ) {
+	map<string, Cost> totals;
+	for( unsigned int s = 0; s < states.size(); s++ ) {
+		for( KindCosts::iterator k = states[s]->costs.begin(); k != states[s]->costs.end(); ++k ) {
+			for( GroupCosts::iterator g = k->second.begin(); g != k->second.end(); ++g ) {
+				for( NameCosts::iterator n = g->second.begin(); n != g->second.end(); ++n ) {
+					string rowName = string( k->first ) + " " + g->first;
+					if( !n->first.empty() ) {
+						rowName += "." + n->first;
+					}
+					Cost &total = totals[ rowName ];
+					total.calls += n->second.calls;
+					total.ticks += n->second.ticks;
+					total.bytes += n->second.bytes;
+					total.maxTicks = max( total.maxTicks, n->second.maxTicks );
+				}
+			}
+		}
+	}
+
+	rows->clear();
+	for( map<string, Cost>::iterator t = totals.begin(); t != totals.end(); ++t ) {
+		Row row;
+		row.name = t->first;
+		row.cost = t->second;
+		rows->push_back( row );
+	}
+	sort( rows->begin(), rows->end(), MoreExpensive );
+}
+
+// Write a string as the contents of a JSON string.
+static void WriteJSONString( FILE *file, const string& text ) {
+	for( unsigned int c = 0; c < text.size(); c++ ) {
+		unsigned char letter = text[c];
+		if( letter == '"' || letter == '\\' ) {
+			fprintf( file, "\\%c", letter );
+		} else if( letter < 0x20 ) {
+			fprintf( file, "\\u%04x", letter );
+		} else {
+			fputc( letter, file );
+		}
+	}
+}
+
+/**\brief Append the time each behavior took since the last call to a Chrome trace.
+ * \details This is one counter ("C") event, so that the behaviors are
+ *          stacked on one track.
+ * \param ts The timestamp, in microseconds.
+ */
+void LuaCost::WriteTrace( FILE *trace, double ts ) {
+	if( !enabled ) {
+		return;
+	}
+	double msPerTick = 1000.0 / static_cast<double>( SDL_GetPerformanceFrequency() );
+	bool first = true;
+
+	fprintf( trace, ",\n{\"name\":\"Lua cost\",\"cat\":\"lua\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":1,\"args\":{", ts );
+	for( unsigned int s = 0; s < states.size(); s++ ) {
+		for( KindCosts::iterator k = states[s]->costs.begin(); k != states[s]->costs.end(); ++k ) {
+			for( GroupCosts::iterator g = k->second.begin(); g != k->second.end(); ++g ) {
+				for( NameCosts::iterator n = g->second.begin(); n != g->second.end(); ++n ) {
+					Cost &cost = n->second;
+					if( cost.ticks == cost.reportedTicks ) {
+						continue;
+					}
+					fprintf( trace, "%s\"%s ", first ? "" : ",", k->first );
+					WriteJSONString( trace, g->first );
+					if( !n->first.empty() ) {
+						fputc( '.', trace );
+						WriteJSONString( trace, n->first );
+					}
+					fprintf( trace, "\":%.4f", ( cost.ticks - cost.reportedTicks ) * msPerTick );
+					cost.reportedTicks = cost.ticks;
+					first = false;
+				}
+			}
+		}
+	}
+	fprintf( trace, "}}" );
+}
+
+/**\brief Same as LuaCost::Start (Lua callable)
+ */
+int LuaCost::lua_start( lua_State *L ) {
+	Start();
+	return 0;
+}
+
+/**\brief Same as LuaCost::Stop (Lua callable)
+ */
+int LuaCost::lua_stop( lua_State *L ) {
+	Stop();
+	return 0;
+}
+
+/**\brief The most expensive behaviors, one string per line (Lua callable)
+ * \details The console shows each returned value on its own line.
+ */
+int LuaCost::lua_report( lua_State *L ) {
+	int count = 6;
+	if( lua_gettop(L) >= 1 ) {
+		count = luaL_checkint(L, 1);
+	}
+
+	vector<Row> rows;
+	GetReport( &rows );
+
+	Uint64 totalTicks = 0;
+	for( unsigned int r = 0; r < rows.size(); r++ ) {
+		totalTicks += rows[r].cost.ticks;
+	}
+
+	// Make room for the header and one string per row before pushing any of them.
+	int shown = max( 0, min( count, static_cast<int>( rows.size() ) ) );
+	luaL_checkstack(L, shown + 1, "report");
+
+	double msPerTick = 1000.0 / static_cast<double>( SDL_GetPerformanceFrequency() );
+	char line[256];
+	int lines = 1;
+	snprintf( line, sizeof(line), "%6s %10s %8s %9s %9s %9s  %s%s",
+		"share", "total ms", "calls", "us/call", "max us", "KB", "behavior", enabled ? "" : " (stopped)" );
+	lua_pushstring(L, line);
+
+	for( int r = 0; r < shown; r++ ) {
+		const Cost &cost = rows[r].cost;
+		snprintf( line, sizeof(line), "%5.1f%% %10.2f %8u %9.1f %9.1f %9.1f  %s",
+			totalTicks ? 100.0 * cost.ticks / totalTicks : 0.0,
+			cost.ticks * msPerTick,
+			cost.calls,
+			cost.calls ? 1000.0 * cost.ticks * msPerTick / cost.calls : 0.0,
+			1000.0 * cost.maxTicks * msPerTick,
+			cost.bytes / 1024.0,
+			rows[r].name.c_str() );
+		lua_pushstring(L, line);
+		lines++;
+	}
+	return lines;
+}
+
+/**\class LuaCostTimer
+ * \brief Measures one call into Lua for LuaCost.
+ * \details Create one just before lua_pcall and Stop it just after.
+ */
+
+/**\brief Note the time and the memory allocated so far.
+ */
+LuaCostTimer::LuaCostTimer( lua_State *L ) {
+	if( !LuaCost::IsEnabled() ) {
+		this->L = NULL;
+		return;
+	}
+	this->L = L;
+	startBytes = LuaCost::GetAllocated( L );
+	startTicks = SDL_GetPerformanceCounter();
+}
+
+/**\brief Record the call.
+ * \param kind A string literal, such as "AI".
+ */
+void LuaCostTimer::Stop( const char *kind, const string& group, const string& name ) {
+	if( L == NULL ) {
+		return;
+	}
+	Uint64 ticks = SDL_GetPerformanceCounter() - startTicks;
+	LuaCost::Record( L, kind, group, name, ticks, LuaCost::GetAllocated( L ) - startBytes );
+}
@@ -0,0 +1,89 @@
+/**\file			luacost.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Accounts for the time and memory used by each Lua behavior
+ * \details
+ */
+
+#ifndef __H_LUACOST__
+#define __H_LUACOST__
+
+#include "includes.h"
+#include "utilities/lua.h"
+
+class LuaCost {
+	public:
+		/// What one Lua behavior has cost since accounting started.
+		struct Cost {
+			Cost() : calls(0), ticks(0), maxTicks(0), bytes(0), reportedTicks(0) {}
+
+			Uint32 calls;
+			Uint64 ticks;         ///< Measured with SDL_GetPerformanceCounter.
+			Uint64 maxTicks;      ///< The slowest single call.
+			Uint64 bytes;         ///< Allocated by Lua, not counting what was freed.
+			Uint64 reportedTicks; ///< ticks when the Profiler trace last saw this.
+		};
+
+		/// One line of the report.
+		struct Row {
+			string name;          ///< "AI Hunter.Hunting", "Mission Patrol.Update", ...
+			Cost cost;
+		};
+
+		static void Attach( lua_State *L );
+		static void Detach( lua_State *L );
+
+		static bool IsEnabled( void ) { return enabled; }
+		static void Start( void );
+		static void Stop( void );
+
+		static Uint64 GetAllocated( lua_State *L );
+		static int GetNumStates( void ) { return states.size(); }
+		static Uint64 GetHeapBytes( void );
+		static void Record( lua_State *L, const char *kind, const string& group, const string& name, Uint64 ticks, Uint64 bytes );
+
+		static void GetReport( vector<Row> *rows );
+		static void WriteTrace( FILE *trace, double ts );
+
+		// Lua functions
+		static int lua_start( lua_State *L );
+		static int lua_stop( lua_State *L );
+		static int lua_report( lua_State *L );
+
+	private:
+		// kind -> group -> name, so that recording a call never builds a new string.
+		typedef map<string, Cost> NameCosts;
+		typedef map<string, NameCosts> GroupCosts;
+		typedef map<const char*, GroupCosts> KindCosts;
+
+		/// Stands in for the allocator of one lua_State.
+		struct State {
+			lua_State *L;
+			lua_Alloc alloc;
+			void *ud;
+			Uint64 allocated;
+			Uint64 inUse;     ///< What the allocator would free if L were closed now.
+			KindCosts costs;  ///< Only touched by the thread running L.
+		};
+
+		static void *Allocate( void *ud, void *ptr, size_t osize, size_t nsize );
+		static State *GetState( lua_State *L );
+
+		static bool enabled;
+		static vector<State*> states;
+};
+
+/// Measures one call into Lua.  Does nothing unless LuaCost is enabled.
+class LuaCostTimer {
+	public:
+		LuaCostTimer( lua_State *L );
+		void Stop( const char *kind, const string& group, const string& name );
+
+	private:
+		lua_State *L;
+		Uint64 startTicks;
+		Uint64 startBytes;
+};
+
+#endif // __H_LUACOST__
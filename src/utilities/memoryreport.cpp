@@ -0,0 +1,270 @@
+/**\file			memoryreport.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Accounts for the memory held by each subsystem
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "engine/scenario.h"
+#include "engine/scenario_lua.h"
+#include "sprites/ai.h"
+#include "sprites/effects.h"
+#include "sprites/planets.h"
+#include "sprites/player.h"
+#include "sprites/projectile.h"
+#include "sprites/spritemanager.h"
+#include "graphics/font.h"
+#include "graphics/video.h"
+#include "utilities/log.h"
+#include "utilities/luacost.h"
+#include "utilities/memoryreport.h"
+#include "utilities/resource.h"
+#include "utilities/timer.h"
+#include "utilities/xmlfile.h"
+
+/**\class MemoryReport
+ * \brief A snapshot of the memory held by each subsystem.
+ * \details
+ * Nothing is counted while the game runs.  Each subsystem is asked what it
+ * holds when the report is made:
+ * - The Resources, by kind: texture sizes from SDL_QueryTexture, Mix_Chunk
+ *   lengths, and so on.  Resources are never freed, so these only grow.
+ * - The Lua heap of every lua_State, from the allocator that LuaCost installs.
+ * - The Sprites, by kind, estimated from the size of their class.
+ * - The nodes of the spatial index, and the free slots of the SpritePools.
+ * - The XMLFiles that hold a document.
+ *
+ * From the console:
+ *   Memory.report()             lists each subsystem
+ *   Memory.dump("file")         also lists every Resource and XMLFile
+ *   Memory.panel()              toggles the report in the top right corner
+ * With the "options/log/memory" option, the dump is written to Memory.log
+ * when Epiar closes, listing everything that is still referenced.
+ */
+
+bool MemoryReport::panel = false;
+Uint32 MemoryReport::panelTicks = 0;
+vector<string> MemoryReport::panelLines;
+
+// Kinds of Sprites, and the class that each one is.
+static const struct {
+	int drawOrder;
+	const char *name;
+	size_t size;
+} spriteKinds[] = {
+	{ DRAW_ORDER_PLANET, "Sprites: Planets", sizeof(Planet) },
+	{ DRAW_ORDER_PROJECTILE, "Sprites: Projectiles", sizeof(Projectile) },
+	{ DRAW_ORDER_SHIP, "Sprites: Ships", sizeof(AI) },
+	{ DRAW_ORDER_PLAYER, "Sprites: Player", sizeof(Player) },
+	{ DRAW_ORDER_EFFECT, "Sprites: Effects", sizeof(Effect) },
+};
+
+/**\brief Ask each subsystem what it holds.
+ * \param sprites The Sprites to count, or NULL when no Scenario is running.
+ */
+MemoryReport::MemoryReport( SpriteManager *sprites ) {
+	// Resources, by kind.  A Resource stored under several keys is counted once.
+	map<Resource*, list<string> > resources;
+	map<string, pair<int, Uint64> > kinds;
+	Resource::GetAll( &resources );
+	for( map<Resource*, list<string> >::iterator r = resources.begin(); r != resources.end(); ++r ) {
+		pair<int, Uint64> &kind = kinds[ r->first->GetKind() ];
+		kind.first++;
+		kind.second += r->first->GetMemoryUsage();
+	}
+	for( map<string, pair<int, Uint64> >::iterator k = kinds.begin(); k != kinds.end(); ++k ) {
+		Add( k->first, k->second.first, k->second.second );
+	}
+	Add( "Resource keys", Resource::GetNumKeys(), 0 );
+
+	Add( "Lua heap", LuaCost::GetNumStates(), LuaCost::GetHeapBytes() );
+
+	if( sprites != NULL ) {
+		vector<Sprite*> all;
+		sprites->GetSprites( &all );
+		for( unsigned int k = 0; k < sizeof(spriteKinds) / sizeof(spriteKinds[0]); k++ ) {
+			int count = 0;
+			for( unsigned int s = 0; s < all.size(); s++ ) {
+				if( all[s]->GetDrawOrder() == spriteKinds[k].drawOrder ) {
+					count++;
+				}
+			}
+			Add( spriteKinds[k].name, count, static_cast<Uint64>( count ) * spriteKinds[k].size );
+		}
+		Add( "Spatial index nodes", sprites->GetNumIndexNodes(), sprites->GetIndexNodeBytes() );
+	}
+
+	// The slots that are not in use.  The rest were counted with the Sprites.
+	SpritePool *pools[] = { Projectile::GetPool(), Effect::GetPool() };
+	for( unsigned int p = 0; p < sizeof(pools) / sizeof(pools[0]); p++ ) {
+		int unused = pools[p]->GetCapacity() - pools[p]->GetInUse();
+		Add( string( "Free " ) + pools[p]->GetName() + " slots", unused, static_cast<Uint64>( unused ) * pools[p]->GetObjectSize() );
+	}
+
+	Add( "XML documents", XMLFile::GetOpenFiles().size(), 0 );
+}
+
+/**\brief Add one line to the report.
+ */
+void MemoryReport::Add( const string& name, int count, Uint64 bytes ) {
+	Subsystem subsystem;
+	subsystem.name = name;
+	subsystem.count = count;
+	subsystem.bytes = bytes;
+	subsystems.push_back( subsystem );
+}
+
+/**\brief The estimated bytes of every subsystem together.
+ */
+Uint64 MemoryReport::GetTotal( void ) {
+	Uint64 total = 0;
+	for( unsigned int s = 0; s < subsystems.size(); s++ ) {
+		total += subsystems[s].bytes;
+	}
+	return total;
+}
+
+/**\brief Format the report, one subsystem per line.
+ */
+void MemoryReport::Print( vector<string> *lines ) {
+	char line[128];
+	for( unsigned int s = 0; s < subsystems.size(); s++ ) {
+		snprintf( line, sizeof(line), "%-24s %8d %12.1f KB",
+			subsystems[s].name.c_str(), subsystems[s].count, subsystems[s].bytes / 1024.0 );
+		lines->push_back( line );
+	}
+	snprintf( line, sizeof(line), "%-24s %8s %12.1f KB", "Total", "", GetTotal() / 1024.0 );
+	lines->push_back( line );
+}
+
+/**\brief Write the report, every Resource and every open XMLFile to a file.
+ * \details The Resources are sorted from the largest, and list every key
+ *          that refers to them.
+ */
+bool MemoryReport::Dump( const string& filename ) {
+	FILE *file = fopen( filename.c_str(), "w" );
+	if( file == NULL ) {
+		LogMsg(ERR, "Could not open '%s' for the memory report.", filename.c_str() );
+		return false;
+	}
+
+	vector<string> lines;
+	Print( &lines );
+	fprintf( file, "Subsystems:\n" );
+	for( unsigned int l = 0; l < lines.size(); l++ ) {
+		fprintf( file, "  %s\n", lines[l].c_str() );
+	}
+
+	map<Resource*, list<string> > resources;
+	Resource::GetAll( &resources );
+	vector< pair<Uint64, Resource*> > bySize;
+	for( map<Resource*, list<string> >::iterator r = resources.begin(); r != resources.end(); ++r ) {
+		bySize.push_back( make_pair( r->first->GetMemoryUsage(), r->first ) );
+	}
+	sort( bySize.rbegin(), bySize.rend() );
+
+	fprintf( file, "\nResources still referenced: %d\n", static_cast<int>( bySize.size() ) );
+	for( unsigned int r = 0; r < bySize.size(); r++ ) {
+		Resource *resource = bySize[r].second;
+		list<string> &keys = resources[ resource ];
+		fprintf( file, "  %12.1f KB  %-12s", bySize[r].first / 1024.0, resource->GetKind() );
+		for( list<string>::iterator k = keys.begin(); k != keys.end(); ++k ) {
+			fprintf( file, " %s", k->c_str() );
+		}
+		fprintf( file, "\n" );
+	}
+
+	const set<XMLFile*> &files = XMLFile::GetOpenFiles();
+	fprintf( file, "\nXML documents still open: %d\n", static_cast<int>( files.size() ) );
+	for( set<XMLFile*>::const_iterator f = files.begin(); f != files.end(); ++f ) {
+		string name = (*f)->GetFileName();
+		fprintf( file, "  %s\n", name.empty() ? "(not saved)" : name.c_str() );
+	}
+
+	fclose( file );
+	LogMsg(INFO, "Wrote the memory report to '%s'.", filename.c_str() );
+	return true;
+}
+
+/**\brief Draw the report in the top right corner, if the panel is visible.
+ * \details The report is only made again once a second.
+ */
+void MemoryReport::DrawPanel( SpriteManager *sprites ) {
+	if( !panel || Mono == NULL ) {
+		return;
+	}
+	if( panelLines.empty() || Timer::GetTicks() - panelTicks > 1000 ) {
+		MemoryReport report( sprites );
+		panelLines.clear();
+		report.Print( &panelLines );
+		panelTicks = Timer::GetTicks();
+	}
+
+	int lineHeight = Mono->LineHeight();
+	int x = Video::GetWidth() - 370, y = 40;
+	Video::DrawRect( x - 5, y - 5, 365, panelLines.size() * lineHeight + 10, BLACK, 0.6f );
+	Mono->SetColor( WHITE );
+	for( unsigned int l = 0; l < panelLines.size(); l++ ) {
+		Mono->Render( x, y + l * lineHeight, panelLines[l] );
+	}
+}
+
+/**\brief Register the MemoryReport with the Lua console.
+ */
+void MemoryReport::RegisterMemory( lua_State *L ) {
+	static const luaL_Reg memoryFunctions[] = {
+		{"report", &MemoryReport::lua_report},
+		{"dump", &MemoryReport::lua_dump},
+		{"panel", &MemoryReport::lua_panel},
+		{NULL, NULL}
+	};
+
+	luaL_openlib(L, EPIAR_MEMORY, memoryFunctions, 0);
+
+	lua_pop(L,1);
+}
+
+// The Sprites of the running Scenario, if there is one.
+static SpriteManager *GetSprites( lua_State *L ) {
+	Scenario *scenario = Scenario_Lua::GetScenario( L );
+	return ( scenario != NULL ) ? scenario->GetSpriteManager() : NULL;
+}
+
+/**\brief The report, one string per line (Lua callable)
+ * \details The console shows each returned value on its own line.
+ */
+int MemoryReport::lua_report( lua_State *L ) {
+	MemoryReport report( GetSprites( L ) );
+	vector<string> lines;
+	report.Print( &lines );
+	for( unsigned int l = 0; l < lines.size(); l++ ) {
+		lua_pushstring(L, lines[l].c_str() );
+	}
+	return lines.size();
+}
+
+/**\brief Same as MemoryReport::Dump (Lua callable)
+ */
+int MemoryReport::lua_dump( lua_State *L ) {
+	if( lua_gettop(L) != 1 ) {
+		return luaL_error(L, "Got %d arguments expected 1 (filename)", lua_gettop(L) );
+	}
+	MemoryReport report( GetSprites( L ) );
+	lua_pushboolean(L, report.Dump( luaL_checkstring(L, 1) ) );
+	return 1;
+}
+
+/**\brief Toggle the panel, or set it when given a boolean (Lua callable)
+ */
+int MemoryReport::lua_panel( lua_State *L ) {
+	if( lua_gettop(L) >= 1 ) {
+		SetPanel( lua_toboolean(L, 1) != 0 );
+	} else {
+		SetPanel( !GetPanel() );
+	}
+	lua_pushboolean(L, GetPanel() );
+	return 1;
+}
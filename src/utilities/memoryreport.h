@@ -0,0 +1,57 @@
+/**\file			memoryreport.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Accounts for the memory held by each subsystem
+ * \details
+ */
+
+#ifndef __H_MEMORYREPORT__
+#define __H_MEMORYREPORT__
+
+#include "includes.h"
+#include "utilities/lua.h"
+
+#define EPIAR_MEMORY "Memory"
+
+class SpriteManager;
+
+class MemoryReport {
+	public:
+		/// One line of the report.
+		struct Subsystem {
+			string name;
+			int count;
+			Uint64 bytes;    ///< An estimate.  0 when it cannot be known.
+		};
+
+		MemoryReport( SpriteManager *sprites = NULL );
+
+		const vector<Subsystem>& GetSubsystems( void ) { return subsystems; }
+		Uint64 GetTotal( void );
+
+		void Print( vector<string> *lines );
+		bool Dump( const string& filename );
+
+		static void SetPanel( bool visible ) { panel = visible; }
+		static bool GetPanel( void ) { return panel; }
+		static void DrawPanel( SpriteManager *sprites );
+
+		static void RegisterMemory( lua_State *L );
+
+		// Lua functions
+		static int lua_report( lua_State *L );
+		static int lua_dump( lua_State *L );
+		static int lua_panel( lua_State *L );
+
+	private:
+		void Add( const string& name, int count, Uint64 bytes );
+
+		vector<Subsystem> subsystems;
+
+		static bool panel;
+		static Uint32 panelTicks;          ///< When panelLines were last refreshed.
+		static vector<string> panelLines;
+};
+
+#endif // __H_MEMORYREPORT__
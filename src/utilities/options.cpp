@@ -47,6 +47,7 @@ void Options::Initialize( void ) {
 	defaults.insert( std::pair<string,string>("options/log/alert", "0") );
 	defaults.insert( std::pair<string,string>("options/log/ui", "0") );
 	defaults.insert( std::pair<string,string>("options/log/sprites", "0") );
+	defaults.insert( std::pair<string,string>("options/log/memory", "0") );
 
 	// Video
 	defaults.insert( std::pair<string,string>("options/video/w", "1024") );
@@ -54,6 +55,11 @@ void Options::Initialize( void ) {
 	defaults.insert( std::pair<string,string>("options/video/bpp", "32") );
 	defaults.insert( std::pair<string,string>("options/video/fullscreen", "0") );
 	defaults.insert( std::pair<string,string>("options/video/fps", "60") );
+	defaults.insert( std::pair<string,string>("options/video/atlas", "1") );
+	defaults.insert( std::pair<string,string>("options/video/stars", "700") );
+	defaults.insert( std::pair<string,string>("options/video/glyph-atlas", "1") );
+	defaults.insert( std::pair<string,string>("options/video/text-cache", "2048") );
+	defaults.insert( std::pair<string,string>("options/video/ui-cache", "1") );
 
 	// Sound
 	defaults.insert( std::pair<string,string>("options/sound/disable-audio", "0") );
@@ -67,6 +73,14 @@ void Options::Initialize( void ) {
 
 	// Simultaion
 	defaults.insert( std::pair<string,string>("options/scenario/automatic-load", "0") );
+	defaults.insert( std::pair<string,string>("options/simulation/spatial-index", "quadtree") );
+	defaults.insert( std::pair<string,string>("options/simulation/grid-cell-size", "512") );
+	defaults.insert( std::pair<string,string>("options/simulation/update-threads", "0") );
+	defaults.insert( std::pair<string,string>("options/simulation/ai-lod", "1") );
+	defaults.insert( std::pair<string,string>("options/simulation/ai-think-near", "1") );
+	defaults.insert( std::pair<string,string>("options/simulation/ai-think-quadrant", "4") );
+	defaults.insert( std::pair<string,string>("options/simulation/ai-think-far", "30") );
+	defaults.insert( std::pair<string,string>("options/simulation/lua-shards", "0") );
 
 	// Timing
 	defaults.insert( std::pair<string,string>("options/timing/mouse-fade", "500") );
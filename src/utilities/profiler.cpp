@@ -0,0 +1,303 @@
+/**\file			profiler.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Times the phases of each frame
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "graphics/font.h"
+#include "graphics/video.h"
+#include "utilities/log.h"
+#include "utilities/luacost.h"
+#include "utilities/profiler.h"
+
+/**\class Profiler
+ * \brief Records a tree of timed blocks for every frame.
+ * \details
+ * Scenario::Run marks the start and end of each frame, and the phases of the
+ * frame are marked with PROFILE_SCOPE.  Blocks that run once per Sprite are
+ * summed with Accumulate instead, so that a frame has one entry per kind of
+ * Sprite rather than one per Sprite.  Every draw call reports the texture it
+ * used, so the number of draw calls and texture switches are counted as well.
+ * Each Video primitive counts as one untextured draw call.
+ *
+ * Nothing is recorded unless the overlay is visible or a trace is being
+ * written, so the markers can be left in the main loop.  Only the main thread
+ * may use the Profiler.
+ *
+ * From the console:
+ *   Profiler.overlay()          toggles the overlay
+ *   Profiler.trace("file")      writes every frame to a Chrome trace
+ *   Profiler.stopTrace()        finishes the trace
+ * The Lua behaviors are accounted for separately.
+ * \see LuaCost
+ * The trace can be opened with chrome://tracing or https://ui.perfetto.dev
+ */
+
+bool Profiler::overlay = false;
+bool Profiler::inFrame = false;
+FILE *Profiler::trace = NULL;
+bool Profiler::traceFirst = true;
+Uint64 Profiler::traceStart = 0;
+vector<Profiler::Event> Profiler::events;
+vector<int> Profiler::open;
+vector<Profiler::Event> Profiler::lastFrame;
+Uint64 Profiler::frameStart = 0;
+Uint64 Profiler::lastFrameTicks = 0;
+const void *Profiler::lastTexture = NULL;
+int Profiler::drawCalls = 0;
+int Profiler::textureSwitches = 0;
+int Profiler::lastDrawCalls = 0;
+int Profiler::lastTextureSwitches = 0;
+
+/**\brief Start recording a frame, if anything will use it.
+ */
+void Profiler::BeginFrame( void ) {
+	inFrame = overlay || ( trace != NULL );
+	if( !inFrame ) {
+		return;
+	}
+	// clear() keeps the capacity, so recording does not allocate once warmed up.
+	events.clear();
+	open.clear();
+	lastTexture = NULL;
+	drawCalls = 0;
+	textureSwitches = 0;
+	frameStart = SDL_GetPerformanceCounter();
+}
+
+/**\brief Finish recording a frame and hand it to the overlay and the trace.
+ */
+void Profiler::EndFrame( void ) {
+	if( !inFrame ) {
+		return;
+	}
+	// Close anything left open by an early return.
+	while( !open.empty() ) {
+		Pop();
+	}
+	lastFrameTicks = SDL_GetPerformanceCounter() - frameStart;
+	lastDrawCalls = drawCalls;
+	lastTextureSwitches = textureSwitches;
+	lastFrame.swap( events );
+
+	if( trace != NULL ) {
+		WriteTrace();
+	}
+	inFrame = false;
+}
+
+/**\brief Begin a timed block.
+ * \param name Must outlive the frame; a string literal is best.
+ */
+void Profiler::Push( const char *name ) {
+	if( !inFrame ) {
+		return;
+	}
+	Event event;
+	event.name = name;
+	event.depth = open.size();
+	event.calls = 1;
+	event.ticks = 0;
+	open.push_back( events.size() );
+	events.push_back( event );
+	events.back().start = SDL_GetPerformanceCounter();
+}
+
+/**\brief End the most recent timed block.
+ */
+void Profiler::Pop( void ) {
+	if( !inFrame || open.empty() ) {
+		return;
+	}
+	Event &event = events[ open.back() ];
+	event.ticks = SDL_GetPerformanceCounter() - event.start;
+	open.pop_back();
+}
+
+/**\brief Add time to a child of the current block.
+ * \details Every call with the same name within the same block is summed
+ *          into one entry.
+ * \param ticks Measured with SDL_GetPerformanceCounter.
+ */
+void Profiler::Accumulate( const char *name, Uint64 ticks ) {
+	if( !inFrame ) {
+		return;
+	}
+	int depth = open.size();
+	int first = open.empty() ? 0 : open.back() + 1;
+	for( int e = events.size() - 1; e >= first; e-- ) {
+		if( events[e].depth == depth && events[e].name == name ) {
+			events[e].ticks += ticks;
+			events[e].calls++;
+			return;
+		}
+	}
+
+	Event event;
+	event.name = name;
+	event.depth = depth;
+	event.calls = 1;
+	event.start = SDL_GetPerformanceCounter() - ticks;
+	event.ticks = ticks;
+	events.push_back( event );
+}
+
+/**\brief Count a draw call.
+ * \param texture The texture drawn, or NULL for untextured primitives.
+ */
+void Profiler::CountDraw( const void *texture ) {
+	if( !inFrame ) {
+		return;
+	}
+	drawCalls++;
+	if( texture != lastTexture ) {
+		textureSwitches++;
+		lastTexture = texture;
+	}
+}
+
+/**\brief Begin writing every frame to a Chrome trace file.
+ */
+bool Profiler::StartTrace( const string& filename ) {
+	StopTrace();
+	trace = fopen( filename.c_str(), "w" );
+	if( trace == NULL ) {
+		LogMsg(ERR, "Could not open '%s' for the profiler trace.", filename.c_str() );
+		return false;
+	}
+	fprintf( trace, "{\"traceEvents\":[\n" );
+	traceFirst = true;
+	traceStart = SDL_GetPerformanceCounter();
+	LogMsg(INFO, "Writing the profiler trace to '%s'.", filename.c_str() );
+	return true;
+}
+
+/**\brief Finish the Chrome trace file.
+ */
+void Profiler::StopTrace( void ) {
+	if( trace == NULL ) {
+		return;
+	}
+	fprintf( trace, "\n]}\n" );
+	fclose( trace );
+	trace = NULL;
+}
+
+/**\brief Append the last frame to the trace.
+ * \details Blocks become complete ("X") events.  Accumulated times and the
+ *          draw counts become counter ("C") events, since they did not run
+ *          as one contiguous block.
+ */
+void Profiler::WriteTrace( void ) {
+	double usPerTick = 1e6 / static_cast<double>( SDL_GetPerformanceFrequency() );
+	double frameTs = ( frameStart - traceStart ) * usPerTick;
+
+	fprintf( trace, "%s{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+		traceFirst ? "" : ",\n", frameTs, lastFrameTicks * usPerTick );
+	traceFirst = false;
+
+	for( unsigned int e = 0; e < lastFrame.size(); e++ ) {
+		const Event &event = lastFrame[e];
+		double ts = ( event.start - traceStart ) * usPerTick;
+		if( event.calls > 1 ) {
+			fprintf( trace, ",\n{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":1,\"args\":{\"ms\":%.4f,\"calls\":%d}}",
+				event.name, ts, event.ticks * usPerTick / 1000.0, event.calls );
+		} else {
+			fprintf( trace, ",\n{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+				event.name, ts, event.ticks * usPerTick );
+		}
+	}
+
+	fprintf( trace, ",\n{\"name\":\"Draws\",\"cat\":\"frame\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":1,\"args\":{\"calls\":%d,\"texture switches\":%d}}",
+		frameTs, lastDrawCalls, lastTextureSwitches );
+	LuaCost::WriteTrace( trace, frameTs );
+}
+
+/**\brief Draw the last frame's timings in the top left corner.
+ */
+void Profiler::DrawOverlay( void ) {
+	if( !overlay || BitType == NULL ) {
+		return;
+	}
+
+	// The overlay should not count its own draw calls.
+	bool recording = inFrame;
+	inFrame = false;
+
+	double msPerTick = 1000.0 / static_cast<double>( SDL_GetPerformanceFrequency() );
+	int lineHeight = BitType->LineHeight();
+	int lines = min( static_cast<int>( lastFrame.size() ) + 1, ( Video::GetHeight() - 40 ) / lineHeight );
+	int x = 10, y = 40;
+	char line[128];
+
+	Video::DrawRect( x - 5, y - 5, 320, lines * lineHeight + 10, BLACK, 0.6f );
+	BitType->SetColor( WHITE );
+
+	snprintf( line, sizeof(line), "Frame %.2f ms  %d draws  %d texture switches",
+		lastFrameTicks * msPerTick, lastDrawCalls, lastTextureSwitches );
+	BitType->Render( x, y, line );
+
+	for( int e = 0; e + 1 < lines; e++ ) {
+		const Event &event = lastFrame[e];
+		y += lineHeight;
+		if( event.calls > 1 ) {
+			snprintf( line, sizeof(line), "%s  %.2f ms  x%d", event.name, event.ticks * msPerTick, event.calls );
+		} else {
+			snprintf( line, sizeof(line), "%s  %.2f ms", event.name, event.ticks * msPerTick );
+		}
+		BitType->Render( x + 12 * ( event.depth + 1 ), y, line );
+	}
+
+	inFrame = recording;
+}
+
+/**\brief Register the Profiler with the Lua console.
+ */
+void Profiler::RegisterProfiler( lua_State *L ) {
+	static const luaL_Reg profilerFunctions[] = {
+		{"overlay", &Profiler::lua_overlay},
+		{"trace", &Profiler::lua_trace},
+		{"stopTrace", &Profiler::lua_stopTrace},
+		{"startLuaCosts", &LuaCost::lua_start},
+		{"stopLuaCosts", &LuaCost::lua_stop},
+		{"luaCosts", &LuaCost::lua_report},
+		{NULL, NULL}
+	};
+
+	luaL_openlib(L, EPIAR_PROFILER, profilerFunctions, 0);
+
+	lua_pop(L,1);
+}
+
+/**\brief Toggle the overlay, or set it when given a boolean (Lua callable)
+ */
+int Profiler::lua_overlay( lua_State *L ) {
+	if( lua_gettop(L) >= 1 ) {
+		SetOverlay( lua_toboolean(L, 1) != 0 );
+	} else {
+		SetOverlay( !GetOverlay() );
+	}
+	lua_pushboolean(L, GetOverlay() );
+	return 1;
+}
+
+/**\brief Same as Profiler::StartTrace (Lua callable)
+ */
+int Profiler::lua_trace( lua_State *L ) {
+	if( lua_gettop(L) != 1 ) {
+		return luaL_error(L, "Got %d arguments expected 1 (filename)", lua_gettop(L) );
+	}
+	lua_pushboolean(L, StartTrace( luaL_checkstring(L, 1) ) );
+	return 1;
+}
+
+/**\brief Same as Profiler::StopTrace (Lua callable)
+ */
+int Profiler::lua_stopTrace( lua_State *L ) {
+	StopTrace();
+	return 0;
+}
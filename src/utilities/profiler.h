@@ -0,0 +1,86 @@
+/**\file			profiler.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Times the phases of each frame
+ * \details
+ */
+
+#ifndef __H_PROFILER__
+#define __H_PROFILER__
+
+#include "includes.h"
+#include "utilities/lua.h"
+
+#define EPIAR_PROFILER "Profiler"
+
+// Times the enclosing block as a child of whatever block encloses it.
+#define PROFILE_SCOPE_JOIN2(a,b) a##b
+#define PROFILE_SCOPE_JOIN(a,b) PROFILE_SCOPE_JOIN2(a,b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_SCOPE_JOIN(profileScope, __LINE__)( name )
+
+class Profiler {
+	public:
+		static void BeginFrame( void );
+		static void EndFrame( void );
+
+		static bool IsActive( void ) { return inFrame; }
+
+		static void Push( const char *name );
+		static void Pop( void );
+		static void Accumulate( const char *name, Uint64 ticks );
+		static void CountDraw( const void *texture );
+
+		static void SetOverlay( bool visible ) { overlay = visible; }
+		static bool GetOverlay( void ) { return overlay; }
+		static bool StartTrace( const string& filename );
+		static void StopTrace( void );
+
+		static void DrawOverlay( void );
+
+		static void RegisterProfiler( lua_State *L );
+
+		// Lua functions
+		static int lua_overlay( lua_State *L );
+		static int lua_trace( lua_State *L );
+		static int lua_stopTrace( lua_State *L );
+
+	private:
+		/// One timed block within a frame.
+		struct Event {
+			const char *name;
+			int depth;
+			int calls;   ///< More than one when the time was Accumulated.
+			Uint64 start;
+			Uint64 ticks;
+		};
+
+		static void WriteTrace( void );
+
+		static bool overlay;
+		static bool inFrame;
+		static FILE *trace;
+		static bool traceFirst;
+		static Uint64 traceStart;
+
+		static vector<Event> events;     ///< This frame, in the order that they started.
+		static vector<int> open;         ///< Indices of the events that have not been Popped.
+		static vector<Event> lastFrame;  ///< What the overlay shows.
+		static Uint64 frameStart;
+		static Uint64 lastFrameTicks;
+
+		static const void *lastTexture;
+		static int drawCalls;
+		static int textureSwitches;
+		static int lastDrawCalls;
+		static int lastTextureSwitches;
+};
+
+/// Push on construction, Pop on destruction.
+class ProfileScope {
+	public:
+		ProfileScope( const char *name ) { Profiler::Push( name ); }
+		~ProfileScope() { Profiler::Pop(); }
+};
+
+#endif // __H_PROFILER__
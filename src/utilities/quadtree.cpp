@@ -8,6 +8,7 @@
 
 #include "includes.h"
 #include "utilities/log.h"
+#include "utilities/jobsystem.h"
 #include "utilities/quadtree.h"
 #include "graphics/video.h"
 
@@ -44,39 +45,95 @@ const char* PositionNames[4] = { "UPPER_LEFT", "UPPER_RIGHT", "LOWER_LEFT", "LOW
  *
  */
 
+/**\class QuadObjects
+ * \brief The Sprites held by a QuadTree Leaf.
+ *
+ * A balanced Leaf never holds more than QUADMAXOBJECTS Sprites, so they are stored inline in the node.
+ * Leaves that are waiting to be ReBallanced, or that are too small to split, spill into an overflow vector.
+ * The overflow keeps its capacity when the node is recycled, so it stops allocating once the simulation warms up.
+ *
+ * \note The order of the Sprites is not preserved by RemoveAt.
+ */
+
+/** \brief Add a Sprite to the end of the list.
+ */
+
+void QuadObjects::PushBack(Sprite* obj){
+	if(count < QUADMAXOBJECTS){
+		inlined[count] = obj;
+	} else {
+		overflow.push_back(obj);
+	}
+	count++;
+}
+
+/** \brief Remove the n'th Sprite by moving the last Sprite into its place.
+ */
+
+void QuadObjects::RemoveAt(unsigned int n){
+	assert(n < count);
+	Sprite* last = (*this)[count-1];
+	if(n < QUADMAXOBJECTS){
+		inlined[n] = last;
+	} else {
+		overflow[n - QUADMAXOBJECTS] = last;
+	}
+	if(count > QUADMAXOBJECTS){
+		overflow.pop_back();
+	}
+	count--;
+}
+
+/** \brief Remove a Sprite.
+ * \returns TRUE if the Sprite was found.
+ */
+
+bool QuadObjects::Remove(Sprite* obj){
+	for(unsigned int n=0;n<count;n++){
+		if((*this)[n] == obj){
+			RemoveAt(n);
+			return( true );
+		}
+	}
+	return( false );
+}
+
 /** \brief Constructor
+ * Nodes are constructed in blocks by the QuadTreePool.
+ * They are not usable until they have been Reset.
+ * \see QuadTreePool::Acquire
+ */
+
+QuadTree::QuadTree(){
+	this->pool = NULL;
+	for(int t=0;t<4;t++){
+		subtrees[t] = NULL;
+	}
+	this->radius = 0;
+	this->objectcount = 0;
+	this->flags = 0;
+}
+
+/** \brief Prepare a recycled node to become an empty Leaf.
  * By default there are no instantiated subtrees.
  */
 
-QuadTree::QuadTree(Coordinate _center, float _radius){
+void QuadTree::Reset(QuadTreePool *_pool, Coordinate _center, float _radius){
 	// cout<<"New QT at "<<_center<<" has R="<<_radius<<endl;
 	assert(_radius>MIN_QUAD_SIZE/2);
 	for(int t=0;t<4;t++){
 		subtrees[t] = NULL;
 	}
-	this->objects = new list<Sprite*>();
+	this->objects.Clear();
+	this->pool = _pool;
 	this->radius = _radius;
 	this->center = _center;
 	this->objectcount = 0;
+	this->flags = 0;
 	this->isLeaf = true;
 	this->isDirty = false;
 }
 
-/** \brief Destructor
- */
-
-QuadTree::~QuadTree(){
-	this->objects->clear();
-	delete objects;
-	// Delete the Subtrees (Node)
-	for(int t=0;t<4;t++){
-		if(NULL != (subtrees[t])){
-			delete subtrees[t];
-			this->subtrees[t] = NULL;
-		}
-	}
-}
-
 /** \brief The number of Sprites within this QuadTree.
  *
  */
@@ -122,7 +179,7 @@ void QuadTree::Insert(Sprite *obj){
 	if(! isLeaf ){ // Node
 		InsertSubTree(obj);
 	} else { // Leaf
-		objects->push_back(obj);
+		objects.PushBack(obj);
 		// An over Full Leaf should become a Node
 		isDirty=true;
 	}
@@ -156,10 +213,8 @@ bool QuadTree::Delete(Sprite* obj){
 			return( false ); // Didn't find that object.
 		}
 	} else { // Leaf
-		list<Sprite *>::iterator i = std::find( objects->begin(), objects->end(), obj);
-		if(i != objects->end())
+		if( objects.Remove(obj) )
 		{
-			i = objects->erase( i );
 			// Note that leaves don't ReBallance on delete.
 			objectcount--;
 			return( true );
@@ -171,23 +226,20 @@ bool QuadTree::Delete(Sprite* obj){
 
 /** \brief Get all Sprites in this QuadTree
  *
- * \returns A list of Sprite pointers.
+ * \arg sprites [out] Every Sprite in this QuadTree is appended to this list.
  */
 
-list<Sprite *> *QuadTree::GetSprites() {
+void QuadTree::GetSprites(QuadObjects *sprites) {
 	if(!isLeaf){ // Node
-		list<Sprite*> *other;
-		list<Sprite*> *full = new list<Sprite*>();
 		for(int t=0;t<4;t++){
 			if(NULL != (subtrees[t])){
-				other = subtrees[t]->GetSprites();
-				full->splice(full->end(), *other );
-				delete other;
+				subtrees[t]->GetSprites(sprites);
 			}
 		}
-		return full;
 	} else { // Leaf
-		return new list<Sprite*>(*objects);
+		for(unsigned int n=0;n<objects.Size();n++){
+			sprites->PushBack(objects[n]);
+		}
 	}
 }
 
@@ -195,16 +247,16 @@ list<Sprite *> *QuadTree::GetSprites() {
  *
  * \arg point The center of the search radius.
  * \arg distance The maximum search radius.
- * \arg nearby [out] The list of all Sprites found within the search radius.
+ * \arg visitor Called for every Sprite found within the search radius.
  * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
  *
- * The nearby list is passed down the recursive call-stack rather than returned at by each call.
- * This limits the malloc calls.
+ * The visitor is passed down the recursive call-stack rather than returning a list from each call.
+ * This avoids the malloc calls.
  *
  * \returns nothing.
  */
 
-void QuadTree::GetSpritesNear(Coordinate point, float distance, list<Sprite*> *nearby, int type){
+void QuadTree::GetSpritesNear(Coordinate point, float distance, SpriteVisitor *visitor, int type){
 	// The Maximum range is when the center and point are on a 45 degree angle.
 	//   Root-2 of the radius + the distance
 	const float maxrange = V_SQRT2*radius + distance;
@@ -218,15 +270,15 @@ void QuadTree::GetSpritesNear(Coordinate point, float distance, list<Sprite*> *n
 	if(!isLeaf){ // Node
 		for(int t=0;t<4;t++){
 			if(NULL != (subtrees[t])){
-				subtrees[t]->GetSpritesNear(point,distance,nearby,type);
+				subtrees[t]->GetSpritesNear(point,distance,visitor,type);
 			}
 		}
 	} else { // Leaf
-		list<Sprite*>::iterator i;
-		for( i = objects->begin(); i != objects->end(); ++i ) {
-			if( ((*i)->GetDrawOrder() & type) == 0) continue;
-			if( (point - (*i)->GetWorldPosition()).GetMagnitudeSquared() < distance*distance + (*i)->GetRadarSize()*(*i)->GetRadarSize() ) {
-				nearby->push_back( *i);
+		for(unsigned int n=0;n<objects.Size();n++){
+			Sprite* obj = objects[n];
+			if( (obj->GetDrawOrder() & type) == 0) continue;
+			if( (point - obj->GetWorldPosition()).GetMagnitudeSquared() < distance*distance + obj->GetRadarSize()*obj->GetRadarSize() ) {
+				visitor->Visit( obj );
 			}
 		}
 	}
@@ -241,11 +293,12 @@ void QuadTree::GetSpritesNear(Coordinate point, float distance, list<Sprite*> *n
  *      	     Sprites outside of this radius are ignored.
  *               Each recurse of this function will use the smallest new radius.
  * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
+ * \arg filter If given, only Sprites that it accepts are considered.
  *
  * \returns A pointer to the Sprite nearest the obj Sprite, within a certain distance, and of the correct type.
  */
 
-Sprite* QuadTree::GetNearestSprite(Sprite* obj, float distance, int type){
+Sprite* QuadTree::GetNearestSprite(Sprite* obj, float distance, int type, SpriteFilter *filter){
 	// The Maximum range is when the center and point are on a 45 degree angle.
 	//   Root-2 of the radius + the distance
 	const float maxrange = V_SQRT2*radius + distance;
@@ -265,7 +318,7 @@ Sprite* QuadTree::GetNearestSprite(Sprite* obj, float distance, int type){
 		mindist=distance;
 		for(int t=0;t<4;t++){
 			if(NULL != (subtrees[t])){
-				possible = subtrees[t]->GetNearestSprite(obj,distance,type);
+				possible = subtrees[t]->GetNearestSprite(obj,distance,type,filter);
 				if(possible==NULL) continue; // This tree short circuited
 				tmpdist = (point-possible->GetWorldPosition()).GetMagnitude();
 				if( tmpdist < mindist ){
@@ -277,14 +330,14 @@ Sprite* QuadTree::GetNearestSprite(Sprite* obj, float distance, int type){
 	} else { // Leaf
 		// Leaves work in square space
 		mindist=distance*distance;
-		list<Sprite*>::iterator i;
-		for( i = objects->begin(); i != objects->end(); ++i ) {
-			if(((*i) == obj) || (((*i)->GetDrawOrder() & type) == 0))
+		for(unsigned int n=0;n<objects.Size();n++){
+			Sprite* other = objects[n];
+			if((other == obj) || ((other->GetDrawOrder() & type) == 0))
 				continue;
-			tmpdist = (point - (*i)->GetWorldPosition()).GetMagnitudeSquared();
-			if( tmpdist < mindist ) {
+			tmpdist = (point - other->GetWorldPosition()).GetMagnitudeSquared();
+			if( tmpdist < mindist && ( filter == NULL || filter->Accept( other ) ) ) {
 				mindist = tmpdist;
-				closest = (*i);
+				closest = other;
 			}
 		}
 	}
@@ -297,58 +350,51 @@ Sprite* QuadTree::GetNearestSprite(Sprite* obj, float distance, int type){
  * Any Sprites that can be re-inserted into this QuadTree will be re-inserted.
  * Sprites that are outside of this this QuadTree are removed and forgotten.
  *
- * \returns List of all Sprites outside of this QuadTree.
+ * \arg outofbounds [out] All Sprites outside of this QuadTree are appended to this list.
+ *                  The caller should reuse this list so that its capacity is not reallocated every tick.
  */
 
-list<Sprite*> *QuadTree::FixOutOfBounds() {
-	list<Sprite*>::iterator i;
-	list<Sprite*> *other;
-	list<Sprite*> *stillinside = new list<Sprite*>();
-	list<Sprite*> *outofbounds = new list<Sprite*>();
+void QuadTree::FixOutOfBounds(vector<Sprite*> *outofbounds) {
+	const size_t start = outofbounds->size();
 	if(!isLeaf){ // Node
 		// Collect out of bound sprites from sub-trees
 		for(int t=0;t<4;t++){
 			if(NULL != (subtrees[t])){
-				other = subtrees[t]->FixOutOfBounds();
-				outofbounds->splice(outofbounds->end(),*other);
-				delete other;
+				subtrees[t]->FixOutOfBounds(outofbounds);
 			}
 		}
-		objectcount-= outofbounds->size();
-		if(outofbounds->size()) isDirty=true;
+		objectcount-= outofbounds->size() - start;
 		// Insert any sprites that are inside of this Tree
-		for( i = outofbounds->begin(); i != outofbounds->end(); ++i ) {
-			if( this->Contains((*i)->GetWorldPosition()) ) {
-				stillinside->push_back(*i);
+		size_t kept = start;
+		for(size_t n=start;n<outofbounds->size();n++){
+			Sprite* obj = (*outofbounds)[n];
+			if( this->Contains(obj->GetWorldPosition()) ) {
+				this->Insert(obj);
+			} else {
+				(*outofbounds)[kept++] = obj;
 			}
 		}
-		for( i = stillinside->begin(); i != stillinside->end(); ++i ) {
-			this->Insert(*i);
-			outofbounds->remove(*i);
-		}
+		if(outofbounds->size() > start) isDirty=true;
+		outofbounds->resize(kept);
 	} else { // Leaf
 		// Collect and forget any out of bound sprites from object list
-		for( i = objects->begin(); i != objects->end(); ++i ) {
-			if(! this->Contains((*i)->GetWorldPosition()) ) {
-				outofbounds->push_back( *i );
+		for(unsigned int n=0;n<objects.Size();){
+			if(! this->Contains(objects[n]->GetWorldPosition()) ) {
+				outofbounds->push_back( objects[n] );
+				objects.RemoveAt(n);
+			} else {
+				n++;
 			}
 		}
-		for( i = outofbounds->begin(); i != outofbounds->end(); ++i ) {
-			objects->remove(*i);
-		}
-		objectcount-= outofbounds->size();
+		objectcount-= outofbounds->size() - start;
 	}
-	delete stillinside;
-	if(outofbounds->size()) isDirty=true;
-	// Return any sprites that couldn't be re-inserted
-	return outofbounds;
+	if(outofbounds->size() > start) isDirty=true;
 }
 
 /** \brief Update all Sprites in this QuadTree
  */
 
 void QuadTree::Update( lua_State *L ) {
-	list<Sprite*>::iterator i;
 	// Update all internal sprites
 	if(!isLeaf){ // Node
 		for(int t=0;t<4;t++){
@@ -357,8 +403,8 @@ void QuadTree::Update( lua_State *L ) {
 			}
 		}
 	} else { // Leaf
-		for( i = objects->begin(); i != objects->end(); ++i ) {
-			(*i)->Update( L );
+		for(unsigned int n=0;n<objects.Size();n++){
+			objects[n]->Update( L );
 		}
 	}
 }
@@ -387,14 +433,14 @@ void QuadTree::Draw(Coordinate root){
 			if(NULL != (subtrees[t])) subtrees[t]->Draw(root);
 		}
 	} else { // Leaf
-		list<Sprite *>::iterator i;
-		for( i = objects->begin(); i != objects->end(); ++i ) {
-			Coordinate pos = (*i)->GetWorldPosition() - root;
+		for(unsigned int n=0;n<objects.Size();n++){
+			Sprite* obj = objects[n];
+			Coordinate pos = obj->GetWorldPosition() - root;
 			int posx = static_cast<int>((scale* (float)pos.GetX() / QUADRANTSIZE) + (float)Video::GetHalfWidth());
 			int posy = static_cast<int>((scale* (float)pos.GetY() / QUADRANTSIZE) + (float)Video::GetHalfHeight());
-			Color col = (*i)->GetRadarColor();
+			Color col = obj->GetRadarColor();
 			// The 17 is here because it looks nice.  I can't explain why.
-			Video::DrawCircle( posx, posy, static_cast<int>(17.f*(*i)->GetRadarSize()/scale),2, col.r,col.g,col.b );
+			Video::DrawCircle( posx, posy, static_cast<int>(17.f*obj->GetRadarSize()/scale),2, col.r,col.g,col.b );
 		}
 	}
 }
@@ -429,7 +475,7 @@ void QuadTree::CreateSubTree(QuadPosition pos){
 		default: assert(0);
 	}
 	assert(subtrees[pos]==NULL);
-	subtrees[pos] = new QuadTree(center+offset,half);
+	subtrees[pos] = pool->Acquire(center+offset,half);
 	assert(subtrees[pos]!=NULL);
 }
 
@@ -458,31 +504,26 @@ void QuadTree::InsertSubTree(Sprite *obj){
 
 void QuadTree::ReBallance(){
 	unsigned int numObjects = this->Count();
-	list<Sprite*>::iterator i;
 
 	if( isDirty && isLeaf && numObjects>QUADMAXOBJECTS && radius>MIN_QUAD_SIZE){
 		//cout << "LEAF at "<<center<<" is becoming a NODE.\n";
 		isLeaf = false;
 
-		assert(0 != objects->size()); // The Leaf list should not be empty
+		assert(0 != objects.Size()); // The Leaf list should not be empty
 
-		for( i = objects->begin(); i != objects->end(); ++i ) {
-			InsertSubTree(*i);
+		for(unsigned int n=0;n<objects.Size();n++){
+			InsertSubTree(objects[n]);
 		}
 		assert(!isLeaf); // Still a Node
-		this->objects->clear();
+		this->objects.Clear();
 	} else if(isDirty && !isLeaf && numObjects<=QUADMAXOBJECTS ){
-		assert(0 == objects->size()); // The Leaf list should be empty
+		assert(0 == objects.Size()); // The Leaf list should be empty
 		//cout << "NODE at "<<center<<" is becoming a LEAF.\n";
 		isLeaf = true;
 		for(int t=0;t<4;t++){
 			if(NULL != (subtrees[t])){
-				list<Sprite*> *other = subtrees[t]->GetSprites();
-				for( i = other->begin(); i != other->end(); ++i ) {
-					objects->push_back( *i );
-				}
-				delete other;
-				delete subtrees[t];
+				subtrees[t]->GetSprites( &objects );
+				pool->Release( subtrees[t] );
 				subtrees[t] = NULL;
 			}
 		}
@@ -492,7 +533,7 @@ void QuadTree::ReBallance(){
 	for(int t=0;t<4;t++){
 		if(NULL != (subtrees[t])){
 			if(subtrees[t]->Count()==0){
-				delete subtrees[t];
+				pool->Release( subtrees[t] );
 				subtrees[t] = NULL;
 			} else {
 				subtrees[t]->ReBallance();
@@ -513,7 +554,6 @@ void QuadTree::ReBallance(){
 xmlNodePtr QuadTree::ToNode() {
 	xmlNodePtr thisNode, objNode;
 	char buff[256];
-	list<Sprite*>::iterator i;
 
 	thisNode = xmlNewNode(NULL, BAD_CAST "QuadTree" );
 
@@ -531,8 +571,9 @@ xmlNodePtr QuadTree::ToNode() {
 			}
 		}
 	} else { // Leaf
-		for( i = objects->begin(); i != objects->end(); ++i ) {
-			switch((*i)->GetDrawOrder()) {
+		for(unsigned int n=0;n<objects.Size();n++){
+			Sprite* obj = objects[n];
+			switch(obj->GetDrawOrder()) {
 				case DRAW_ORDER_PLANET:
 					snprintf(buff, sizeof(buff), "%s", "Planet" );
 					break;
@@ -549,16 +590,16 @@ xmlNodePtr QuadTree::ToNode() {
 					snprintf(buff, sizeof(buff), "%s", "Effect" );
 					break;
 				default:
-					LogMsg(ERR,"Unknown Sprite Type: %d",(*i)->GetDrawOrder());
+					LogMsg(ERR,"Unknown Sprite Type: %d",obj->GetDrawOrder());
 					assert(0);
 					break;
 			}
 			objNode = xmlNewNode(NULL, BAD_CAST buff);
-			snprintf(buff, sizeof(buff), "%d", (int) (*i)->GetWorldPosition().GetX() );
+			snprintf(buff, sizeof(buff), "%d", (int) obj->GetWorldPosition().GetX() );
 			xmlSetProp( objNode, BAD_CAST "x", BAD_CAST buff );
-			snprintf(buff, sizeof(buff), "%d", (int) (*i)->GetWorldPosition().GetY() );
+			snprintf(buff, sizeof(buff), "%d", (int) obj->GetWorldPosition().GetY() );
 			xmlSetProp( objNode, BAD_CAST "y", BAD_CAST buff );
-			snprintf(buff, sizeof(buff), "%d", (int) (*i)->GetAngle() );
+			snprintf(buff, sizeof(buff), "%d", (int) obj->GetAngle() );
 			xmlSetProp( objNode, BAD_CAST "angle", BAD_CAST buff );
 			xmlAddChild(thisNode, objNode);
 		}
@@ -566,3 +607,388 @@ xmlNodePtr QuadTree::ToNode() {
 
 	return thisNode;
 }
+
+/**\class QuadTreePool
+ * \brief Recycles QuadTree nodes.
+ *
+ * Sprites constantly cross QuadTree boundaries, so nodes are split and merged every tick.
+ * Rather than asking the heap for every node, the nodes are allocated in blocks of QUADPOOL_BLOCKSIZE and then reused.
+ * Once the pool has grown to fit the universe, splitting and merging never touch the heap.
+ *
+ * The pool counts how many nodes were handed out and how many heap allocations it made since the last ResetCounters.
+ * The second number should stay at zero while the simulation is running.
+ */
+
+/**\brief Constructs an empty pool.
+ */
+QuadTreePool::QuadTreePool() {
+	capacity = 0;
+	acquired = 0;
+	allocations = 0;
+	lock = 0;
+}
+
+/**\brief Frees every block.
+ * \note Every node is freed, including nodes that are still in use.
+ */
+QuadTreePool::~QuadTreePool() {
+	vector<QuadTree*>::iterator iter;
+	for ( iter = blocks.begin(); iter != blocks.end(); ++iter ) {
+		delete [] (*iter);
+	}
+	blocks.clear();
+	freeNodes.clear();
+}
+
+/**\brief Get an empty Leaf.
+ * \details The pool grows when there are no free nodes.
+ */
+QuadTree* QuadTreePool::Acquire( Coordinate center, float radius ) {
+	SDL_AtomicLock( &lock );
+	if( freeNodes.empty() ) {
+		Grow();
+	}
+	QuadTree* node = freeNodes.back();
+	freeNodes.pop_back();
+	acquired++;
+	SDL_AtomicUnlock( &lock );
+	node->Reset( this, center, radius );
+	return node;
+}
+
+/**\brief Return a node and all of its subtrees to the pool.
+ * \note The Sprites in the node are forgotten, not deleted.
+ */
+void QuadTreePool::Release( QuadTree* node ) {
+	SDL_AtomicLock( &lock );
+	ReleaseNode( node );
+	SDL_AtomicUnlock( &lock );
+}
+
+/**\brief Release a node and its subtrees while the lock is held.
+ */
+void QuadTreePool::ReleaseNode( QuadTree* node ) {
+	for(int t=0;t<4;t++){
+		if(NULL != (node->subtrees[t])){
+			ReleaseNode( node->subtrees[t] );
+			node->subtrees[t] = NULL;
+		}
+	}
+	node->objects.Clear();
+	node->objectcount = 0;
+	freeNodes.push_back( node ); // Never reallocates, see Grow
+}
+
+/**\brief Add another block of nodes.
+ */
+void QuadTreePool::Grow() {
+	QuadTree* block = new QuadTree[QUADPOOL_BLOCKSIZE];
+	blocks.push_back( block );
+	capacity += QUADPOOL_BLOCKSIZE;
+	// Reserve room for every node so that Release never has to allocate.
+	freeNodes.reserve( capacity );
+	for(int n=QUADPOOL_BLOCKSIZE-1; n>=0; n--) {
+		// Leaves fill their overflow between ReBallances.  The capacity is
+		// kept when the node is Released, so this is the only time it is made.
+		block[n].objects.Reserve( QUADOVERFLOW_RESERVE );
+		freeNodes.push_back( &block[n] );
+	}
+	allocations++;
+}
+
+/**\class QuadTreeIndex
+ * \brief SpatialIndex backend made of a grid of QuadTrees.
+ * \details
+ * The entire universe is broken up into a grid of QUADRANTSIZE QuadTrees.
+ * Only grid positions with Sprites in them are actually populated by QuadTrees.
+ * Each QuadTree is only a finite size, but can theoretically hold an infinte
+ * number of sprites.
+ *
+ * Every QuadTree node comes from the index's QuadTreePool.
+ *
+ * \see QuadTree
+ * \see SpatialIndex
+ */
+
+/**\brief Constructs an empty QuadTree grid.
+ */
+QuadTreeIndex::QuadTreeIndex() {
+}
+
+/**\brief Deletes every Quadrant.
+ * \note The Sprites themselves are owned by the SpriteManager.
+ */
+QuadTreeIndex::~QuadTreeIndex() {
+	QuadrantTable::iterator iter;
+	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
+		pool.Release( iter->second );
+	}
+	trees.clear();
+}
+
+/**\brief Add a Sprite to the Quadrant that contains it.
+ */
+void QuadTreeIndex::Insert( Sprite *sprite ) {
+	GetQuadrant( sprite->GetWorldPosition() )->Insert( sprite );
+}
+
+/**\brief Remove a Sprite from the Quadrant that contains it.
+ * \returns True if the Sprite was found.
+ */
+bool QuadTreeIndex::Remove( Sprite *sprite ) {
+	return GetQuadrant( sprite->GetWorldPosition() )->Delete( sprite );
+}
+
+// Collects the Sprites that have left each Quadrant.
+class FixOutOfBoundsJob : public Job {
+	public:
+		FixOutOfBoundsJob( vector<QuadTree*> *_quadrants, vector< vector<Sprite*> > *_outOfBounds ) :
+			quadrants(_quadrants), outOfBounds(_outOfBounds) {}
+		void Run( int begin, int end ) {
+			for( int q = begin; q < end; q++ ) {
+				(*outOfBounds)[q].clear();
+				(*quadrants)[q]->FixOutOfBounds( &(*outOfBounds)[q] );
+			}
+		}
+	private:
+		vector<QuadTree*> *quadrants;
+		vector< vector<Sprite*> > *outOfBounds;
+};
+
+// ReBallances each Quadrant.
+class ReBallanceJob : public Job {
+	public:
+		ReBallanceJob( vector<QuadTree*> *_quadrants ) : quadrants(_quadrants) {}
+		void Run( int begin, int end ) {
+			for( int q = begin; q < end; q++ ) {
+				(*quadrants)[q]->ReBallance();
+			}
+		}
+	private:
+		vector<QuadTree*> *quadrants;
+};
+
+/**\brief Move Sprites to adjacent Quadrants as they cross boundaries.
+ * \details Afterwards every Quadrant is ReBallanced and empty Quadrants are deleted.
+ *
+ * Each Quadrant is independent while Sprites are collected and while it is
+ * ReBallanced, so those steps are split across the JobSystem.  Sprites that
+ * crossed into another Quadrant are moved in between, on this thread and in
+ * Quadrant order, so the result does not depend on the number of threads.
+ */
+void QuadTreeIndex::Reindex( JobSystem *jobs ) {
+	QuadrantTable::iterator iter;
+
+	// Find any Sprites that have moved out of bounds.
+	quadrants.clear();
+	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
+		quadrants.push_back( iter->second );
+	}
+	if( outOfBounds.size() < quadrants.size() ) {
+		outOfBounds.resize( quadrants.size() );
+	}
+	FixOutOfBoundsJob fix( &quadrants, &outOfBounds );
+	if( jobs ) {
+		jobs->ParallelFor( quadrants.size(), 1, &fix );
+	} else {
+		fix.Run( 0, quadrants.size() );
+	}
+
+	// Move sprites to adjacent Quadrants as they cross boundaries
+	const size_t numQuadrants = quadrants.size();
+	for( size_t q = 0; q < numQuadrants; q++ ) {
+		vector<Sprite *>::iterator i;
+		for( i = outOfBounds[q].begin(); i != outOfBounds[q].end(); ++i ) {
+			GetQuadrant( (*i)->GetWorldPosition() )->Insert( *i );
+		}
+	}
+
+	// New Quadrants may have been created.
+	quadrants.clear();
+	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
+		quadrants.push_back( iter->second );
+	}
+	ReBallanceJob reballance( &quadrants );
+	if( jobs ) {
+		jobs->ParallelFor( quadrants.size(), 1, &reballance );
+	} else {
+		reballance.Run( 0, quadrants.size() );
+	}
+
+	DeleteEmptyQuadrants();
+}
+
+/**\brief Collect the Sprites within a radius of a point.
+ * \see QuadTree::GetSpritesNear
+ */
+void QuadTreeIndex::GetSpritesNear( Coordinate point, float distance, SpriteVisitor *visitor, int type ) {
+	QuadrantTable::iterator iter;
+	int x0, y0, x1, y1;
+
+	if( QuadrantRange( point, distance, &x0, &y0, &x1, &y1 ) ) {
+		for( int x = x0; x <= x1; x++ ) {
+			for( int y = y0; y <= y1; y++ ) {
+				iter = trees.find( Coordinate( x * QUADRANTSIZE * 2.0f, y * QUADRANTSIZE * 2.0f ) );
+				if( iter != trees.end() && iter->second->PossiblyNear( point, distance ) ) {
+					iter->second->GetSpritesNear( point, distance, visitor, type );
+				}
+			}
+		}
+	} else {
+		for( iter = trees.begin(); iter != trees.end(); ++iter ) {
+			if( iter->second->PossiblyNear( point, distance ) ) {
+				iter->second->GetSpritesNear( point, distance, visitor, type );
+			}
+		}
+	}
+}
+
+/**\brief Get the Sprite nearest to another Sprite.
+ * \see QuadTree::GetNearestSprite
+ */
+Sprite* QuadTreeIndex::GetNearestSprite( Sprite *obj, float distance, int type, SpriteFilter *filter ) {
+	QuadrantTable::iterator iter;
+	Coordinate point = obj->GetWorldPosition();
+	Sprite* closest = NULL;
+	int x0, y0, x1, y1;
+
+	if( QuadrantRange( point, distance, &x0, &y0, &x1, &y1 ) ) {
+		for( int x = x0; x <= x1; x++ ) {
+			for( int y = y0; y <= y1; y++ ) {
+				iter = trees.find( Coordinate( x * QUADRANTSIZE * 2.0f, y * QUADRANTSIZE * 2.0f ) );
+				if( iter != trees.end() ) {
+					NearestInQuadrant( iter->second, obj, &distance, type, filter, &closest );
+				}
+			}
+		}
+	} else {
+		for( iter = trees.begin(); iter != trees.end(); ++iter ) {
+			NearestInQuadrant( iter->second, obj, &distance, type, filter, &closest );
+		}
+	}
+	return closest;
+}
+
+/**\brief Check one Quadrant for a Sprite that is closer than the closest one so far.
+ * \details The search distance shrinks to the distance of the closest Sprite.
+ */
+void QuadTreeIndex::NearestInQuadrant( QuadTree *tree, Sprite *obj, float *distance, int type, SpriteFilter *filter, Sprite **closest ) {
+	if( !tree->PossiblyNear( obj->GetWorldPosition(), *distance ) ) {
+		return;
+	}
+	Sprite* possible = tree->GetNearestSprite( obj, *distance, type, filter );
+	if( possible != NULL ) {
+		float tmpdist = (obj->GetWorldPosition()-possible->GetWorldPosition()).GetMagnitude();
+		if( tmpdist < *distance ) {
+			*distance = tmpdist;
+			*closest = possible;
+		}
+	}
+}
+
+/**\brief The number of Sprites in every Quadrant.
+ */
+unsigned int QuadTreeIndex::Count( void ) {
+	unsigned int total = 0;
+	QuadrantTable::iterator iter;
+
+	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
+		total += iter->second->Count();
+	}
+	return total;
+}
+
+/**\brief Draw the Quadrant around the focus.
+ * \details Useful for debugging.
+ */
+void QuadTreeIndex::Draw( Coordinate focus ) {
+	GetQuadrant( focus )->Draw( GetQuadrantCenter( focus ) );
+}
+
+/**\brief Add an XML Node for every Quadrant to root.
+ */
+void QuadTreeIndex::Save( xmlNodePtr root ) {
+	QuadrantTable::iterator iter;
+	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
+		xmlAddChild( root, iter->second->ToNode() );
+	}
+}
+
+/**\brief Returns QuadTree center.
+ * \param point Coordinate
+ * \return Coordinate of centerpointer
+ */
+Coordinate QuadTreeIndex::GetQuadrantCenter( Coordinate point ) {
+	// Figure out where the new Tree should go.
+	// Quadrants are tiled adjacent to the central Quadrant centered at (0,0).
+	double cx, cy;
+	cx = float(floor( (point.GetX()+QUADRANTSIZE)/(QUADRANTSIZE*2.0f)) * QUADRANTSIZE*2.f);
+	cy = float(floor( (point.GetY()+QUADRANTSIZE)/(QUADRANTSIZE*2.0f)) * QUADRANTSIZE*2.f);
+	return Coordinate(cx,cy);
+}
+
+/**\brief Returns QuadTree at Coordinate
+ * \details The QuadTree is created if it does not exist yet.
+ * \param point Coordinate
+ */
+QuadTree* QuadTreeIndex::GetQuadrant( Coordinate point ) {
+	Coordinate treeCenter = GetQuadrantCenter(point);
+
+	// Check in the known Quadrant
+	QuadrantTable::iterator iter;
+	iter = trees.find( treeCenter );
+	if( iter != trees.end() ) {
+		return iter->second;
+	}
+
+	// Create the new Tree and attach it to the universe
+	QuadTree *newTree = pool.Acquire(treeCenter, QUADRANTSIZE);
+	assert(treeCenter == newTree->GetCenter() );
+	assert(newTree->Contains(point));
+	trees.insert(make_pair(treeCenter, newTree));
+
+	return newTree;
+}
+
+/**\brief Find the range of Quadrants that a search may need to visit.
+ * \details Quadrant (x,y) is centered at (x,y) * 2 * QUADRANTSIZE.
+ * \param c Coordinate
+ * \param r Radius
+ * \returns False if the range covers more Quadrants than exist, in which
+ *          case it is cheaper to check every Quadrant.
+ */
+bool QuadTreeIndex::QuadrantRange( Coordinate c, float r, int *x0, int *y0, int *x1, int *y1 ) {
+	const double size = QUADRANTSIZE * 2.0;
+	double left   = floor( (c.GetX() - r + QUADRANTSIZE) / size );
+	double right  = floor( (c.GetX() + r + QUADRANTSIZE) / size );
+	double bottom = floor( (c.GetY() - r + QUADRANTSIZE) / size );
+	double top    = floor( (c.GetY() + r + QUADRANTSIZE) / size );
+
+	// Also protects the int conversions below from huge search radii
+	if( (right - left + 1) * (top - bottom + 1) > trees.size() ) {
+		return false;
+	}
+
+	*x0 = static_cast<int>( left );
+	*x1 = static_cast<int>( right );
+	*y0 = static_cast<int>( bottom );
+	*y1 = static_cast<int>( top );
+	return true;
+}
+
+/**\brief Deletes empty QuadTrees
+ */
+void QuadTreeIndex::DeleteEmptyQuadrants( void ) {
+	QuadrantTable::iterator iter;
+	// Delete QuadTrees that are empty
+	// TODO: Delete QuadTrees that are far away from
+	iter = trees.begin();
+	while( iter != trees.end() ) {
+		if ( iter->second->Count() == 0 ) {
+			pool.Release( iter->second );
+			trees.erase( iter++ );
+		} else {
+			++iter;
+		}
+	}
+}
@@ -13,18 +13,48 @@
 #include "includes.h"
 #include "common.h"
 #include "sprites/sprite.h"
+#include "utilities/spatialindex.h"
 
 #define MIN_QUAD_SIZE 10.0f
 #define QUADRANTSIZE 4096.0f
 #define QUADMAXOBJECTS 3
+#define QUADPOOL_BLOCKSIZE 256
+#define QUADOVERFLOW_RESERVE 8 // Room that every pooled Leaf has for Sprites beyond QUADMAXOBJECTS.
+
+class QuadTreePool;
 
 enum QuadPosition{ UPPER_LEFT, UPPER_RIGHT,
                    LOWER_LEFT, LOWER_RIGHT };
 
+// The Sprites held by a QuadTree Leaf.
+// The first QUADMAXOBJECTS are stored inline.  Only Leaves that are waiting
+// to be ReBallanced or that are too small to split will use the overflow.
+class QuadObjects {
+	public:
+		QuadObjects() : count(0) {}
+
+		unsigned int Size() const { return count; }
+		Sprite* operator[](unsigned int n) const {
+			return (n < QUADMAXOBJECTS) ? inlined[n] : overflow[n - QUADMAXOBJECTS];
+		}
+
+		void PushBack(Sprite* obj);
+		void RemoveAt(unsigned int n);
+		bool Remove(Sprite* obj);
+		void Clear() { count = 0; overflow.clear(); }
+		void Reserve(unsigned int n) { overflow.reserve(n); }
+
+	private:
+		Sprite* inlined[QUADMAXOBJECTS];
+		vector<Sprite*> overflow; ///< Keeps its capacity when cleared.
+		unsigned int count;
+};
+
 class QuadTree {
 	public:
-		QuadTree(Coordinate center, float radius);
-		~QuadTree();
+		QuadTree();
+
+		void Reset(QuadTreePool *pool, Coordinate center, float radius);
 
 		unsigned int Count();
 		const Coordinate GetCenter() {return center;}
@@ -35,10 +65,10 @@ class QuadTree {
 		void Insert(Sprite* obj);
 		bool Delete(Sprite* obj);
 
-		list<Sprite*> *GetSprites();
-		void GetSpritesNear(Coordinate point, float distance, list<Sprite*> *returnList, int type = DRAW_ORDER_ALL);
-		Sprite* GetNearestSprite(Sprite* obj, float distance, int type = DRAW_ORDER_ALL);
-		list<Sprite*> *FixOutOfBounds();
+		void GetSprites(QuadObjects *sprites);
+		void GetSpritesNear(Coordinate point, float distance, SpriteVisitor *visitor, int type = DRAW_ORDER_ALL);
+		Sprite* GetNearestSprite(Sprite* obj, float distance, int type = DRAW_ORDER_ALL, SpriteFilter *filter = NULL);
+		void FixOutOfBounds(vector<Sprite*> *outofbounds);
 
 		void Update( lua_State *L );
 		void Draw(Coordinate root);
@@ -47,12 +77,15 @@ class QuadTree {
 		xmlNodePtr ToNode();
 
 	private:
+		friend class QuadTreePool;
+
 		QuadPosition SubTreeThatContains(Coordinate point);
 		void CreateSubTree(QuadPosition pos);
 		void InsertSubTree(Sprite* obj);
 
+		QuadTreePool *pool;
 		QuadTree* subtrees[4];
-		list<Sprite*> *objects;
+		QuadObjects objects;
 		Coordinate center;
 		float radius;
 		unsigned int objectcount;
@@ -77,4 +110,113 @@ inline bool QuadTree::PossiblyNear(Coordinate point, float distance) {
 	return( (point-center).GetMagnitudeSquared() <= maxrange*maxrange );
 }
 
+// Recycles QuadTree nodes so that splitting and merging avoid the heap.
+class QuadTreePool {
+	public:
+		QuadTreePool();
+		~QuadTreePool();
+
+		QuadTree* Acquire(Coordinate center, float radius);
+		void Release(QuadTree* node);
+
+		unsigned int GetNumNodes() { return capacity - freeNodes.size(); }
+		unsigned int GetCapacity() { return capacity; }
+
+		Uint32 GetAcquired() { return acquired; }
+		Uint32 GetAllocations() { return allocations; }
+		void ResetCounters() { acquired = 0; allocations = 0; }
+
+	private:
+		void Grow();
+		void ReleaseNode(QuadTree* node);
+
+		vector<QuadTree*> blocks;    ///< Every block of QUADPOOL_BLOCKSIZE nodes.
+		vector<QuadTree*> freeNodes; ///< Nodes that are ready to be reused.
+		unsigned int capacity;       ///< Total number of nodes in all blocks.
+		Uint32 acquired;             ///< Nodes handed out since the last ResetCounters.
+		Uint32 allocations;          ///< Heap allocations since the last ResetCounters.
+		SDL_SpinLock lock;           ///< Quadrants share the pool while they are ReBallanced in parallel.
+};
+
+// Keeps the nodes of a map for reuse, so that Quadrants can be created and
+// deleted as Sprites move around without the heap.
+// The free nodes are shared by every map of the same type, so the maps must
+// only be changed on the main thread.
+template<class T> class QuadrantAllocator {
+	public:
+		typedef T value_type;
+
+		QuadrantAllocator() {}
+		template<class U> QuadrantAllocator( const QuadrantAllocator<U>& ) {}
+
+		T* allocate( size_t n ) {
+			vector<T*> &nodes = FreeNodes();
+			if( n == 1 && !nodes.empty() ) {
+				T* node = nodes.back();
+				nodes.pop_back();
+				return node;
+			}
+			return static_cast<T*>( ::operator new( n * sizeof(T) ) );
+		}
+		void deallocate( T* p, size_t n ) {
+			if( n == 1 ) {
+				FreeNodes().push_back( p );
+			} else {
+				::operator delete( p );
+			}
+		}
+
+		template<class U> bool operator==( const QuadrantAllocator<U>& ) const { return true; }
+		template<class U> bool operator!=( const QuadrantAllocator<U>& ) const { return false; }
+
+	private:
+		// Never deleted, so that maps destroyed during exit can still free nodes.
+		static vector<T*>& FreeNodes() {
+			static vector<T*> *nodes = new vector<T*>();
+			return *nodes;
+		}
+};
+
+typedef map< Coordinate, QuadTree*, less<Coordinate>, QuadrantAllocator< pair<const Coordinate, QuadTree*> > > QuadrantTable;
+
+class QuadTreeIndex : public SpatialIndex {
+	public:
+		QuadTreeIndex();
+		~QuadTreeIndex();
+
+		string GetName( void ) { return SPATIAL_INDEX_QUADTREE; }
+
+		void Insert( Sprite *sprite );
+		bool Remove( Sprite *sprite );
+		void Reindex( JobSystem *jobs = NULL );
+
+		void GetSpritesNear( Coordinate point, float distance, SpriteVisitor *visitor, int type = DRAW_ORDER_ALL );
+		Sprite* GetNearestSprite( Sprite *obj, float distance, int type = DRAW_ORDER_ALL, SpriteFilter *filter = NULL );
+
+		unsigned int Count( void );
+		int GetNumRegions( void ) { return trees.size(); }
+
+		void Draw( Coordinate focus );
+		void Save( xmlNodePtr root );
+
+		Uint32 GetNodesAcquired( void ) { return pool.GetAcquired(); }
+		Uint32 GetNodeAllocations( void ) { return pool.GetAllocations(); }
+		void ResetNodeCounters( void ) { pool.ResetCounters(); }
+		Uint32 GetNumNodes( void ) { return pool.GetNumNodes(); }
+		Uint64 GetNodeBytes( void ) { return static_cast<Uint64>( pool.GetCapacity() ) * sizeof(QuadTree); }
+
+		static Coordinate GetQuadrantCenter( Coordinate point );
+
+	private:
+		QuadrantTable trees;             ///< The populated Quadrants, keyed by their center.
+		QuadTreePool pool;               ///< Every QuadTree node in every Quadrant.
+		vector<QuadTree*> quadrants;     ///< Scratch space used by Reindex: the Quadrants, in order.
+		vector< vector<Sprite*> > outOfBounds; ///< Scratch space used by Reindex: the Sprites that left each Quadrant.
+
+		QuadTree* GetQuadrant( Coordinate point );
+		bool QuadrantRange( Coordinate c, float r, int *x0, int *y0, int *x1, int *y1 );
+		void NearestInQuadrant( QuadTree *tree, Sprite *obj, float *distance, int type, SpriteFilter *filter, Sprite **closest );
+		void DeleteEmptyQuadrants( void );
+};
+
 #endif // __h_quadtree__
@@ -7,6 +7,7 @@
  */
 
 #include "includes.h"
+#include "utilities/log.h"
 #include "utilities/resource.h"
 
 /** \class Resource
@@ -37,7 +38,10 @@
  *  Resource subclasses attempt to use the same key for different objects then
  *  errors will occur.
  *
- *  \see Image, Ani, Sound
+ *  Each subclass reports what kind of Resource it is and roughly how much
+ *  memory it holds, so that MemoryReport can list what is still referenced.
+ *
+ *  \see Image, Ani, Sound, MemoryReport
  */
 
 /** \brief The Master Resource Map.
@@ -52,13 +56,15 @@ Resource::Resource() {
 
 /** \brief Store a Resource given a Key and pointer.
  *  \warning, attempting to store multiple resources using the same key will
- *  cause the previous object to be lost.
- *  \TODO Ensure that keys are not reused for different Resource objects.
- *  \TODO Fix potential memory leak.
+ *  keep the previous object.  The new object can not be found again, so a
+ *  warning is logged, since this is usually a leak.
  */
 void Resource::Store(string key,Resource *res) {
 	assert(key != ""); // No Empty Keys!
-	values.insert(make_pair(key,res));
+	pair<map<string,Resource*>::iterator,bool> stored = values.insert(make_pair(key,res));
+	if( !stored.second && stored.first->second != res ) {
+		LogMsg(WARN, "The Resource key '%s' is already used.  The new %s will not be found again.", key.c_str(), res->GetKind() );
+	}
 }
 
 /** \brief Retrieve a stored Resource
@@ -71,3 +77,12 @@ Resource* Resource::Get(string path) {
 	} 
 	return NULL;
 }
+
+/** \brief Every stored Resource, with all of the keys that refer to it.
+ *  \param resources [out] Each Resource is listed once.
+ */
+void Resource::GetAll( map<Resource*, list<string> > *resources ) {
+	for( map<string,Resource*>::iterator val = values.begin(); val != values.end(); ++val ) {
+		(*resources)[ val->second ].push_back( val->first );
+	}
+}
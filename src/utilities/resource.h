@@ -15,8 +15,15 @@
 class Resource{
 	public:
 		Resource();
+		virtual ~Resource() {}
 		static void Store(string key, Resource* res);
 		static Resource* Get(string path);
+
+		// Memory accounting
+		virtual const char* GetKind( void ) { return "Resources"; }
+		virtual Uint64 GetMemoryUsage( void ) { return 0; }
+		static int GetNumKeys( void ) { return values.size(); }
+		static void GetAll( map<Resource*, list<string> > *resources );
 	private:
 		static map<string,Resource*> values;
 };
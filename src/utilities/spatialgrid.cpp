@@ -0,0 +1,392 @@
+/**\file			spatialgrid.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Loose hashed uniform grid of Sprites
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "graphics/video.h"
+#include "utilities/log.h"
+#include "utilities/quadtree.h"
+#include "utilities/spatialgrid.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class SpatialGrid
+ * \brief SpatialIndex backend that files Sprites in a loose hashed uniform grid.
+ * \details
+ * The universe is cut into square cells of a fixed size.  Each Sprite is
+ * filed in the one cell that contains its center, and the cells are hashed
+ * into a power-of-two number of buckets so that only populated cells cost
+ * any memory.
+ *
+ * The grid is "loose": a Sprite can overlap its neighbouring cells, and it
+ * can drift out of its cell between two calls to Reindex.  Queries make up
+ * for both by widening their search by the largest Sprite radius and the
+ * fastest Sprite speed that were seen at the last Reindex.  Distances are
+ * always checked against the live Sprite positions.
+ *
+ * Rather than maintaining per cell lists, Reindex rebuilds the whole grid
+ * with a counting sort into flat arrays.  This is a single linear pass that
+ * reuses its buffers, so a steady state tick does not touch the heap.
+ * Sprites inserted between two Reindex calls are kept in a small pending
+ * list that every query scans.
+ *
+ * \see SpatialIndex
+ */
+
+/**\brief Constructs an empty grid.
+ * \param _cellSize The width of each cell.  When zero, the
+ *        "options/simulation/grid-cell-size" option is used.
+ */
+SpatialGrid::SpatialGrid( float _cellSize ) :
+	cellSize( _cellSize ),
+	numBuckets( GRID_MIN_BUCKETS ),
+	occupiedCells( 0 ),
+	maxRadius( 0.0f ),
+	slack( 0.0f )
+{
+	if( cellSize <= 0.0f ) {
+		cellSize = OPTION(float, "options/simulation/grid-cell-size");
+	}
+	if( cellSize < MIN_QUAD_SIZE ) {
+		LogMsg(WARN, "Grid cell size %f is too small. Using %f instead.", cellSize, MIN_QUAD_SIZE );
+		cellSize = MIN_QUAD_SIZE;
+	}
+	bucketStart.assign( numBuckets + 1, 0 );
+}
+
+/**\brief Destroys the grid.
+ * \note The Sprites themselves are owned by the SpriteManager.
+ */
+SpatialGrid::~SpatialGrid() {
+}
+
+/**\brief Add a Sprite to the grid.
+ * \details The Sprite is only filed into a cell at the next Reindex.
+ *          Until then it is found through the pending list.
+ */
+void SpatialGrid::Insert( Sprite *sprite ) {
+	if( IsMember( sprite ) ) {
+		LogMsg(WARN, "Sprite %d is already in the grid.", sprite->GetID() );
+		return;
+	}
+	sprite->gridMember = members.size();
+	members.push_back( sprite );
+	memberSlot.push_back( GRID_UNFILED );
+	pending.push_back( sprite );
+}
+
+/**\brief Remove a Sprite from the grid.
+ * \details This does not depend on the Sprite's position, so Sprites can be
+ *          removed even if they have moved since the last Reindex.
+ * \returns True if the Sprite was found.
+ */
+bool SpatialGrid::Remove( Sprite *sprite ) {
+	if( !IsMember( sprite ) ) {
+		return false;
+	}
+	unsigned int index = sprite->gridMember;
+	sprite->gridMember = GRID_UNFILED;
+
+	// Forget where this Sprite was filed
+	if( memberSlot[index] == GRID_UNFILED ) {
+		pending.erase( std::find( pending.begin(), pending.end(), sprite ) );
+	} else {
+		cellSprites[ memberSlot[index] ] = NULL;
+	}
+
+	// Swap the last member into the hole
+	unsigned int last = members.size() - 1;
+	if( index != last ) {
+		members[index] = members[last];
+		memberSlot[index] = memberSlot[last];
+		members[index]->gridMember = index;
+	}
+	members.pop_back();
+	memberSlot.pop_back();
+
+	return true;
+}
+
+/**\brief Refile every Sprite into the cell that now contains it.
+ * \details This is a counting sort of all of the Sprites by their bucket.
+ *          The buffers only grow, so this allocates nothing once the number
+ *          of Sprites has settled.
+ */
+void SpatialGrid::Reindex( JobSystem *jobs ) {
+	unsigned int count = members.size();
+	unsigned int i, b, slot;
+
+	// Keep the load factor at or under one half
+	numBuckets = GRID_MIN_BUCKETS;
+	while( numBuckets < count * 2 ) {
+		numBuckets *= 2;
+	}
+	bucketStart.assign( numBuckets + 1, 0 );
+
+	memberBucket.resize( count );
+	memberCellX.resize( count );
+	memberCellY.resize( count );
+	cellSprites.resize( count );
+	cellX.resize( count );
+	cellY.resize( count );
+
+	// Find each Sprite's cell and count the Sprites in each bucket
+	maxRadius = 0.0f;
+	slack = 0.0f;
+	for( i = 0; i < count; ++i ) {
+		Sprite *s = members[i];
+		Coordinate pos = s->GetWorldPosition();
+		int cx = CellOf( pos.GetX() );
+		int cy = CellOf( pos.GetY() );
+
+		b = Bucket( cx, cy );
+		memberBucket[i] = b;
+		memberCellX[i] = cx;
+		memberCellY[i] = cy;
+		bucketStart[b + 1]++;
+
+		if( s->GetRadarSize() > maxRadius ) maxRadius = static_cast<float>( s->GetRadarSize() );
+		float speed = s->GetMomentum().GetMagnitudeSquared();
+		if( speed > slack ) slack = speed;
+	}
+	// Sprites may accelerate before the next Reindex, so allow for twice their speed.
+	slack = 2.0f * sqrt( slack );
+
+	// Turn the counts into offsets
+	for( b = 0; b < numBuckets; ++b ) {
+		bucketStart[b + 1] += bucketStart[b];
+	}
+
+	// Place each Sprite into its bucket
+	bucketCursor.assign( bucketStart.begin(), bucketStart.end() - 1 );
+	for( i = 0; i < count; ++i ) {
+		slot = bucketCursor[ memberBucket[i] ]++;
+		memberSlot[i] = slot;
+		cellSprites[slot] = members[i];
+		cellX[slot] = memberCellX[i];
+		cellY[slot] = memberCellY[i];
+	}
+
+	// Count the distinct cells.  Buckets are short, so a quadratic scan is fine.
+	occupiedCells = 0;
+	for( b = 0; b < numBuckets; ++b ) {
+		for( slot = bucketStart[b]; slot < bucketStart[b + 1]; ++slot ) {
+			unsigned int other = bucketStart[b];
+			while( other < slot && ( cellX[other] != cellX[slot] || cellY[other] != cellY[slot] ) ) {
+				++other;
+			}
+			if( other == slot ) {
+				occupiedCells++;
+			}
+		}
+	}
+
+	pending.clear();
+}
+
+/**\brief Find the range of cells that a search may need to visit.
+ * \returns False if the range covers more cells than there are buckets, in
+ *          which case it is cheaper to check every Sprite.
+ */
+bool SpatialGrid::CellRange( Coordinate point, float distance, int *x0, int *y0, int *x1, int *y1 ) {
+	double reach = distance + maxRadius + slack;
+	double left   = floor( (point.GetX() - reach) / cellSize );
+	double right  = floor( (point.GetX() + reach) / cellSize );
+	double bottom = floor( (point.GetY() - reach) / cellSize );
+	double top    = floor( (point.GetY() + reach) / cellSize );
+
+	// Also protects the int conversions below from huge search radii
+	if( (right - left + 1) * (top - bottom + 1) > numBuckets ) {
+		return false;
+	}
+
+	*x0 = static_cast<int>( left );
+	*x1 = static_cast<int>( right );
+	*y0 = static_cast<int>( bottom );
+	*y1 = static_cast<int>( top );
+	return true;
+}
+
+/**\brief Collect the Sprites within a radius of a point.
+ * \details A Sprite is near if its radar circle could reach the search circle.
+ *          This matches QuadTree::GetSpritesNear.
+ * \arg point The center of the search radius.
+ * \arg distance The maximum search radius.
+ * \arg visitor Called for every Sprite found within the search radius.
+ * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
+ */
+void SpatialGrid::GetSpritesNear( Coordinate point, float distance, SpriteVisitor *visitor, int type ) {
+	const float distanceSquared = distance * distance;
+	int x0, y0, x1, y1, cx, cy;
+	unsigned int slot, end;
+	Sprite *s;
+
+	if( CellRange( point, distance, &x0, &y0, &x1, &y1 ) ) {
+		for( cx = x0; cx <= x1; ++cx ) {
+			for( cy = y0; cy <= y1; ++cy ) {
+				unsigned int b = Bucket( cx, cy );
+				for( slot = bucketStart[b], end = bucketStart[b + 1]; slot < end; ++slot ) {
+					s = cellSprites[slot];
+					if( s == NULL || cellX[slot] != cx || cellY[slot] != cy ) continue;
+					if( (s->GetDrawOrder() & type) == 0 ) continue;
+					if( (point - s->GetWorldPosition()).GetMagnitudeSquared() < distanceSquared + s->GetRadarSize()*s->GetRadarSize() ) {
+						visitor->Visit( s );
+					}
+				}
+			}
+		}
+	} else {
+		for( slot = 0, end = cellSprites.size(); slot < end; ++slot ) {
+			s = cellSprites[slot];
+			if( s == NULL || (s->GetDrawOrder() & type) == 0 ) continue;
+			if( (point - s->GetWorldPosition()).GetMagnitudeSquared() < distanceSquared + s->GetRadarSize()*s->GetRadarSize() ) {
+				visitor->Visit( s );
+			}
+		}
+	}
+
+	// Sprites that have not been filed yet
+	vector<Sprite*>::iterator i;
+	for( i = pending.begin(); i != pending.end(); ++i ) {
+		s = *i;
+		if( (s->GetDrawOrder() & type) == 0 ) continue;
+		if( (point - s->GetWorldPosition()).GetMagnitudeSquared() < distanceSquared + s->GetRadarSize()*s->GetRadarSize() ) {
+			visitor->Visit( s );
+		}
+	}
+}
+
+/**\brief Find the Sprite that is closest to another Sprite.
+ * \arg obj The Sprite at the center of the search radius.  It is ignored while searching.
+ * \arg distance A Max radius to use while searching.
+ * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
+ * \arg filter If given, only Sprites that it accepts are considered.
+ * \returns The nearest Sprite of the correct type, or NULL.
+ */
+Sprite* SpatialGrid::GetNearestSprite( Sprite *obj, float distance, int type, SpriteFilter *filter ) {
+	Coordinate point = obj->GetWorldPosition();
+	float mindist = distance * distance;
+	float tmpdist;
+	Sprite *closest = NULL;
+	int x0, y0, x1, y1, cx, cy;
+	unsigned int slot, end;
+	Sprite *s;
+
+	if( CellRange( point, distance, &x0, &y0, &x1, &y1 ) ) {
+		for( cx = x0; cx <= x1; ++cx ) {
+			for( cy = y0; cy <= y1; ++cy ) {
+				unsigned int b = Bucket( cx, cy );
+				for( slot = bucketStart[b], end = bucketStart[b + 1]; slot < end; ++slot ) {
+					s = cellSprites[slot];
+					if( s == NULL || s == obj || cellX[slot] != cx || cellY[slot] != cy ) continue;
+					if( (s->GetDrawOrder() & type) == 0 ) continue;
+					tmpdist = (point - s->GetWorldPosition()).GetMagnitudeSquared();
+					if( tmpdist < mindist && ( filter == NULL || filter->Accept( s ) ) ) {
+						mindist = tmpdist;
+						closest = s;
+					}
+				}
+			}
+		}
+	} else {
+		for( slot = 0, end = cellSprites.size(); slot < end; ++slot ) {
+			s = cellSprites[slot];
+			if( s == NULL || s == obj || (s->GetDrawOrder() & type) == 0 ) continue;
+			tmpdist = (point - s->GetWorldPosition()).GetMagnitudeSquared();
+			if( tmpdist < mindist && ( filter == NULL || filter->Accept( s ) ) ) {
+				mindist = tmpdist;
+				closest = s;
+			}
+		}
+	}
+
+	// Sprites that have not been filed yet
+	vector<Sprite*>::iterator i;
+	for( i = pending.begin(); i != pending.end(); ++i ) {
+		s = *i;
+		if( s == obj || (s->GetDrawOrder() & type) == 0 ) continue;
+		tmpdist = (point - s->GetWorldPosition()).GetMagnitudeSquared();
+		if( tmpdist < mindist && ( filter == NULL || filter->Accept( s ) ) ) {
+			mindist = tmpdist;
+			closest = s;
+		}
+	}
+
+	return closest;
+}
+
+/**\brief Draw the cells within a Quadrant of the focus.
+ * \details This is drawn at the same scale as the QuadTree map.
+ *          (Useful for debugging.)
+ */
+void SpatialGrid::Draw( Coordinate focus ) {
+	float scale = (Video::GetHalfHeight() > Video::GetHalfWidth() ?
+		static_cast<float>(Video::GetHalfWidth()) : static_cast<float>(Video::GetHalfHeight()) -5);
+	float cellWidth = scale * cellSize / QUADRANTSIZE;
+	unsigned int slot;
+
+	for( slot = 0; slot < cellSprites.size(); ++slot ) {
+		Sprite *s = cellSprites[slot];
+		if( s == NULL ) continue;
+
+		// The cell outline
+		float x = scale * static_cast<float>( cellX[slot] * cellSize - focus.GetX() ) / QUADRANTSIZE + static_cast<float>(Video::GetHalfWidth());
+		float y = scale * static_cast<float>( cellY[slot] * cellSize - focus.GetY() ) / QUADRANTSIZE + static_cast<float>(Video::GetHalfHeight());
+		if( x + cellWidth < 0 || y + cellWidth < 0 || x > Video::GetWidth() || y > Video::GetHeight() ) continue;
+		Video::DrawRect( static_cast<int>(x), static_cast<int>(y),
+			static_cast<int>(cellWidth), static_cast<int>(cellWidth), 0,255.f,0.f, .1f);
+
+		// The Sprite
+		Coordinate pos = s->GetWorldPosition() - focus;
+		int posx = static_cast<int>((scale* (float)pos.GetX() / QUADRANTSIZE) + (float)Video::GetHalfWidth());
+		int posy = static_cast<int>((scale* (float)pos.GetY() / QUADRANTSIZE) + (float)Video::GetHalfHeight());
+		Color col = s->GetRadarColor();
+		Video::DrawCircle( posx, posy, static_cast<int>(17.f*s->GetRadarSize()/scale),2, col.r,col.g,col.b );
+	}
+}
+
+/**\brief Add an XML Node for every filed Sprite to root.
+ * \details (Useful for debugging.)
+ */
+void SpatialGrid::Save( xmlNodePtr root ) {
+	xmlNodePtr gridNode, objNode;
+	char buff[256];
+	unsigned int slot;
+
+	gridNode = xmlNewNode(NULL, BAD_CAST "SpatialGrid" );
+	snprintf(buff, sizeof(buff), "%d", (int) cellSize );
+	xmlSetProp( gridNode, BAD_CAST "cellsize", BAD_CAST buff );
+	snprintf(buff, sizeof(buff), "%d", numBuckets );
+	xmlSetProp( gridNode, BAD_CAST "buckets", BAD_CAST buff );
+
+	for( slot = 0; slot < cellSprites.size(); ++slot ) {
+		Sprite *s = cellSprites[slot];
+		if( s == NULL ) continue;
+
+		objNode = xmlNewNode(NULL, BAD_CAST "Sprite");
+		snprintf(buff, sizeof(buff), "%d", s->GetID() );
+		xmlSetProp( objNode, BAD_CAST "id", BAD_CAST buff );
+		snprintf(buff, sizeof(buff), "%d", s->GetDrawOrder() );
+		xmlSetProp( objNode, BAD_CAST "type", BAD_CAST buff );
+		snprintf(buff, sizeof(buff), "%d", cellX[slot] );
+		xmlSetProp( objNode, BAD_CAST "cellx", BAD_CAST buff );
+		snprintf(buff, sizeof(buff), "%d", cellY[slot] );
+		xmlSetProp( objNode, BAD_CAST "celly", BAD_CAST buff );
+		snprintf(buff, sizeof(buff), "%d", (int) s->GetWorldPosition().GetX() );
+		xmlSetProp( objNode, BAD_CAST "x", BAD_CAST buff );
+		snprintf(buff, sizeof(buff), "%d", (int) s->GetWorldPosition().GetY() );
+		xmlSetProp( objNode, BAD_CAST "y", BAD_CAST buff );
+		xmlAddChild( gridNode, objNode );
+	}
+
+	xmlAddChild( root, gridNode );
+}
+
+/** @} */
@@ -0,0 +1,76 @@
+/**\file			spatialgrid.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Loose hashed uniform grid of Sprites
+ * \details
+ */
+
+#ifndef __H_SPATIALGRID__
+#define __H_SPATIALGRID__
+
+#include "includes.h"
+#include "utilities/spatialindex.h"
+
+#define GRID_MIN_BUCKETS 64
+#define GRID_UNFILED 0xFFFFFFFFu
+
+class SpatialGrid : public SpatialIndex {
+	public:
+		SpatialGrid( float cellSize = 0.0f );
+		~SpatialGrid();
+
+		string GetName( void ) { return SPATIAL_INDEX_GRID; }
+
+		void Insert( Sprite *sprite );
+		bool Remove( Sprite *sprite );
+		void Reindex( JobSystem *jobs = NULL );
+
+		void GetSpritesNear( Coordinate point, float distance, SpriteVisitor *visitor, int type = DRAW_ORDER_ALL );
+		Sprite* GetNearestSprite( Sprite *obj, float distance, int type = DRAW_ORDER_ALL, SpriteFilter *filter = NULL );
+
+		unsigned int Count( void ) { return members.size(); }
+		int GetNumRegions( void ) { return occupiedCells; }
+
+		void Draw( Coordinate focus );
+		void Save( xmlNodePtr root );
+
+		float GetCellSize( void ) { return cellSize; }
+
+	private:
+		// Each Sprite remembers its index in members, so nothing is looked up in a tree.
+		inline bool IsMember( Sprite *sprite ) const {
+			return sprite->gridMember < members.size() && members[ sprite->gridMember ] == sprite;
+		}
+		inline int CellOf( double v ) const {
+			return static_cast<int>( floor( v / cellSize ) );
+		}
+		inline unsigned int Bucket( int cx, int cy ) const {
+			return ( static_cast<unsigned int>(cx) * 73856093u ^ static_cast<unsigned int>(cy) * 19349663u ) & (numBuckets - 1);
+		}
+
+		bool CellRange( Coordinate point, float distance, int *x0, int *y0, int *x1, int *y1 );
+
+		float cellSize;                    ///< The width of every cell.
+
+		// Every Sprite in the grid.
+		vector<Sprite*> members;           ///< All Sprites, in no particular order.
+		vector<unsigned int> memberSlot;   ///< Where each member is filed in cellSprites (or GRID_UNFILED).
+
+		// The flat cell arrays, rebuilt by Reindex.
+		unsigned int numBuckets;           ///< Number of hash buckets (always a power of two).
+		vector<unsigned int> bucketStart;  ///< Bucket b occupies [bucketStart[b], bucketStart[b+1]) of the cell arrays.
+		vector<Sprite*> cellSprites;       ///< Sprites sorted by bucket.  Removed Sprites leave a NULL.
+		vector<int> cellX, cellY;          ///< The cell that each Sprite was filed in.
+		vector<unsigned int> memberBucket; ///< Scratch space used while rebuilding.
+		vector<int> memberCellX, memberCellY; ///< Scratch space used while rebuilding.
+		vector<unsigned int> bucketCursor; ///< Scratch space used while rebuilding.
+		int occupiedCells;                 ///< Number of distinct cells that hold a Sprite.
+
+		vector<Sprite*> pending;           ///< Sprites inserted since the last Reindex.
+
+		float maxRadius;                   ///< The largest Sprite radar size at the last Reindex.
+		float slack;                       ///< How far Sprites may have drifted from their cell since the last Reindex.
+};
+
+#endif // __H_SPATIALGRID__
@@ -0,0 +1,48 @@
+/**\file			spatialindex.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Interface for the SpriteManager's spatial lookup structures
+ * \details
+ */
+
+#include "includes.h"
+#include "utilities/log.h"
+#include "utilities/quadtree.h"
+#include "utilities/spatialgrid.h"
+#include "utilities/spatialindex.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class SpatialIndex
+ * \brief Locates Sprites by their position in the Universe.
+ * \details
+ * The SpriteManager files every Sprite in exactly one SpatialIndex and uses
+ * it to answer all location based queries.  Different backends trade update
+ * cost against query cost, so the backend is chosen by the
+ * "options/simulation/spatial-index" option:
+ * - "quadtree" (default) is a grid of QuadTree quadrants.  \see QuadTreeIndex
+ * - "grid" is a loose hashed uniform grid.  \see SpatialGrid
+ *
+ * Sprites are not notified when they move, so Reindex must be called once
+ * per tick after the Sprites have been updated.  Queries between two calls
+ * to Reindex still compare against the live Sprite positions.
+ */
+
+/**\brief Build the spatial index backend named by backend.
+ * \details Unknown names fall back to the QuadTree backend.
+ */
+SpatialIndex* SpatialIndex::Create( const string& backend ) {
+	if( backend == SPATIAL_INDEX_GRID ) {
+		return new SpatialGrid();
+	}
+
+	if( backend != SPATIAL_INDEX_QUADTREE ) {
+		LogMsg(WARN, "Unknown spatial index '%s'. Using '%s' instead.", backend.c_str(), SPATIAL_INDEX_QUADTREE );
+	}
+	return new QuadTreeIndex();
+}
+
+/** @} */
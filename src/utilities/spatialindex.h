@@ -0,0 +1,63 @@
+/**\file			spatialindex.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Interface for the SpriteManager's spatial lookup structures
+ * \details
+ */
+
+#ifndef __H_SPATIALINDEX__
+#define __H_SPATIALINDEX__
+
+#include "includes.h"
+#include "sprites/sprite.h"
+
+#define SPATIAL_INDEX_QUADTREE "quadtree"
+#define SPATIAL_INDEX_GRID     "grid"
+
+class JobSystem;
+
+// Receives each Sprite found by a spatial query.
+class SpriteVisitor {
+	public:
+		virtual ~SpriteVisitor() {}
+		virtual void Visit( Sprite *sprite ) = 0;
+};
+
+// Decides which Sprites a spatial query may return.
+class SpriteFilter {
+	public:
+		virtual ~SpriteFilter() {}
+		virtual bool Accept( Sprite *sprite ) = 0;
+};
+
+class SpatialIndex {
+	public:
+		virtual ~SpatialIndex() {}
+
+		static SpatialIndex* Create( const string& backend );
+
+		virtual string GetName( void ) = 0;
+
+		virtual void Insert( Sprite *sprite ) = 0;
+		virtual bool Remove( Sprite *sprite ) = 0;
+		virtual void Reindex( JobSystem *jobs = NULL ) = 0;
+
+		virtual void GetSpritesNear( Coordinate point, float distance, SpriteVisitor *visitor, int type = DRAW_ORDER_ALL ) = 0;
+		virtual Sprite* GetNearestSprite( Sprite *obj, float distance, int type = DRAW_ORDER_ALL, SpriteFilter *filter = NULL ) = 0;
+
+		virtual unsigned int Count( void ) = 0;
+		virtual int GetNumRegions( void ) = 0;
+
+		virtual void Draw( Coordinate focus ) = 0;
+		virtual void Save( xmlNodePtr root ) = 0;
+
+		// Node bookkeeping for backends that are made of nodes.
+		virtual Uint32 GetNodesAcquired( void ) { return 0; }
+		virtual Uint32 GetNodeAllocations( void ) { return 0; }
+		virtual void ResetNodeCounters( void ) {}
+		virtual Uint32 GetNumNodes( void ) { return 0; }
+		virtual Uint64 GetNodeBytes( void ) { return 0; }
+};
+
+#endif // __H_SPATIALINDEX__
@@ -0,0 +1,62 @@
+/**\file			tickstats.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Summarizes how long each tick took
+ * \details
+ */
+
+#include "includes.h"
+#include "utilities/tickstats.h"
+
+/**\class TickStats
+ * \brief Collects the time taken by each tick and reports its distribution.
+ * \details
+ * A mean hides the occasional slow tick that players notice as a stutter, so
+ * the median, the 99th percentile and the worst tick are reported as well.
+ */
+
+/**\brief The time taken by every tick together.
+ */
+double TickStats::GetTotal( void ) {
+	double total = 0.0;
+	for( unsigned int s = 0; s < samples.size(); s++ ) {
+		total += samples[s];
+	}
+	return total;
+}
+
+/**\brief The average tick time.
+ */
+double TickStats::GetMean( void ) {
+	if( samples.empty() ) {
+		return 0.0;
+	}
+	return GetTotal() / samples.size();
+}
+
+/**\brief The tick time that percent of the ticks were no slower than.
+ * \param percent Between 0 and 100.  50 is the median.
+ */
+double TickStats::GetPercentile( double percent ) {
+	if( samples.empty() ) {
+		return 0.0;
+	}
+	if( !sorted ) {
+		sort( samples.begin(), samples.end() );
+		sorted = true;
+	}
+
+	// Nearest rank
+	int rank = static_cast<int>( ceil( percent / 100.0 * samples.size() ) ) - 1;
+	rank = max( 0, min( rank, static_cast<int>( samples.size() ) - 1 ) );
+	return samples[rank];
+}
+
+/**\brief Print a one line summary to the standard output.
+ */
+void TickStats::Print( const string& label ) {
+	printf( "%s: %d ticks in %.1f ms; mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+		label.c_str(), GetCount(), GetTotal(), GetMean(),
+		GetPercentile( 50.0 ), GetPercentile( 99.0 ), GetMax() );
+}
@@ -0,0 +1,34 @@
+/**\file			tickstats.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Summarizes how long each tick took
+ * \details
+ */
+
+#ifndef __H_TICKSTATS__
+#define __H_TICKSTATS__
+
+#include "includes.h"
+
+class TickStats {
+	public:
+		TickStats() : sorted(true) {}
+
+		void Clear( void ) { samples.clear(); sorted = true; }
+		void Add( double ms ) { samples.push_back( ms ); sorted = false; }
+
+		int GetCount( void ) { return samples.size(); }
+		double GetTotal( void );
+		double GetMean( void );
+		double GetPercentile( double percent );
+		double GetMax( void ) { return GetPercentile( 100.0 ); }
+
+		void Print( const string& label );
+
+	private:
+		vector<double> samples; ///< Milliseconds taken by each tick.
+		bool sorted;            ///< Whether samples is in ascending order.
+};
+
+#endif // __H_TICKSTATS__
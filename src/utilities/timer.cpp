@@ -57,6 +57,21 @@ int Timer::Update( void ) {
 	return logical_loops;
 }
 
+// Advances the Timer by exactly one logical loop, regardless of the real time.
+// This lets the simulation run faster (or slower) than real time while every
+// timestamp still moves forward by the same amount each tick.
+void Timer::Step( void ) {
+	Uint32 before = static_cast<Uint32>( frames * 1000.0 / LOGIC_FPS );
+	frames += 1.0;
+	Uint32 after = static_cast<Uint32>( frames * 1000.0 / LOGIC_FPS );
+
+	lastLoopLength = after - before;
+	lastLoopTick += lastLoopLength;
+	fframe = 0.0;
+	lastLogicalLoops = 1;
+	logicalFrameCount++;
+}
+
 // Returns the fraction of a frame at this point in the draw cycle.
 // Used to interpolate graphic screen coordinates.
 double Timer::GetFFrame( void ) {
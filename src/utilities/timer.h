@@ -18,6 +18,7 @@ class Timer {
 	public:
 		static void Initialize( void );
 		static int Update( void );
+		static void Step( void );
 		static void Delay( void );
 		static Uint32 GetTicks( void );
 		static Uint32 GetRealTicks( void );
@@ -17,6 +17,8 @@
  * \brief XML handling.
  */
 
+set<XMLFile*> XMLFile::openFiles;
+
 XMLFile::XMLFile() {
 	xmlPtr = NULL;
 }
@@ -31,6 +33,7 @@ bool XMLFile::New( const string& rootName ) {
 	//LogMsg(INFO, "New XML File: %s", filename.c_str());
 
 	xmlPtr = xmlNewDoc( BAD_CAST "1.0" );
+	openFiles.insert( this );
 
 	xmlNodePtr root_node = xmlNewNode(NULL, BAD_CAST rootName.c_str() );
 	xmlDocSetRootElement(xmlPtr, root_node);
@@ -61,8 +64,14 @@ bool XMLFile::Open( const string& filename ) {
 		return( false );
 	}
 
+	// Reopening must not leak the previous document.
+	Close();
+
 	xmlPtr = xmlParseMemory( buf, bufSize );
 	delete [] buf;
+	if( xmlPtr ) {
+		openFiles.insert( this );
+	}
 
 	this->filename.assign( filename );
 
@@ -106,6 +115,7 @@ bool XMLFile::Save( const string& filename ) {
 bool XMLFile::Close() {
 	if( xmlPtr ) xmlFreeDoc( xmlPtr );
 	xmlPtr = NULL;
+	openFiles.erase( this );
 
 	Forget();
 
@@ -187,6 +197,7 @@ bool XMLFile::Copy( XMLFile *other ) {
 	if( copyXmlPtr ) {
 		if( xmlPtr ) xmlFreeDoc( xmlPtr );
 		xmlPtr = copyXmlPtr;
+		openFiles.insert( this );
 		LogMsg(INFO,"Copy XMLFile from %s to %s complete.", other->filename.c_str(), this->filename.c_str());
 		return true;
 	}
@@ -37,12 +37,16 @@ class XMLFile {
 
 		bool Copy( XMLFile *other );
 
+		static const set<XMLFile*>& GetOpenFiles( void ) { return openFiles; }
+
 	protected:
 		string filename;
 
 	private:
 		xmlDocPtr xmlPtr;
 		map<string,xmlNodePtr> values;
+
+		static set<XMLFile*> openFiles; ///< Every XMLFile that holds a document.
 		
 		void Forget();
 		xmlNodePtr FindNode( const string& path, bool createIfMissing = false );